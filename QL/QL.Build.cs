@@ -20,6 +20,7 @@ public class QL : ModuleRules
             "GameplayDebugger",
             "NavigationSystem",
             "AIModule",
+            "Json",
         });
 
         PrivateDependencyModuleNames.AddRange(new string[] {  });
@@ -12,6 +12,7 @@
 #include "QLAIController.h"
 #include "Classes/BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BrainComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyAllTypes.h"
 #include "QLCharacter.h"
 #include "Classes/Perception/AIPerceptionComponent.h"
@@ -29,6 +30,10 @@
 #include "Classes/Perception/AISense_Team.h"
 #include "QLUtility.h"
 #include "QLAIPerceptionComponent.h"
+#include "QLSpatialQueryManager.h"
+#include "QLGameModeBase.h"
+#include "QLVisibilityManager.h"
+#include "Engine/World.h"
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -70,6 +75,12 @@ AQLAIController::AQLAIController()
     StartingWeaponList.push_back("NailGun");
 
     bRandomStartingWeapon = false;
+
+    CanAttackTargetKeyID = FBlackboard::InvalidKey;
+    TargetKeyID = FBlackboard::InvalidKey;
+
+    AILODTier = EQLAILODTier::Combat;
+    LastCombatTime = -1.0f;
 }
 
 //------------------------------------------------------------
@@ -77,6 +88,25 @@ AQLAIController::AQLAIController()
 void AQLAIController::BeginPlay()
 {
     Super::BeginPlay();
+
+    UQLAILODManager* AILODManager = AQLGameModeBase::GetWorldService<UQLAILODManager>(this);
+    if (AILODManager)
+    {
+        AILODManager->RegisterController(this);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UQLAILODManager* AILODManager = AQLGameModeBase::GetWorldService<UQLAILODManager>(this);
+    if (AILODManager)
+    {
+        AILODManager->UnregisterController(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 //------------------------------------------------------------
@@ -100,10 +130,26 @@ void AQLAIController::OnPossess(APawn* InPawn)
 {
     Super::OnPossess(InPawn);
 
+    // the sight stimuli are reported by the shared visibility matrix
+    UQLVisibilityManager* VisibilityManager = AQLGameModeBase::GetWorldService<UQLVisibilityManager>(this);
+    if (VisibilityManager && PerceptionComponent)
+    {
+        PerceptionComponent->SetSenseEnabled(UAISense_Sight::StaticClass(), false);
+    }
+
     if (BehaviorTreeBasic)
     {
         RunBehaviorTree(BehaviorTreeBasic);
     }
+
+    if (Blackboard)
+    {
+        CanAttackTargetKeyID = Blackboard->GetKeyID(FName(TEXT("CanAttackTarget")));
+        TargetKeyID = Blackboard->GetKeyID(FName(TEXT("Target")));
+    }
+
+    // a kit controller may have been set to its tier before the brain existed
+    ApplyAILODSettings();
 }
 
 
@@ -118,7 +164,16 @@ void AQLAIController::UpdateControlRotation(float DeltaTime, bool bUpdatePawn)
 
         // Look toward focus
         const FVector FocalPoint = GetFocalPoint();
-        if (FAISystem::IsValidLocation(FocalPoint))
+        const FVector Velocity = MyPawn->GetVelocity();
+        if (!UQLAILODManager::GetTierSettings(AILODTier).bFocalPointAiming)
+        {
+            // no enemy around to aim at, just face the way the bot moves
+            if (!Velocity.IsNearlyZero())
+            {
+                NewControlRotation = FRotator(0.0f, Velocity.Rotation().Yaw, 0.0f);
+            }
+        }
+        else if (FAISystem::IsValidLocation(FocalPoint))
         {
             NewControlRotation = (FocalPoint - MyPawn->GetPawnViewLocation()).Rotation();
         }
@@ -160,6 +215,10 @@ void AQLAIController::OnPerceptionUpdatedImpl(const TArray<AActor*>& UpdatedActo
         return;
     }
 
+    // enemies sensed in this update
+    TArray<AQLCharacter*> SensedEnemyList;
+    bool bCharacterUpdated = false;
+
     // for each target actor that has been sensed
     for (auto&& Target : UpdatedActors)
     {
@@ -169,6 +228,8 @@ void AQLAIController::OnPerceptionUpdatedImpl(const TArray<AActor*>& UpdatedActo
             continue;
         }
 
+        bCharacterUpdated = true;
+
         bool bEnemySensed = false;
 
         FActorPerceptionBlueprintInfo Info;
@@ -211,13 +272,37 @@ void AQLAIController::OnPerceptionUpdatedImpl(const TArray<AActor*>& UpdatedActo
 
         if (bEnemySensed)
         {
-            QLTarget = TargetCharacter;
-            BroadcastTarget(QLTarget.Get());
+            SensedEnemyList.Add(TargetCharacter);
         }
-        else
+    }
+
+    // target the nearest sensed enemy
+    if (SensedEnemyList.Num() > 0)
+    {
+        AQLCharacter* NewTarget = SensedEnemyList.Last();
+
+        UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(this);
+        if (SpatialQueryManager && SensedEnemyList.Num() > 1)
         {
-            QLTarget.Reset();
+            TArray<AQLCharacter*> NearestList;
+            SpatialQueryManager->FindNearestCharacters(Bot->GetActorLocation(),
+                1, // max count
+                0.0f, // no max radius
+                NearestList,
+                [&SensedEnemyList](AQLCharacter* Character) { return SensedEnemyList.Contains(Character); });
+
+            if (NearestList.Num() > 0)
+            {
+                NewTarget = NearestList[0];
+            }
         }
+
+        QLTarget = NewTarget;
+        BroadcastTarget(QLTarget.Get());
+    }
+    else if (bCharacterUpdated)
+    {
+        QLTarget.Reset();
     }
 
     // update blackboard variable
@@ -227,11 +312,11 @@ void AQLAIController::OnPerceptionUpdatedImpl(const TArray<AActor*>& UpdatedActo
         // i.e. do not evaluate the second operand if the result is known after evaluating the first
         // thus it is safe to deference Target in the second operand
         bool bResult = QLTarget.IsValid() && QLTarget->QLGetVisibility() && QLTarget->IsAlive();
-        Blackboard->SetValueAsBool(FName(TEXT("CanAttackTarget")), bResult);
+        Blackboard->SetValue<UBlackboardKeyType_Bool>(CanAttackTargetKeyID, bResult);
 
         if (QLTarget.IsValid())
         {
-            Blackboard->SetValueAsObject(FName(TEXT("Target")), QLTarget.Get());
+            Blackboard->SetValue<UBlackboardKeyType_Object>(TargetKeyID, QLTarget.Get());
         }
     }
 }
@@ -295,15 +380,101 @@ FName AQLAIController::GetStartingWeaponName()
 {
     if (bRandomStartingWeapon)
     {
-        StartingWeaponName = StartingWeaponList[FMath::RandRange(0, StartingWeaponList.size() - 1)];
+        StartingWeaponName = StartingWeaponList[QLUtility::RandRange(0, static_cast<int32>(StartingWeaponList.size()) - 1)];
     }
 
     return StartingWeaponName;
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+const UAISenseConfig_Sight* AQLAIController::GetSightConfig() const
+{
+    return AISenseConfig_Sight;
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLAIController::ResetTarget()
 {
     QLTarget.Reset();
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIController::SetAILODTier(EQLAILODTier NewTier)
+{
+    if (NewTier == AILODTier)
+    {
+        return;
+    }
+
+    AILODTier = NewTier;
+    ApplyAILODSettings();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIController::ApplyAILODSettings()
+{
+    const FQLAILODSettings& Settings = UQLAILODManager::GetTierSettings(AILODTier);
+
+    if (BrainComponent)
+    {
+        BrainComponent->SetComponentTickInterval(Settings.BrainTickInterval);
+    }
+
+    if (PerceptionComponent)
+    {
+        PerceptionComponent->SetSenseEnabled(UAISense_Hearing::StaticClass(), Settings.bEnableSecondarySenses);
+        PerceptionComponent->SetSenseEnabled(UAISense_Prediction::StaticClass(), Settings.bEnableSecondarySenses);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+EQLAILODTier AQLAIController::GetAILODTier() const
+{
+    return AILODTier;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIController::NotifyTookDamage()
+{
+    UWorld* World = GetWorld();
+    if (World)
+    {
+        LastCombatTime = World->GetTimeSeconds();
+    }
+
+    SetAILODTier(EQLAILODTier::Combat);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float AQLAIController::GetLastCombatTime() const
+{
+    return LastCombatTime;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float AQLAIController::GetSightRadius(bool bWasVisible) const
+{
+    if (!AISenseConfig_Sight)
+    {
+        return 0.0f;
+    }
+
+    // same rules as the engine sight sense
+    const float Radius = bWasVisible ? AISenseConfig_Sight->LoseSightRadius : AISenseConfig_Sight->SightRadius;
+    return Radius * UQLAILODManager::GetTierSettings(AILODTier).SightRadiusScale;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float AQLAIController::GetSightCheckInterval() const
+{
+    return UQLAILODManager::GetTierSettings(AILODTier).SightCheckInterval;
+}
@@ -12,6 +12,8 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "QLAILODManager.h"
 #include <vector>
 #include "QLAIController.generated.h"
 
@@ -39,6 +41,10 @@ public:
     //------------------------------------------------------------
     virtual void BeginPlay() override;
 
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     //------------------------------------------------------------
     //------------------------------------------------------------
     virtual void OnPossess(APawn* InPawn) override;
@@ -73,11 +79,42 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     FName GetStartingWeaponName();
 
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    const UAISenseConfig_Sight* GetSightConfig() const;
+
+    //------------------------------------------------------------
+    // Apply the brain tick interval and the secondary senses of the tier
+    //------------------------------------------------------------
+    void SetAILODTier(EQLAILODTier NewTier);
+
+    EQLAILODTier GetAILODTier() const;
+
+    //------------------------------------------------------------
+    // Move the bot to the combat tier at once
+    //------------------------------------------------------------
+    void NotifyTookDamage();
+
+    float GetLastCombatTime() const;
+
+    //------------------------------------------------------------
+    // Sight or lose sight radius scaled by the tier
+    //------------------------------------------------------------
+    float GetSightRadius(bool bWasVisible) const;
+
+    float GetSightCheckInterval() const;
+
 protected:
     //------------------------------------------------------------
     //------------------------------------------------------------
     virtual void PostInitializeComponents() override;
 
+    //------------------------------------------------------------
+    // Apply the settings of the current tier, SetAILODTier() only
+    // does it when the tier changes
+    //------------------------------------------------------------
+    void ApplyAILODSettings();
+
     //------------------------------------------------------------
     //DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPerceptionUpdatedDelegate, const TArray<AActor*>&, UpdatedActors);
     //DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FActorPerceptionUpdatedDelegate, AActor*, Actor, FAIStimulus, Stimulus);
@@ -124,4 +161,14 @@ protected:
     FName StartingWeaponName;
 
     std::vector<FName> StartingWeaponList;
+
+    // resolved once the behavior tree runs
+    FBlackboard::FKey CanAttackTargetKeyID;
+
+    FBlackboard::FKey TargetKeyID;
+
+    EQLAILODTier AILODTier;
+
+    // game time of the last damage taken, negative if none
+    float LastCombatTime;
 };
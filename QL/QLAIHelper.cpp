@@ -11,11 +11,28 @@
 
 #include "QLAIHelper.h"
 #include "QLCharacter.h"
+#include "QLWeaponManager.h"
+#include "QLAbilityManager.h"
+#include "QLWeapon.h"
+#include "QLAbility.h"
 #include "Components/SphereComponent.h"
 #include "Components/BoxComponent.h"
 #include "QLUtility.h"
+#include "QLGameModeBase.h"
+#include "QLSpawnPointManager.h"
+#include "QLAssetPreloadManager.h"
 #include "NavigationSystem.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameFramework/Controller.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarQLBotSpawnBudget(
+    TEXT("ql.BotSpawnBudget"),
+    4.0f,
+    TEXT("Time spent on creating and spawning the bots per frame (millisecond). At least one bot step is run per frame.\n")
+    TEXT("0: spawn every bot in the first frame."),
+    ECVF_Default);
 
 //------------------------------------------------------------
 // Sets default values
@@ -28,6 +45,10 @@ AQLAIHelper::AQLAIHelper()
     NumBotsToSpawn = 3;
 
     CharacterClass = AQLCharacter::StaticClass();
+
+    NumBotsSpawned = 0;
+    bIsSpawningBots = false;
+    SpawnStartTime = 0.0;
 }
 
 //------------------------------------------------------------
@@ -45,6 +66,22 @@ void AQLAIHelper::BeginPlay()
 void AQLAIHelper::PostInitializeComponents()
 {
     Super::PostInitializeComponents();
+
+    // the bots are spawned and equipped from BeginPlay on
+    UQLAssetPreloadManager* AssetPreloadManager = AQLGameModeBase::GetWorldService<UQLAssetPreloadManager>(this);
+    if (AssetPreloadManager)
+    {
+        AssetPreloadManager->PreloadCharacterEquipment(CharacterClass);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIHelper::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    DestroyBotKits();
+
+    Super::EndPlay(EndPlayReason);
 }
 
 //------------------------------------------------------------
@@ -54,36 +91,259 @@ void AQLAIHelper::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+    if (!bIsSpawningBots)
+    {
+        return;
+    }
+
+    // a class still loading would be loaded synchronously by the kit
+    UQLAssetPreloadManager* AssetPreloadManager = AQLGameModeBase::GetWorldService<UQLAssetPreloadManager>(this);
+    if (AssetPreloadManager && AssetPreloadManager->IsPreloading())
+    {
+        return;
+    }
+
+    const double Budget = CVarQLBotSpawnBudget.GetValueOnGameThread() / 1000.0;
+    const double StartTime = FPlatformTime::Seconds();
+
+    do
+    {
+        if (BotKitList.Num() < NumBotsToSpawn)
+        {
+            CreateBotKit();
+        }
+        else if (NumBotsSpawned < NumBotsToSpawn && SpawnBot())
+        {
+            ++NumBotsSpawned;
+        }
+        else
+        {
+            FinishSpawningBots();
+        }
+    } while (bIsSpawningBots && (Budget <= 0.0 || FPlatformTime::Seconds() - StartTime < Budget));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIHelper::SetNumBotsToSpawn(int32 Num)
+{
+    NumBotsToSpawn = Num;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIHelper::SetCharacterClass(TSubclassOf<AQLCharacter> InCharacterClass)
+{
+    CharacterClass = InCharacterClass;
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLAIHelper::SpawnBots()
 {
-    for (int32 Idx = 0; Idx < NumBotsToSpawn; ++Idx)
+    if (bIsSpawningBots)
     {
-        UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+        return;
+    }
 
-        if (NavSys)
-        {
-            FNavLocation RandomLocation;
-            bool bFound = NavSys->GetRandomPoint(RandomLocation);
-            if (!bFound)
-            {
-                return;
-            }
-            RandomLocation.Location.Z += 100.0f;
+    DestroyBotKits();
 
-            FRotator RandomYawRotation = FRotator(0.0f, FMath::RandRange(0.0f, 360.0f), 0.0f);
-            FTransform RandomTransform(RandomYawRotation, RandomLocation.Location, FVector(1.0f));
+    NumBotsSpawned = 0;
+    bIsSpawningBots = true;
+    SpawnStartTime = FPlatformTime::Seconds();
+
+    if (NumBotsToSpawn <= 0 || !CharacterClass)
+    {
+        FinishSpawningBots();
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLAIHelper::IsSpawningBots() const
+{
+    return bIsSpawningBots;
+}
 
-            // deferred spawn in order to timely specify human/bot identity
-            AQLCharacter* Bot = GetWorld()->SpawnActorDeferred<AQLCharacter>(CharacterClass, RandomTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
-            Bot->SetIsBot(true);
-            UGameplayStatics::FinishSpawningActor(Bot, RandomTransform);
+//------------------------------------------------------------
+//------------------------------------------------------------
+float AQLAIHelper::GetSpawnProgress() const
+{
+    if (!bIsSpawningBots || NumBotsToSpawn <= 0)
+    {
+        return 1.0f;
+    }
 
-            Bot->EquipAll();
+    return 0.5f * (BotKitList.Num() + NumBotsSpawned) / NumBotsToSpawn;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FQLBotsSpawnedDelegate& AQLAIHelper::OnBotsSpawned()
+{
+    return BotsSpawnedDelegate;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLAIHelper::FindSpawnTransform(FTransform& OutTransform)
+{
+    UQLSpawnPointManager* SpawnPointManager = AQLGameModeBase::GetWorldService<UQLSpawnPointManager>(this);
+    if (SpawnPointManager && SpawnPointManager->GetSpawnTransform(OutTransform))
+    {
+        return true;
+    }
+
+    UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+    if (!NavSys)
+    {
+        return false;
+    }
+
+    FNavLocation RandomLocation;
+    bool bFound = NavSys->GetRandomPoint(RandomLocation);
+    if (!bFound)
+    {
+        return false;
+    }
+    RandomLocation.Location.Z += 100.0f;
+
+    FRotator RandomYawRotation = FRotator(0.0f, QLUtility::RandRange(0.0f, 360.0f), 0.0f);
+    OutTransform = FTransform(RandomYawRotation, RandomLocation.Location, FVector(1.0f));
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIHelper::CreateBotKit()
+{
+    FQLBotKit& Kit = BotKitList.AddDefaulted_GetRef();
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    const AQLCharacter* DefaultCharacter = GetDefault<AQLCharacter>(CharacterClass);
+
+    if (DefaultCharacter->AIControllerClass)
+    {
+        Kit.Controller = World->SpawnActor<AController>(DefaultCharacter->AIControllerClass, FVector::ZeroVector, FRotator::ZeroRotator);
+    }
+
+    TArray<AQLWeapon*> NewWeaponList;
+    UQLWeaponManager::CreateAllWeapons(World, DefaultCharacter->GetWeaponClassList(), NewWeaponList);
+    Kit.WeaponList.Append(NewWeaponList);
+
+    TArray<AQLAbility*> NewAbilityList;
+    UQLAbilityManager::CreateAllAbilities(World, DefaultCharacter->GetAbilityClassList(), NewAbilityList);
+    Kit.AbilityList.Append(NewAbilityList);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLAIHelper::SpawnBot()
+{
+    FTransform SpawnTransform;
+    if (!FindSpawnTransform(SpawnTransform))
+    {
+        return false;
+    }
+
+    // deferred spawn in order to timely specify human/bot identity
+    AQLCharacter* Bot = GetWorld()->SpawnActorDeferred<AQLCharacter>(CharacterClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+    if (!Bot)
+    {
+        return false;
+    }
+
+    FQLBotKit& Kit = BotKitList[NumBotsSpawned];
+    AController* Controller = Kit.Controller.Get();
+
+    Bot->SetIsBot(true);
+    if (Controller)
+    {
+        // possessed by the controller of the kit instead of a new one
+        Bot->AutoPossessAI = EAutoPossessAI::Disabled;
+    }
+    UGameplayStatics::FinishSpawningActor(Bot, SpawnTransform);
+
+    if (Controller)
+    {
+        Controller->Possess(Bot);
+    }
+
+    TArray<AQLWeapon*> NewWeaponList;
+    for (const auto& Item : Kit.WeaponList)
+    {
+        if (Item.IsValid())
+        {
+            NewWeaponList.Add(Item.Get());
         }
     }
+
+    TArray<AQLAbility*> NewAbilityList;
+    for (const auto& Item : Kit.AbilityList)
+    {
+        if (Item.IsValid())
+        {
+            NewAbilityList.Add(Item.Get());
+        }
+    }
+
+    Bot->EquipAllPrecreated(NewWeaponList, NewAbilityList);
+
+    // the bot owns its kit from now on
+    Kit = FQLBotKit();
+
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIHelper::FinishSpawningBots()
+{
+    bIsSpawningBots = false;
+
+    // no room left for the remaining bots
+    DestroyBotKits();
+
+    QLUtility::Log(FString::Printf(TEXT("ai helper: %d of %d bots spawned in %.3f s"),
+        NumBotsSpawned,
+        NumBotsToSpawn,
+        FPlatformTime::Seconds() - SpawnStartTime));
+
+    BotsSpawnedDelegate.Broadcast();
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAIHelper::DestroyBotKits()
+{
+    for (FQLBotKit& Kit : BotKitList)
+    {
+        if (Kit.Controller.IsValid())
+        {
+            Kit.Controller->Destroy();
+        }
+
+        for (auto& Item : Kit.WeaponList)
+        {
+            if (Item.IsValid())
+            {
+                Item->Destroy();
+            }
+        }
+
+        for (auto& Item : Kit.AbilityList)
+        {
+            if (Item.IsValid())
+            {
+                Item->Destroy();
+            }
+        }
+    }
+
+    BotKitList.Empty();
+}
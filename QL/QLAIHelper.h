@@ -15,8 +15,31 @@
 #include "QLAIHelper.generated.h"
 
 class AQLCharacter;
+class AQLWeapon;
+class AQLAbility;
+
+DECLARE_MULTICAST_DELEGATE(FQLBotsSpawnedDelegate);
+
+//------------------------------------------------------------
+// Controller, weapons and abilities created for a bot before
+// the bot itself is spawned
+//------------------------------------------------------------
+struct FQLBotKit
+{
+    TWeakObjectPtr<AController> Controller;
+
+    TArray<TWeakObjectPtr<AQLWeapon>> WeaponList;
+
+    TArray<TWeakObjectPtr<AQLAbility>> AbilityList;
+};
 
 //------------------------------------------------------------
+// Spawn NumBotsToSpawn bots over several frames, spending at most
+// ql.BotSpawnBudget milliseconds per frame. Once the equipment
+// classes are loaded, the controller, weapons and abilities of
+// every bot are created first, then the bots are spawned and
+// handed their kit. OnBotsSpawned() is broadcast when every bot
+// is in, e.g. to hold the match until then.
 //------------------------------------------------------------
 UCLASS()
 class QL_API AQLAIHelper : public AActor
@@ -26,16 +49,54 @@ class QL_API AQLAIHelper : public AActor
 public:
 	// Sets default values for this actor's properties
 	AQLAIHelper();
+
+    //------------------------------------------------------------
+    // Start spawning the bots, from the next frames on
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    void SpawnBots();
+
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    bool IsSpawningBots() const;
+
+    //------------------------------------------------------------
+    // From 0 to 1, the kits and the bots counting for half each
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    float GetSpawnProgress() const;
+
+    FQLBotsSpawnedDelegate& OnBotsSpawned();
+
+    //------------------------------------------------------------
+    // Set before BeginPlay, which starts spawning the bots
+    //------------------------------------------------------------
+    void SetNumBotsToSpawn(int32 Num);
+
+    void SetCharacterClass(TSubclassOf<AQLCharacter> InCharacterClass);
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
     virtual void PostInitializeComponents() override;
 
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     //------------------------------------------------------------
+    // From the spawn point manager, or a random navigable point
     //------------------------------------------------------------
-    UFUNCTION(BlueprintCallable, Category = "C++Function")
-    void SpawnBots();
+    bool FindSpawnTransform(FTransform& OutTransform);
+
+    void CreateBotKit();
+
+    bool SpawnBot();
+
+    void FinishSpawningBots();
+
+    //------------------------------------------------------------
+    // Destroy the kits not handed to any bot
+    //------------------------------------------------------------
+    void DestroyBotKits();
 
 public:
 	// Called every frame
@@ -47,4 +108,15 @@ protected:
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     TSubclassOf<AQLCharacter> CharacterClass;
+
+    // kit i goes to bot i
+    TArray<FQLBotKit> BotKitList;
+
+    int32 NumBotsSpawned;
+
+    bool bIsSpawningBots;
+
+    double SpawnStartTime;
+
+    FQLBotsSpawnedDelegate BotsSpawnedDelegate;
 };
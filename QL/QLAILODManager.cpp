@@ -0,0 +1,237 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLAILODManager.h"
+#include "QLAIController.h"
+#include "QLCharacter.h"
+#include "QLGameModeBase.h"
+#include "QLSpatialQueryManager.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLAILODEnabled(
+    TEXT("ql.AILODEnabled"),
+    1,
+    TEXT("0: every bot stays at the combat tier.\n")
+    TEXT("1: the bots are tiered by the distance to their nearest enemy."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarQLAILODUpdateInterval(
+    TEXT("ql.AILODUpdateInterval"),
+    0.5f,
+    TEXT("Time between two scorings of the same bot (second)."),
+    ECVF_Default);
+
+namespace
+{
+    const float CombatTierMaxDistance = 1500.0f;
+    const float NearTierMaxDistance = 4000.0f;
+    const float FarTierMaxDistance = 8000.0f;
+
+    // a bot stays at the combat tier for this long after taking damage
+    const float CombatMemoryTime = 5.0f;
+
+    // indexed by EQLAILODTier
+    const FQLAILODSettings AILODSettingsList[] = {
+        { 0.0f, 0.0f, 1.0f, true, true },
+        { 0.1f, 0.2f, 1.0f, true, true },
+        { 0.25f, 0.5f, 0.75f, true, false },
+        { 0.5f, 1.0f, 0.5f, false, false },
+    };
+}
+
+//------------------------------------------------------------
+// Print the number of bots per tier of the world
+//------------------------------------------------------------
+static void LogAILODStats(UWorld* World)
+{
+    UQLAILODManager* AILODManager = AQLGameModeBase::GetWorldService<UQLAILODManager>(World);
+    if (AILODManager)
+    {
+        AILODManager->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLAILODStatsCommand(
+    TEXT("ql.AILODStats"),
+    TEXT("Print the number of bots at each AI level of detail."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogAILODStats));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLAILODManager::UQLAILODManager() :
+Cursor(0)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAILODManager::Deinitialize()
+{
+    ControllerList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+const FQLAILODSettings& UQLAILODManager::GetTierSettings(EQLAILODTier Tier)
+{
+    return AILODSettingsList[static_cast<int32>(Tier)];
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+const TCHAR* UQLAILODManager::GetTierName(EQLAILODTier Tier)
+{
+    switch (Tier)
+    {
+    case EQLAILODTier::Combat:
+        return TEXT("Combat");
+    case EQLAILODTier::Near:
+        return TEXT("Near");
+    case EQLAILODTier::Far:
+        return TEXT("Far");
+    default:
+        return TEXT("Dormant");
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAILODManager::RegisterController(AQLAIController* Controller)
+{
+    if (Controller)
+    {
+        ControllerList.AddUnique(Controller);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAILODManager::UnregisterController(AQLAIController* Controller)
+{
+    ControllerList.RemoveSwap(Controller);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAILODManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UWorld* World = GetWorld();
+    if (!World || ControllerList.Num() == 0)
+    {
+        return;
+    }
+
+    const bool bIsEnabled = CVarQLAILODEnabled.GetValueOnGameThread() != 0;
+    const float UpdateInterval = FMath::Max(CVarQLAILODUpdateInterval.GetValueOnGameThread(), 0.01f);
+    const float CurrentTime = World->GetTimeSeconds();
+    const UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(this);
+
+    // spread the bots over the update interval
+    const int32 Count = FMath::Clamp(FMath::CeilToInt(ControllerList.Num() * DeltaTime / UpdateInterval), 1, ControllerList.Num());
+
+    for (int32 Step = 0; Step < Count && ControllerList.Num() > 0; ++Step)
+    {
+        Cursor = Cursor % ControllerList.Num();
+
+        AQLAIController* Controller = ControllerList[Cursor].Get();
+        if (!Controller || Controller->IsPendingKill())
+        {
+            ControllerList.RemoveAtSwap(Cursor);
+            continue;
+        }
+
+        ++Cursor;
+
+        const EQLAILODTier Tier = bIsEnabled ? PickTier(Controller, CurrentTime, SpatialQueryManager) : EQLAILODTier::Combat;
+        Controller->SetAILODTier(Tier);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+EQLAILODTier UQLAILODManager::PickTier(AQLAIController* Controller, float CurrentTime, const UQLSpatialQueryManager* SpatialQueryManager) const
+{
+    // the last combat time is negative until the bot first takes damage
+    const float LastCombatTime = Controller->GetLastCombatTime();
+    if (Controller->GetTarget() || (LastCombatTime >= 0.0f && CurrentTime - LastCombatTime < CombatMemoryTime))
+    {
+        return EQLAILODTier::Combat;
+    }
+
+    APawn* Bot = Controller->GetPawn();
+    if (!Bot)
+    {
+        return EQLAILODTier::Dormant;
+    }
+
+    // no way to find the enemies cheaply, stay at full rate
+    if (!SpatialQueryManager)
+    {
+        return EQLAILODTier::Combat;
+    }
+
+    TArray<AQLCharacter*> NearestList;
+    SpatialQueryManager->FindNearestCharacters(Bot->GetActorLocation(),
+        1, // max count
+        FarTierMaxDistance,
+        NearestList,
+        [Controller](AQLCharacter* Character)
+        {
+            return Character->IsAlive() && Controller->GetTeamAttitudeTowards(*Character) == ETeamAttitude::Hostile;
+        });
+
+    if (NearestList.Num() == 0)
+    {
+        return EQLAILODTier::Dormant;
+    }
+
+    const float Distance = FVector::Dist(NearestList[0]->GetActorLocation(), Bot->GetActorLocation());
+
+    if (Distance <= CombatTierMaxDistance)
+    {
+        return EQLAILODTier::Combat;
+    }
+
+    if (Distance <= NearTierMaxDistance)
+    {
+        return EQLAILODTier::Near;
+    }
+
+    return EQLAILODTier::Far;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAILODManager::LogStats() const
+{
+    int32 CountList[4] = { 0, 0, 0, 0 };
+
+    for (const auto& Item : ControllerList)
+    {
+        if (Item.IsValid())
+        {
+            ++CountList[static_cast<int32>(Item->GetAILODTier())];
+        }
+    }
+
+    QLUtility::Log(FString::Printf(TEXT("ai lod: %d bots, %s %d, %s %d, %s %d, %s %d"),
+        ControllerList.Num(),
+        GetTierName(EQLAILODTier::Combat), CountList[0],
+        GetTierName(EQLAILODTier::Near), CountList[1],
+        GetTierName(EQLAILODTier::Far), CountList[2],
+        GetTierName(EQLAILODTier::Dormant), CountList[3]));
+}
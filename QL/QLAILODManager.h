@@ -0,0 +1,95 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLAILODManager.generated.h"
+
+class AQLAIController;
+class UQLSpatialQueryManager;
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+enum class EQLAILODTier : uint8
+{
+    // has a target, took damage recently, or an enemy is close
+    Combat,
+    Near,
+    Far,
+    // no enemy within reach
+    Dormant,
+};
+
+//------------------------------------------------------------
+// What the AI of a bot costs at a given tier
+//------------------------------------------------------------
+struct FQLAILODSettings
+{
+    // second, 0 to tick every frame
+    float BrainTickInterval;
+
+    // second between two sight checks of the bot by UQLVisibilityManager
+    float SightCheckInterval;
+
+    // applied to the sight and lose sight radii
+    float SightRadiusScale;
+
+    // false to turn the bot toward its velocity instead of its focal point
+    bool bFocalPointAiming;
+
+    // hearing and prediction, the sight and damage senses are always on
+    bool bEnableSecondarySenses;
+};
+
+//------------------------------------------------------------
+// Pick an AI level of detail for each bot from the distance to its
+// nearest enemy and from recent combat, a few bots per frame so that
+// each bot is rescored every ql.AILODUpdateInterval seconds.
+// The tier sets the behavior tree tick interval, the sight check
+// interval and radius, the secondary senses and the focal point
+// aiming of the bot, see AQLAIController::SetAILODTier().
+// A bot taking damage moves to the combat tier at once.
+//
+// AQLAIController registers itself in BeginPlay() and unregisters
+// in EndPlay(). ql.AILODEnabled 0 keeps every bot at the combat tier.
+// ql.AILODStats prints the number of bots per tier.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLAILODManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLAILODManager();
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    void RegisterController(AQLAIController* Controller);
+
+    void UnregisterController(AQLAIController* Controller);
+
+    static const FQLAILODSettings& GetTierSettings(EQLAILODTier Tier);
+
+    static const TCHAR* GetTierName(EQLAILODTier Tier);
+
+    void LogStats() const;
+
+protected:
+    EQLAILODTier PickTier(AQLAIController* Controller, float CurrentTime, const UQLSpatialQueryManager* SpatialQueryManager) const;
+
+    TArray<TWeakObjectPtr<AQLAIController>> ControllerList;
+
+    // next bot to rescore
+    int32 Cursor;
+};
@@ -42,4 +42,20 @@ void UQLAIPerceptionComponent::HandleExpiredStimulus(FAIStimulus& StimulusStore)
             QLAIController->ResetTarget();
         }
     }
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAIPerceptionComponent::ReportSight(AActor* Target, bool bIsVisible, const FVector& TargetLocation, const FVector& ReceiverLocation)
+{
+    if (!Target)
+    {
+        return;
+    }
+
+    RegisterStimulus(Target, FAIStimulus(*GetDefault<UAISense_Sight>(),
+        bIsVisible ? 1.0f : 0.0f, // strength
+        TargetLocation,
+        ReceiverLocation,
+        bIsVisible ? FAIStimulus::SensingSucceeded : FAIStimulus::SensingFailed));
+}
@@ -26,4 +26,10 @@ public:
     UQLAIPerceptionComponent(const FObjectInitializer & ObjectInitializer);
 
     virtual void HandleExpiredStimulus(FAIStimulus& StimulusStore) override;
+
+    //------------------------------------------------------------
+    // Register a sight stimulus checked by UQLVisibilityManager,
+    // in place of the engine sight sense
+    //------------------------------------------------------------
+    void ReportSight(AActor* Target, bool bIsVisible, const FVector& TargetLocation, const FVector& ReceiverLocation);
 };
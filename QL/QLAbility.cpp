@@ -18,7 +18,7 @@
 #include "QLUtility.h"
 #include "TimerManager.h"
 #include "QLCharacter.h"
-#include "QLUmgFirstPerson.h"
+#include "QLHUDViewModel.h"
 
 //------------------------------------------------------------
 // Sets default values
@@ -150,10 +150,10 @@ void AQLAbility::UpdateProgressOnUMGInternal(const float Value)
         auto* PlayerController = Character->GetQLPlayerController();
         if (PlayerController)
         {
-            auto* UMG = PlayerController->GetUMG();
-            if (UMG)
+            auto* HUDViewModel = PlayerController->GetHUDViewModel();
+            if (HUDViewModel)
             {
-                UMG->UpdateAbilityCooldownProgress(Value);
+                HUDViewModel->SetAbilityCooldownProgress(Value);
             }
         }
     }
@@ -203,4 +203,24 @@ bool AQLAbility::IsActive()
 //------------------------------------------------------------
 void AQLAbility::OnAbilityEnd()
 {
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAbility::CancelAbility()
+{
+    OnAbilityEnd();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAbility::ResetAbility()
+{
+    if (GetWorldTimerManager().IsTimerActive(AbilityDurationTimerHandle))
+    {
+        GetWorldTimerManager().ClearTimer(AbilityDurationTimerHandle);
+        CancelAbility();
+    }
+
+    Reactivate();
+}
@@ -40,6 +40,12 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     virtual void OnAbilityEnd();
 
+    //------------------------------------------------------------
+    // End the ability in use without its end effects, e.g. when the
+    // user is recycled. Default to OnAbilityEnd().
+    //------------------------------------------------------------
+    virtual void CancelAbility();
+
     //------------------------------------------------------------
     //------------------------------------------------------------
     virtual void UpdateProgressOnUMGInternal(const float Value);
@@ -64,6 +70,12 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     bool IsActive();
 
+    //------------------------------------------------------------
+    // End the ability if it is in use, and make it usable again
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    void ResetAbility();
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -20,6 +20,8 @@
 #include "QLAbilityManager.h"
 #include "QLCharacter.h"
 #include "QLPlayerController.h"
+#include "QLSpatialQueryManager.h"
+#include "QLGameModeBase.h"
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -57,7 +59,7 @@ void AQLAbilityGhostWalk::OnUse()
     }
 
     PostProcessComponent->bEnabled = true;
-    PlaySoundFireAndForget(FName(TEXT("Voiceline")));
+    PlaySoundFireAndForget(FName(TEXT("Voiceline")), EQLSoundCategory::Voice);
     PlaySoundFireAndForget(FName(TEXT("Swoosh")));
 
     Deactivate();
@@ -109,7 +111,29 @@ void AQLAbilityGhostWalk::OnAbilityEnd()
 
             // telefrag overlapping characters
             TArray<AActor*> Results;
-            QLCharacter->GetOverlappingActors(Results, QLCharacter->GetClass());
+            UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(this);
+            if (SpatialQueryManager && CapsuleComponent)
+            {
+                float Radius = 0.0f;
+                float HalfHeight = 0.0f;
+                CapsuleComponent->GetScaledCapsuleSize(Radius, HalfHeight);
+
+                TArray<AQLCharacter*> CharacterList;
+                SpatialQueryManager->FindCharactersOverlappingCapsule(QLCharacter->GetActorLocation(), Radius, HalfHeight, CharacterList);
+                for (AQLCharacter* Character : CharacterList)
+                {
+                    // same filter as GetOverlappingActors() below
+                    if (Character != QLCharacter && Character->IsA(QLCharacter->GetClass()))
+                    {
+                        Results.Add(Character);
+                    }
+                }
+            }
+            else
+            {
+                QLCharacter->GetOverlappingActors(Results, QLCharacter->GetClass());
+            }
+
             for (const auto& Item : Results)
             {
                 // create a damage event
@@ -141,3 +165,33 @@ void AQLAbilityGhostWalk::OnAbilityEnd()
         }
     }
 }
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLAbilityGhostWalk::CancelAbility()
+{
+    PostProcessComponent->bEnabled = false;
+
+    if (!AbilityManager.IsValid())
+    {
+        return;
+    }
+
+    auto* QLCharacter = AbilityManager->GetUser();
+    if (!QLCharacter)
+    {
+        return;
+    }
+
+    // same collision as at the end of OnAbilityEnd()
+    auto* CapsuleComponent = QLCharacter->GetCapsuleComponent();
+    if (CapsuleComponent)
+    {
+        CapsuleComponent->SetGenerateOverlapEvents(true);
+        CapsuleComponent->SetCollisionProfileName(FName(TEXT("Pawn")));
+        CapsuleComponent->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Block);
+    }
+
+    QLCharacter->SetWeaponEnabled(true);
+    QLCharacter->QLSetVisibility(true);
+}
@@ -29,6 +29,12 @@ public:
     virtual void OnUse() override;
 
     virtual void OnAbilityEnd() override;
+
+    //------------------------------------------------------------
+    // Restore the user without the swoosh and the telefrag
+    //------------------------------------------------------------
+    virtual void CancelAbility() override;
+
 protected:
     //------------------------------------------------------------
     // Called when the game starts or when spawned
@@ -107,6 +107,14 @@ void UQLAbilityManager::AddAbility(AQLAbility* Ability)
     Ability->SetAbilityManager(this);
 
     // set up the Ability
+    StowAbility(Ability);
+    Ability->SetDamageMultiplier(DamageMultiplier);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAbilityManager::StowAbility(AQLAbility* Ability)
+{
     auto* RootSphereComponent = Ability->GetRootSphereComponent();
     if (RootSphereComponent)
     {
@@ -122,7 +130,6 @@ void UQLAbilityManager::AddAbility(AQLAbility* Ability)
     Ability->SetActorEnableCollision(false);
     Ability->DisableComponentsSimulatePhysics();
     Ability->SetConstantRotationEnabled(false);
-    Ability->SetDamageMultiplier(DamageMultiplier);
 }
 
 //------------------------------------------------------------
@@ -139,19 +146,100 @@ void UQLAbilityManager::SetDamageMultiplier(const float Value)
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void UQLAbilityManager::CreateAndAddAllAbilities(const TArray<TSubclassOf<AQLAbility>>& AbilityClassList)
+void UQLAbilityManager::CreateAndAddAllAbilities(const TArray<TSoftClassPtr<AQLAbility>>& AbilityClassList)
 {
     if (!User.IsValid())
     {
         return;
     }
 
+    TArray<AQLAbility*> NewAbilityList;
+    CreateAllAbilities(GetWorld(), AbilityClassList, NewAbilityList);
+    AddAllAbilities(NewAbilityList);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAbilityManager::CreateAllAbilities(UWorld* World, const TArray<TSoftClassPtr<AQLAbility>>& AbilityClassList, TArray<AQLAbility*>& OutAbilityList)
+{
+    if (!World)
+    {
+        return;
+    }
+
     for (const auto& Item : AbilityClassList)
     {
-        auto* Ability = GetWorld()->SpawnActor<AQLAbility>(Item, FVector::ZeroVector, FRotator::ZeroRotator);
+        // returns at once if the class has been preloaded, see UQLAssetPreloadManager
+        UClass* AbilityClass = Item.LoadSynchronous();
+        if (!AbilityClass)
+        {
+            continue;
+        }
+
+        // no overlap with whoever stands at the origin, even while spawning
+        auto* Ability = World->SpawnActorDeferred<AQLAbility>(AbilityClass, FTransform::Identity);
+        if (!Ability)
+        {
+            continue;
+        }
+
+        Ability->SetActorEnableCollision(false);
+        UGameplayStatics::FinishSpawningActor(Ability, FTransform::Identity);
+
+        // the ability may wait for its user over several frames, see AQLAIHelper
+        StowAbility(Ability);
+        OutAbilityList.Add(Ability);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAbilityManager::AddAllAbilities(const TArray<AQLAbility*>& NewAbilityList)
+{
+    if (!User.IsValid())
+    {
+        return;
+    }
+
+    for (AQLAbility* Ability : NewAbilityList)
+    {
+        if (!Ability)
+        {
+            continue;
+        }
+
         AddAbility(Ability);
         User->SetCurrentAbility(Ability->GetQLName());
         Ability->UpdateProgressOnUMGInternal(1.0f);
     }
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAbilityManager::DestroyAllAbilities()
+{
+    for (auto& Item : AbilityList)
+    {
+        if (Item)
+        {
+            Item->ResetAbility();
+            Item->Destroy();
+        }
+    }
+
+    AbilityList.Empty();
+    CurrentAbility.Reset();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAbilityManager::ResetAllAbilities()
+{
+    for (auto& Item : AbilityList)
+    {
+        if (Item)
+        {
+            Item->ResetAbility();
+        }
+    }
+}
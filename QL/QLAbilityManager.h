@@ -39,7 +39,31 @@ public:
 
     void SetDamageMultiplier(const float Value);
 
-    void CreateAndAddAllAbilities(const TArray<TSubclassOf<AQLAbility>>& AbilityClassList);
+    //------------------------------------------------------------
+    // End the abilities in use and reset their cooldown, e.g. upon respawn
+    //------------------------------------------------------------
+    void ResetAllAbilities();
+
+    //------------------------------------------------------------
+    // Cancel the abilities in use and destroy every ability actor
+    //------------------------------------------------------------
+    void DestroyAllAbilities();
+
+    void CreateAndAddAllAbilities(const TArray<TSoftClassPtr<AQLAbility>>& AbilityClassList);
+
+    //------------------------------------------------------------
+    // Spawn the abilities without a user, e.g. ahead of the bots that
+    // will hold them, see AQLAIHelper. Hand them over with AddAllAbilities().
+    //------------------------------------------------------------
+    static void CreateAllAbilities(UWorld* World, const TArray<TSoftClassPtr<AQLAbility>>& AbilityClassList, TArray<AQLAbility*>& OutAbilityList);
+
+    void AddAllAbilities(const TArray<AQLAbility*>& NewAbilityList);
+
+    //------------------------------------------------------------
+    // Hide the ability, and turn off its collision and rotation as a pickup
+    //------------------------------------------------------------
+    static void StowAbility(AQLAbility* Ability);
+
 protected:
     TWeakObjectPtr<AQLCharacter> User;
 
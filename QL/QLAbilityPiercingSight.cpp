@@ -16,6 +16,8 @@
 #include "Kismet/KismetMaterialLibrary.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "QLAbilityManager.h"
+#include "QLGameModeBase.h"
+#include "QLSignificanceManager.h"
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -89,7 +91,15 @@ void AQLAbilityPiercingSight::OnUse()
 
     Counter = 0;
     PostProcessComponent->bEnabled = true;
-    PlaySoundFireAndForget(FName(TEXT("Voiceline")));
+
+    // the x-ray effect reads the custom depth of every character
+    UQLSignificanceManager* SignificanceManager = AQLGameModeBase::GetWorldService<UQLSignificanceManager>(this);
+    if (SignificanceManager)
+    {
+        SignificanceManager->SetCustomDepthForced(true);
+    }
+
+    PlaySoundFireAndForget(FName(TEXT("Voiceline")), EQLSoundCategory::Voice);
     PlaySoundFireAndForget(FName(TEXT("Scan")));
 
     if (ScanEffectTimeline && ScanEffectCurve)
@@ -121,6 +131,12 @@ void AQLAbilityPiercingSight::OnScanEffectEnd()
     if (Counter >= ScanTimes)
     {
         PostProcessComponent->bEnabled = false;
+
+        UQLSignificanceManager* SignificanceManager = AQLGameModeBase::GetWorldService<UQLSignificanceManager>(this);
+        if (SignificanceManager)
+        {
+            SignificanceManager->SetCustomDepthForced(false);
+        }
     }
     else
     {
@@ -85,8 +85,8 @@ void AQLAbilityTheWorld::OnUse()
     }
 
     PostProcessComponent->bEnabled = true;
-    PlaySoundFireAndForget(FName(TEXT("ZaWarudo")));
-    PlaySoundFireAndForget(FName(TEXT("VoicelineTheWorld")));
+    PlaySoundFireAndForget(FName(TEXT("ZaWarudo")), EQLSoundCategory::Voice);
+    PlaySoundFireAndForget(FName(TEXT("VoicelineTheWorld")), EQLSoundCategory::Voice);
 
 
     // change global time dilation
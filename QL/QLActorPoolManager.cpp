@@ -0,0 +1,274 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLActorPoolManager.h"
+#include "QLPoolableActor.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+
+//------------------------------------------------------------
+// Print the statistics of the actor pools of the world
+//------------------------------------------------------------
+static void LogActorPoolStats(UWorld* World)
+{
+    UQLActorPoolManager* ActorPoolManager = AQLGameModeBase::GetWorldService<UQLActorPoolManager>(World);
+    if (ActorPoolManager)
+    {
+        ActorPoolManager->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLActorPoolStatsCommand(
+    TEXT("ql.ActorPoolStats"),
+    TEXT("Print the number of pooled actors in use, free, spawned and reused for each class."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogActorPoolStats));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLActorPoolManager::UQLActorPoolManager()
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLActorPoolManager::Deinitialize()
+{
+    // the pooled actors belong to the level and are destroyed with it
+    PoolMap.Empty();
+    PooledActorMap.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+AActor* UQLActorPoolManager::AcquireActorDeferredInternal(const UObject* WorldContextObject, UClass* Class, const FTransform& Transform)
+{
+    if (!WorldContextObject || !Class || !GEngine)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    UQLActorPoolManager* ActorPoolManager = AQLGameModeBase::GetWorldService<UQLActorPoolManager>(World);
+    if (ActorPoolManager && IsPoolable(Class))
+    {
+        return ActorPoolManager->AcquireActorDeferredFromPool(Class, Transform);
+    }
+
+    return World->SpawnActorDeferred<AActor>(Class, Transform);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLActorPoolManager::FinishAcquiringActor(AActor* Actor, const FTransform& Transform)
+{
+    if (!Actor)
+    {
+        return;
+    }
+
+    // freshly spawned actor
+    if (!Actor->IsActorInitialized())
+    {
+        UGameplayStatics::FinishSpawningActor(Actor, Transform);
+        return;
+    }
+
+    // recycled actor
+    IQLPoolableActor* PoolableActor = Cast<IQLPoolableActor>(Actor);
+    if (PoolableActor)
+    {
+        PoolableActor->OnAcquiredFromPool();
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+AActor* UQLActorPoolManager::AcquireActorDeferredFromPool(UClass* Class, const FTransform& Transform)
+{
+    FQLActorPool& Pool = PoolMap.FindOrAdd(Class);
+
+    AActor* Actor = nullptr;
+
+    // the level may have destroyed some free actors, e.g. when they fell out of the world
+    while (!Actor && Pool.FreeList.Num() > 0)
+    {
+        TWeakObjectPtr<AActor> Candidate = Pool.FreeList.Pop(false);
+        if (Candidate.IsValid() && !Candidate->IsPendingKill())
+        {
+            Actor = Candidate.Get();
+        }
+    }
+
+    if (Actor)
+    {
+        Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+        ++Pool.Stats.ReuseCount;
+    }
+    else
+    {
+        Actor = SpawnPooledActorDeferred(Class, Transform);
+        if (!Actor)
+        {
+            return nullptr;
+        }
+        ++Pool.Stats.SpawnCount;
+    }
+
+    PooledActorMap.Add(Actor, true);
+
+    Pool.Stats.FreeCount = Pool.FreeList.Num();
+    ++Pool.Stats.InUseCount;
+    Pool.Stats.HighWaterMark = FMath::Max(Pool.Stats.HighWaterMark, Pool.Stats.InUseCount);
+
+    return Actor;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+AActor* UQLActorPoolManager::SpawnPooledActorDeferred(UClass* Class, const FTransform& Transform)
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    return World->SpawnActorDeferred<AActor>(Class,
+        Transform,
+        nullptr, // owner
+        nullptr, // instigator
+        ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLActorPoolManager::ReleaseActor(AActor* Actor)
+{
+    if (!Actor)
+    {
+        return false;
+    }
+
+    bool* bInUse = PooledActorMap.Find(Actor);
+    if (!bInUse)
+    {
+        return false;
+    }
+
+    // already released
+    if (!*bInUse)
+    {
+        return true;
+    }
+
+    *bInUse = false;
+
+    IQLPoolableActor* PoolableActor = Cast<IQLPoolableActor>(Actor);
+    if (PoolableActor)
+    {
+        PoolableActor->OnReleasedToPool();
+    }
+
+    FQLActorPool& Pool = PoolMap.FindOrAdd(Actor->GetClass());
+    Pool.FreeList.Add(Actor);
+    Pool.Stats.FreeCount = Pool.FreeList.Num();
+    Pool.Stats.InUseCount = FMath::Max(Pool.Stats.InUseCount - 1, 0);
+
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLActorPoolManager::WarmUp(UClass* Class, int32 Count)
+{
+    if (!Class || !IsPoolable(Class))
+    {
+        return;
+    }
+
+    FQLActorPool& Pool = PoolMap.FindOrAdd(Class);
+
+    // spawn far from the playing field, the actors are hidden right away anyway
+    const FTransform Transform(FRotator::ZeroRotator, FVector(0.0f, 0.0f, -1e5f));
+
+    while (Pool.FreeList.Num() < Count)
+    {
+        AActor* Actor = SpawnPooledActorDeferred(Class, Transform);
+        if (!Actor)
+        {
+            return;
+        }
+
+        UGameplayStatics::FinishSpawningActor(Actor, Transform);
+        ++Pool.Stats.SpawnCount;
+
+        PooledActorMap.Add(Actor, false);
+
+        IQLPoolableActor* PoolableActor = Cast<IQLPoolableActor>(Actor);
+        if (PoolableActor)
+        {
+            PoolableActor->OnReleasedToPool();
+        }
+
+        Pool.FreeList.Add(Actor);
+    }
+
+    Pool.Stats.FreeCount = Pool.FreeList.Num();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+const FQLActorPoolStats* UQLActorPoolManager::GetStats(UClass* Class) const
+{
+    const FQLActorPool* Pool = PoolMap.Find(Class);
+    if (!Pool)
+    {
+        return nullptr;
+    }
+
+    return &Pool->Stats;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLActorPoolManager::LogStats() const
+{
+    for (const auto& Item : PoolMap)
+    {
+        const FQLActorPoolStats& Stats = Item.Value.Stats;
+        const FString ClassName = Item.Key.IsValid() ? Item.Key->GetName() : FString(TEXT("None"));
+
+        QLUtility::Log(FString::Printf(TEXT("%s: in use %d, free %d, high-water mark %d, spawned %d, reused %d"),
+            *ClassName,
+            Stats.InUseCount,
+            Stats.FreeCount,
+            Stats.HighWaterMark,
+            Stats.SpawnCount,
+            Stats.ReuseCount));
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLActorPoolManager::IsPoolable(UClass* Class)
+{
+    return Class && Class->ImplementsInterface(UQLPoolableActor::StaticClass());
+}
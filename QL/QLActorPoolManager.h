@@ -0,0 +1,123 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLGameModeBase.h"
+#include "QLActorPoolManager.generated.h"
+
+//------------------------------------------------------------
+// Usage statistics of the pool of one actor class
+//------------------------------------------------------------
+struct FQLActorPoolStats
+{
+    FQLActorPoolStats() :
+    InUseCount(0),
+    FreeCount(0),
+    HighWaterMark(0),
+    SpawnCount(0),
+    ReuseCount(0)
+    {
+    }
+
+    // actors currently acquired
+    int32 InUseCount;
+
+    // actors waiting in the pool
+    int32 FreeCount;
+
+    // maximum number of actors acquired at the same time
+    int32 HighWaterMark;
+
+    // actors spawned by the pool, warm-up included
+    int32 SpawnCount;
+
+    // acquisitions served without spawning
+    int32 ReuseCount;
+};
+
+//------------------------------------------------------------
+// Pool of the actors of one class
+//------------------------------------------------------------
+struct FQLActorPool
+{
+    TArray<TWeakObjectPtr<AActor>> FreeList;
+
+    FQLActorPoolStats Stats;
+};
+
+//------------------------------------------------------------
+// Recycle transient actors (projectiles, rail beams) instead of
+// spawning and destroying them. Only the classes implementing
+// IQLPoolableActor are pooled, other classes are simply spawned.
+//
+// Usage mirrors SpawnActorDeferred() / FinishSpawningActor():
+//     auto* Rocket = UQLActorPoolManager::AcquireActorDeferred<AQLRocketProjectile>(this, RocketProjectileClass, Transform);
+//     Rocket->SetDamageMultiplier(...);
+//     UQLActorPoolManager::FinishAcquiringActor(Rocket, Transform);
+// and a pooled actor calls ReleaseActor() instead of Destroy().
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLActorPoolManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLActorPoolManager();
+
+    virtual void Deinitialize() override;
+
+    //------------------------------------------------------------
+    // Acquire an inactive actor from the pool of the world, or spawn one
+    // (deferred) if the pool is empty or the world has no pool.
+    // The caller must call FinishAcquiringActor() once it is configured.
+    //------------------------------------------------------------
+    template <typename T>
+    static T* AcquireActorDeferred(const UObject* WorldContextObject, UClass* Class, const FTransform& Transform)
+    {
+        return Cast<T>(AcquireActorDeferredInternal(WorldContextObject, Class, Transform));
+    }
+
+    //------------------------------------------------------------
+    // Counterpart of AcquireActorDeferred()
+    //------------------------------------------------------------
+    static void FinishAcquiringActor(AActor* Actor, const FTransform& Transform);
+
+    //------------------------------------------------------------
+    // Return the actor to its pool. Return false if the actor was not
+    // created by this pool, in which case the caller should destroy it.
+    //------------------------------------------------------------
+    bool ReleaseActor(AActor* Actor);
+
+    //------------------------------------------------------------
+    // Make sure the pool of Class holds at least Count free actors
+    //------------------------------------------------------------
+    void WarmUp(UClass* Class, int32 Count);
+
+    const FQLActorPoolStats* GetStats(UClass* Class) const;
+
+    void LogStats() const;
+
+protected:
+    static AActor* AcquireActorDeferredInternal(const UObject* WorldContextObject, UClass* Class, const FTransform& Transform);
+
+    AActor* AcquireActorDeferredFromPool(UClass* Class, const FTransform& Transform);
+
+    AActor* SpawnPooledActorDeferred(UClass* Class, const FTransform& Transform);
+
+    static bool IsPoolable(UClass* Class);
+
+    TMap<TWeakObjectPtr<UClass>, FQLActorPool> PoolMap;
+
+    // every actor spawned by the pool, mapped to whether it is currently acquired
+    TMap<TWeakObjectPtr<AActor>, bool> PooledActorMap;
+};
@@ -36,7 +36,7 @@ void AQLArmor::OnComponentBeginOverlapImpl(UPrimitiveComponent* OverlappedComp,
             {
                 Character->AddArmor(ArmorIncrement);
 
-                PlaySoundFireAndForget("PickUp");
+                PlaySoundFireAndForget("PickUp", EQLSoundCategory::Pickup);
 
                 SetActorEnableCollision(false);
                 SetActorHiddenInGame(true);
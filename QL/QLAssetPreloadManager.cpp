@@ -0,0 +1,278 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLAssetPreloadManager.h"
+#include "QLCharacter.h"
+#include "QLPickup.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "AudioDevice.h"
+#include "Sound/SoundWave.h"
+#include "Sound/SoundCue.h"
+#include "Sound/SoundNodeWavePlayer.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+
+static TAutoConsoleVariable<int32> CVarQLPreloadWarmUp(
+    TEXT("ql.PreloadWarmUp"),
+    1,
+    TEXT("1: spawn the particle systems and precache the sounds of the preloaded classes once.\n")
+    TEXT("0: only load the classes."),
+    ECVF_Default);
+
+namespace
+{
+    // far below the arena, where no camera looks
+    const FVector WarmUpLocation(0.0f, 0.0f, -100000.0f);
+
+    // the emitters have to be ticked and rendered at least once
+    const int32 WarmUpFrameCount = 2;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLAssetPreloadManager::UQLAssetPreloadManager() :
+WarmUpFramesLeft(0),
+PreloadStartTime(0.0)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAssetPreloadManager::Deinitialize()
+{
+    for (UParticleSystemComponent* Component : WarmUpComponentList)
+    {
+        if (Component)
+        {
+            Component->DestroyComponent();
+        }
+    }
+
+    for (auto& Handle : HandleList)
+    {
+        if (Handle.IsValid())
+        {
+            Handle->ReleaseHandle();
+        }
+    }
+
+    WarmUpComponentList.Empty();
+    HandleList.Empty();
+    RequestedPathSet.Empty();
+    WarmedUpAssetSet.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAssetPreloadManager::PreloadCharacterEquipment(TSubclassOf<AQLCharacter> CharacterClass)
+{
+    if (!CharacterClass)
+    {
+        return;
+    }
+
+    const AQLCharacter* Character = GetDefault<AQLCharacter>(CharacterClass);
+
+    TArray<FSoftObjectPath> AssetPathList;
+
+    for (const auto& Item : Character->GetWeaponClassList())
+    {
+        AssetPathList.Add(Item.ToSoftObjectPath());
+    }
+
+    for (const auto& Item : Character->GetAbilityClassList())
+    {
+        AssetPathList.Add(Item.ToSoftObjectPath());
+    }
+
+    PreloadAssets(AssetPathList);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAssetPreloadManager::PreloadAssets(const TArray<FSoftObjectPath>& AssetPathList)
+{
+    // several characters share most of their equipment
+    TArray<FSoftObjectPath> NewAssetPathList;
+    for (const FSoftObjectPath& Item : AssetPathList)
+    {
+        if (!Item.IsNull() && !RequestedPathSet.Contains(Item))
+        {
+            RequestedPathSet.Add(Item);
+            NewAssetPathList.Add(Item);
+        }
+    }
+
+    if (NewAssetPathList.Num() == 0 || !UAssetManager::IsValid())
+    {
+        return;
+    }
+
+    if (!IsPreloading())
+    {
+        PreloadStartTime = FPlatformTime::Seconds();
+    }
+
+    TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(NewAssetPathList,
+        FStreamableDelegate::CreateUObject(this, &UQLAssetPreloadManager::OnPreloadCompleted, NewAssetPathList),
+        FStreamableManager::AsyncLoadHighPriority);
+
+    if (Handle.IsValid())
+    {
+        HandleList.Add(Handle);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLAssetPreloadManager::IsPreloading() const
+{
+    for (const auto& Handle : HandleList)
+    {
+        if (Handle.IsValid() && Handle->IsLoadingInProgress())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAssetPreloadManager::OnPreloadCompleted(TArray<FSoftObjectPath> AssetPathList)
+{
+    if (!IsPreloading())
+    {
+        QLUtility::Log(FString::Printf(TEXT("preload: %d assets loaded in %.3f s"),
+            RequestedPathSet.Num(),
+            FPlatformTime::Seconds() - PreloadStartTime));
+    }
+
+    // nothing to warm up in the headless simulation or on a dedicated server
+    if (CVarQLPreloadWarmUp.GetValueOnGameThread() == 0 || !FApp::CanEverRender())
+    {
+        return;
+    }
+
+    TArray<UObject*> WarmUpAssetList;
+
+    for (const FSoftObjectPath& Item : AssetPathList)
+    {
+        UClass* Class = Cast<UClass>(Item.ResolveObject());
+        if (!Class || !Class->IsChildOf(AQLPickup::StaticClass()))
+        {
+            continue;
+        }
+
+        GetDefault<AQLPickup>(Class)->GetWarmUpAssetList(WarmUpAssetList);
+    }
+
+    for (UObject* Asset : WarmUpAssetList)
+    {
+        WarmUpAsset(Asset);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAssetPreloadManager::WarmUpAsset(UObject* Asset)
+{
+    if (!Asset || WarmedUpAssetSet.Contains(Asset))
+    {
+        return;
+    }
+
+    WarmedUpAssetSet.Add(Asset);
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    if (UParticleSystem* ParticleSystem = Cast<UParticleSystem>(Asset))
+    {
+        UParticleSystemComponent* Component = UGameplayStatics::SpawnEmitterAtLocation(World,
+            ParticleSystem,
+            WarmUpLocation,
+            FRotator::ZeroRotator,
+            FVector(1.0f),
+            false); // auto destroy
+        if (Component)
+        {
+            WarmUpComponentList.Add(Component);
+            WarmUpFramesLeft = WarmUpFrameCount;
+        }
+        return;
+    }
+
+    FAudioDevice* AudioDevice = World->GetAudioDevice();
+    if (!AudioDevice)
+    {
+        return;
+    }
+
+    if (USoundWave* SoundWave = Cast<USoundWave>(Asset))
+    {
+        AudioDevice->Precache(SoundWave);
+    }
+    else if (USoundCue* SoundCue = Cast<USoundCue>(Asset))
+    {
+        TArray<USoundNodeWavePlayer*> WavePlayerList;
+        SoundCue->RecursiveFindNode<USoundNodeWavePlayer>(SoundCue->FirstNode, WavePlayerList);
+
+        for (USoundNodeWavePlayer* WavePlayer : WavePlayerList)
+        {
+            if (WavePlayer && WavePlayer->GetSoundWave())
+            {
+                AudioDevice->Precache(WavePlayer->GetSoundWave());
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAssetPreloadManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (WarmUpComponentList.Num() == 0)
+    {
+        return;
+    }
+
+    --WarmUpFramesLeft;
+    if (WarmUpFramesLeft > 0)
+    {
+        return;
+    }
+
+    for (UParticleSystemComponent* Component : WarmUpComponentList)
+    {
+        if (Component)
+        {
+            Component->DestroyComponent();
+        }
+    }
+
+    WarmUpComponentList.Reset();
+}
@@ -0,0 +1,74 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLAssetPreloadManager.generated.h"
+
+class AQLCharacter;
+class UParticleSystemComponent;
+struct FStreamableHandle;
+
+//------------------------------------------------------------
+// Load the weapon and ability classes of the characters while the
+// map loads, instead of when AQLCharacter::EquipAll() spawns them.
+// Once a class is loaded, the particle systems and sounds it uses
+// (see AQLPickup::GetWarmUpAssetList()) are warmed up: each particle
+// system is spawned once out of sight, and each sound wave is
+// precached by the audio device, so that the first shot of every
+// weapon does not hitch.
+//
+// A class still loading when a character equips it is loaded
+// synchronously by the weapon/ability manager.
+// ql.PreloadWarmUp 0 only loads the classes.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLAssetPreloadManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLAssetPreloadManager();
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    //------------------------------------------------------------
+    // Preload the weapon and ability classes of the character class
+    //------------------------------------------------------------
+    void PreloadCharacterEquipment(TSubclassOf<AQLCharacter> CharacterClass);
+
+    void PreloadAssets(const TArray<FSoftObjectPath>& AssetPathList);
+
+    bool IsPreloading() const;
+
+protected:
+    void OnPreloadCompleted(TArray<FSoftObjectPath> AssetPathList);
+
+    void WarmUpAsset(UObject* Asset);
+
+    // keep the loaded assets alive for the lifetime of the world
+    TArray<TSharedPtr<FStreamableHandle>> HandleList;
+
+    TSet<FSoftObjectPath> RequestedPathSet;
+
+    TSet<const UObject*> WarmedUpAssetSet;
+
+    // particle systems spawned out of sight, destroyed a few frames later
+    UPROPERTY()
+    TArray<UParticleSystemComponent*> WarmUpComponentList;
+
+    int32 WarmUpFramesLeft;
+
+    double PreloadStartTime;
+};
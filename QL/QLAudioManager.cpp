@@ -9,11 +9,321 @@
 //------------------------------------------------------------
 
 #include "QLAudioManager.h"
+#include "QLGameModeBase.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundAttenuation.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLAudioVoiceCount(
+    TEXT("ql.AudioVoiceCount"),
+    32,
+    TEXT("Number of pooled audio components playing the fire-and-forget sounds."),
+    ECVF_Default);
+
+namespace
+{
+    struct FQLSoundCategorySettings
+    {
+        const TCHAR* Name;
+
+        // a sound can replace a playing voice of a lower priority when the pool is full
+        int32 Priority;
+
+        int32 MaxVoiceCount;
+
+        // when the category is full, true to replace its oldest voice, false to drop the new sound
+        bool bStealOldest;
+    };
+
+    // indexed by EQLSoundCategory
+    const FQLSoundCategorySettings SoundCategorySettingsList[] = {
+        { TEXT("Default"),    30, 8, true },
+        { TEXT("HitConfirm"), 100, 2, true },
+        { TEXT("Voice"),      80, 4, false },
+        { TEXT("WeaponFire"), 60, 8, true },
+        { TEXT("Explosion"),  50, 6, true },
+        { TEXT("Pickup"),     40, 4, true },
+        { TEXT("Impact"),     20, 6, false },
+    };
+
+    static_assert(ARRAY_COUNT(SoundCategorySettingsList) == static_cast<int32>(EQLSoundCategory::Count), "one settings entry per sound category");
+}
+
+//------------------------------------------------------------
+// Print the counters of the audio manager of the world
+//------------------------------------------------------------
+static void LogAudioStats(UWorld* World)
+{
+    UQLAudioManager* AudioManager = AQLGameModeBase::GetWorldService<UQLAudioManager>(World);
+    if (AudioManager)
+    {
+        AudioManager->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLAudioStatsCommand(
+    TEXT("ql.AudioStats"),
+    TEXT("Print the number of sounds requested, played, culled and stolen per category."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogAudioStats));
 
 //------------------------------------------------------------
 //------------------------------------------------------------
 UQLAudioManager::UQLAudioManager()
 {
+    FMemory::Memzero(RequestedCountList);
+    FMemory::Memzero(PlayedCountList);
+    FMemory::Memzero(CulledCountList);
+    FMemory::Memzero(StolenCountList);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAudioManager::Deinitialize()
+{
+    for (UAudioComponent* Component : ComponentList)
+    {
+        if (Component)
+        {
+            Component->Stop();
+            Component->DestroyComponent();
+        }
+    }
+
+    ComponentList.Empty();
+    VoiceList.Empty();
+    SoundEntryList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FQLSoundHandle UQLAudioManager::ResolveSound(USoundBase* Sound, USoundAttenuation* SoundAttenuation)
+{
+    FQLSoundHandle SoundHandle;
+    if (!Sound)
+    {
+        return SoundHandle;
+    }
+
+    // only resolved when the actors begin play, a linear search is fine
+    for (int32 Index = 0; Index < SoundEntryList.Num(); ++Index)
+    {
+        const FQLSoundEntry& Entry = SoundEntryList[Index];
+        if (Entry.Sound.Get() == Sound && Entry.SoundAttenuation.Get() == SoundAttenuation)
+        {
+            SoundHandle.Index = Index;
+            return SoundHandle;
+        }
+    }
+
+    SoundHandle.Index = SoundEntryList.Add({ Sound, SoundAttenuation });
+    return SoundHandle;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAudioManager::ResolveSoundList(const TMap<FName, USoundBase*>& SoundList, USoundAttenuation* SoundAttenuation, TMap<FName, FQLSoundHandle>& OutSoundHandleList)
+{
+    OutSoundHandleList.Reset();
+
+    for (const auto& Item : SoundList)
+    {
+        FQLSoundHandle SoundHandle = ResolveSound(Item.Value, SoundAttenuation);
+        if (SoundHandle.IsValid())
+        {
+            OutSoundHandleList.Add(Item.Key, SoundHandle);
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+USoundBase* UQLAudioManager::GetSound(const FQLSoundHandle& SoundHandle) const
+{
+    if (!SoundEntryList.IsValidIndex(SoundHandle.Index))
+    {
+        return nullptr;
+    }
+
+    return SoundEntryList[SoundHandle.Index].Sound.Get();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLAudioManager::PlaySoundAtLocation(const FQLSoundHandle& SoundHandle, const FVector& Location, EQLSoundCategory Category)
+{
+    const int32 CategoryIndex = static_cast<int32>(Category);
+    if (CategoryIndex < 0 || CategoryIndex >= static_cast<int32>(EQLSoundCategory::Count))
+    {
+        return false;
+    }
+
+    ++RequestedCountList[CategoryIndex];
+
+    UWorld* World = GetWorld();
+    USoundBase* Sound = GetSound(SoundHandle);
+
+    // nobody to hear the sound, e.g. in the headless simulation
+    if (!World || !Sound || !World->GetAudioDevice())
+    {
+        ++CulledCountList[CategoryIndex];
+        return false;
+    }
+
+    const int32 VoiceIndex = FindVoice(Category);
+    if (VoiceIndex == INDEX_NONE)
+    {
+        ++CulledCountList[CategoryIndex];
+        return false;
+    }
+
+    UAudioComponent* Component = ComponentList[VoiceIndex];
+    if (Component->IsPlaying())
+    {
+        Component->Stop();
+        ++StolenCountList[static_cast<int32>(VoiceList[VoiceIndex].Category)];
+    }
+
+    Component->SetWorldLocation(Location);
+    Component->AttenuationSettings = SoundEntryList[SoundHandle.Index].SoundAttenuation.Get();
+    Component->SetSound(Sound);
+    Component->Play(0.0f);
+
+    FQLVoice& Voice = VoiceList[VoiceIndex];
+    Voice.Category = Category;
+    Voice.Priority = SoundCategorySettingsList[CategoryIndex].Priority;
+    Voice.StartTime = World->GetTimeSeconds();
+
+    ++PlayedCountList[CategoryIndex];
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLAudioManager::GetCategoryPriority(EQLSoundCategory Category)
+{
+    const int32 CategoryIndex = static_cast<int32>(Category);
+    if (CategoryIndex < 0 || CategoryIndex >= static_cast<int32>(EQLSoundCategory::Count))
+    {
+        return 0;
+    }
 
+    return SoundCategorySettingsList[CategoryIndex].Priority;
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLAudioManager::FindVoice(EQLSoundCategory Category)
+{
+    const FQLSoundCategorySettings& Settings = SoundCategorySettingsList[static_cast<int32>(Category)];
+
+    int32 CategoryVoiceCount = 0;
+    int32 OldestCategoryVoiceIndex = INDEX_NONE;
+    int32 FreeVoiceIndex = INDEX_NONE;
+    int32 LowestPriorityVoiceIndex = INDEX_NONE;
+
+    for (int32 Index = 0; Index < ComponentList.Num(); ++Index)
+    {
+        UAudioComponent* Component = ComponentList[Index];
+        if (!Component || !Component->IsPlaying())
+        {
+            if (Component && FreeVoiceIndex == INDEX_NONE)
+            {
+                FreeVoiceIndex = Index;
+            }
+            continue;
+        }
+
+        const FQLVoice& Voice = VoiceList[Index];
+
+        if (Voice.Category == Category)
+        {
+            ++CategoryVoiceCount;
+            if (OldestCategoryVoiceIndex == INDEX_NONE || Voice.StartTime < VoiceList[OldestCategoryVoiceIndex].StartTime)
+            {
+                OldestCategoryVoiceIndex = Index;
+            }
+        }
+
+        // lowest priority first, then oldest
+        if (Voice.Priority < Settings.Priority)
+        {
+            if (LowestPriorityVoiceIndex == INDEX_NONE
+                || Voice.Priority < VoiceList[LowestPriorityVoiceIndex].Priority
+                || (Voice.Priority == VoiceList[LowestPriorityVoiceIndex].Priority && Voice.StartTime < VoiceList[LowestPriorityVoiceIndex].StartTime))
+            {
+                LowestPriorityVoiceIndex = Index;
+            }
+        }
+    }
+
+    if (CategoryVoiceCount >= Settings.MaxVoiceCount)
+    {
+        return Settings.bStealOldest ? OldestCategoryVoiceIndex : INDEX_NONE;
+    }
+
+    if (FreeVoiceIndex != INDEX_NONE)
+    {
+        return FreeVoiceIndex;
+    }
+
+    if (ComponentList.Num() < CVarQLAudioVoiceCount.GetValueOnGameThread())
+    {
+        const int32 NewVoiceIndex = CreateVoice();
+        if (NewVoiceIndex != INDEX_NONE)
+        {
+            return NewVoiceIndex;
+        }
+    }
+
+    return LowestPriorityVoiceIndex;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLAudioManager::CreateVoice()
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return INDEX_NONE;
+    }
+
+    UAudioComponent* Component = NewObject<UAudioComponent>(World->GetWorldSettings());
+    if (!Component)
+    {
+        return INDEX_NONE;
+    }
+
+    Component->bAutoActivate = false;
+    Component->bAutoDestroy = false;
+    Component->bAllowSpatialization = true;
+    Component->RegisterComponentWithWorld(World);
+
+    ComponentList.Add(Component);
+    return VoiceList.Add({ EQLSoundCategory::Default, 0, 0.0f });
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLAudioManager::LogStats() const
+{
+    QLUtility::Log(FString::Printf(TEXT("audio: %d voices, %d sounds resolved"),
+        ComponentList.Num(),
+        SoundEntryList.Num()));
+
+    for (int32 CategoryIndex = 0; CategoryIndex < static_cast<int32>(EQLSoundCategory::Count); ++CategoryIndex)
+    {
+        QLUtility::Log(FString::Printf(TEXT("    %s: requested %d, played %d, culled %d, stolen %d"),
+            SoundCategorySettingsList[CategoryIndex].Name,
+            RequestedCountList[CategoryIndex],
+            PlayedCountList[CategoryIndex],
+            CulledCountList[CategoryIndex],
+            StolenCountList[CategoryIndex]));
+    }
+}
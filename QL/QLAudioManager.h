@@ -11,19 +11,135 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "UObject/NoExportTypes.h"
+#include "QLWorldService.h"
 #include "QLAudioManager.generated.h"
 
+class USoundBase;
+class USoundAttenuation;
+class UAudioComponent;
+
+//------------------------------------------------------------
+// Each category has a priority and a maximum number of voices,
+// see SoundCategorySettingsList in QLAudioManager.cpp
+//------------------------------------------------------------
+UENUM(BlueprintType)
+enum class EQLSoundCategory : uint8
+{
+    Default,
+    HitConfirm,
+    Voice,
+    WeaponFire,
+    Explosion,
+    Pickup,
+    Impact,
+    Count UMETA(Hidden),
+};
+
+//------------------------------------------------------------
+// A sound and its attenuation, resolved once by the audio manager
+//------------------------------------------------------------
+struct FQLSoundHandle
+{
+    FQLSoundHandle() :
+    Index(INDEX_NONE)
+    {
+    }
+
+    bool IsValid() const
+    {
+        return Index != INDEX_NONE;
+    }
+
+    int32 Index;
+};
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+struct FQLSoundEntry
+{
+    TWeakObjectPtr<USoundBase> Sound;
+
+    TWeakObjectPtr<USoundAttenuation> SoundAttenuation;
+};
+
+//------------------------------------------------------------
+// What an audio component of the pool is playing
+//------------------------------------------------------------
+struct FQLVoice
+{
+    EQLSoundCategory Category;
+
+    int32 Priority;
+
+    float StartTime;
+};
+
 //------------------------------------------------------------
+// Fire-and-forget sounds of the world, played by a pool of
+// audio components instead of spawning one per sound.
+// The actors resolve their sound lists into handles once, then
+// play a handle with a category. A category already playing its
+// maximum number of voices replaces its oldest voice or drops the
+// new sound; when the pool is full, a sound may only replace a
+// voice of a lower priority, e.g. a hit confirm cuts a nail gun
+// impact but not the other way around.
+//
+// ql.AudioVoiceCount sets the size of the pool. ql.AudioStats
+// prints the voices requested, played, culled and stolen.
 //------------------------------------------------------------
-UCLASS(Blueprintable)
-class QL_API UQLAudioManager : public UObject
+UCLASS()
+class QL_API UQLAudioManager : public UQLWorldService
 {
-	GENERATED_BODY()
+    GENERATED_BODY()
 
 public:
     UQLAudioManager();
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
-    TMap<FName, USoundBase*> SoundList;
+    virtual void Deinitialize() override;
+
+    FQLSoundHandle ResolveSound(USoundBase* Sound, USoundAttenuation* SoundAttenuation);
+
+    //------------------------------------------------------------
+    // Resolve every sound of an actor's sound list
+    //------------------------------------------------------------
+    void ResolveSoundList(const TMap<FName, USoundBase*>& SoundList, USoundAttenuation* SoundAttenuation, TMap<FName, FQLSoundHandle>& OutSoundHandleList);
+
+    USoundBase* GetSound(const FQLSoundHandle& SoundHandle) const;
+
+    //------------------------------------------------------------
+    // Return false if the sound has been culled
+    //------------------------------------------------------------
+    bool PlaySoundAtLocation(const FQLSoundHandle& SoundHandle, const FVector& Location, EQLSoundCategory Category);
+
+    //------------------------------------------------------------
+    // A sound of a higher priority may replace a playing voice of a lower one
+    //------------------------------------------------------------
+    static int32 GetCategoryPriority(EQLSoundCategory Category);
+
+    void LogStats() const;
+
+protected:
+    //------------------------------------------------------------
+    // Index of the pool component to play a sound of the category on,
+    // INDEX_NONE if the sound has to be culled
+    //------------------------------------------------------------
+    int32 FindVoice(EQLSoundCategory Category);
+
+    int32 CreateVoice();
+
+    TArray<FQLSoundEntry> SoundEntryList;
+
+    UPROPERTY()
+    TArray<UAudioComponent*> ComponentList;
+
+    // parallel to ComponentList
+    TArray<FQLVoice> VoiceList;
+
+    int32 RequestedCountList[static_cast<int32>(EQLSoundCategory::Count)];
+
+    int32 PlayedCountList[static_cast<int32>(EQLSoundCategory::Count)];
+
+    int32 CulledCountList[static_cast<int32>(EQLSoundCategory::Count)];
+
+    int32 StolenCountList[static_cast<int32>(EQLSoundCategory::Count)];
 };
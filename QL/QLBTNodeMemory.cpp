@@ -0,0 +1,43 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLBTNodeMemory.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "QLAIController.h"
+#include "QLCharacter.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool FQLBTNodeMemory::Resolve(UBehaviorTreeComponent& OwnerComp)
+{
+    if (!Controller.IsValid())
+    {
+        Controller = Cast<AQLAIController>(OwnerComp.GetAIOwner());
+        if (!Controller.IsValid())
+        {
+            return false;
+        }
+    }
+
+    APawn* Pawn = Controller->GetPawn();
+    if (!Pawn)
+    {
+        Character.Reset();
+        return false;
+    }
+
+    if (Character.Get() != Pawn)
+    {
+        Character = Cast<AQLCharacter>(Pawn);
+    }
+
+    return Character.IsValid();
+}
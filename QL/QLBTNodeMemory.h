@@ -0,0 +1,35 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBehaviorTreeComponent;
+class AQLAIController;
+class AQLCharacter;
+
+//------------------------------------------------------------
+// Instance memory of the QL behavior tree nodes: the typed owner
+// of the tree, cast once per bot instead of on every run.
+// The character is cast again only when the controller possesses
+// another pawn.
+//------------------------------------------------------------
+struct FQLBTNodeMemory
+{
+    TWeakObjectPtr<AQLAIController> Controller;
+
+    TWeakObjectPtr<AQLCharacter> Character;
+
+    //------------------------------------------------------------
+    // Return false if the tree is not run by a QL bot
+    //------------------------------------------------------------
+    bool Resolve(UBehaviorTreeComponent& OwnerComp);
+};
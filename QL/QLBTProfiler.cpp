@@ -0,0 +1,143 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLBTProfiler.h"
+#include "QLGameModeBase.h"
+#include "QLUtility.h"
+#include "AIController.h"
+#include "BehaviorTree/BTNode.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLBTProfile(
+    TEXT("ql.BTProfile"),
+    0,
+    TEXT("1: record the cost of each QL behavior tree node per bot, see ql.BTProfileStats."),
+    ECVF_Default);
+
+//------------------------------------------------------------
+// Print the counters of the behavior tree profiler of the world
+//------------------------------------------------------------
+static void LogBTProfileStats(UWorld* World)
+{
+    UQLBTProfiler* Profiler = AQLGameModeBase::GetWorldService<UQLBTProfiler>(World);
+    if (Profiler)
+    {
+        Profiler->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLBTProfileStatsCommand(
+    TEXT("ql.BTProfileStats"),
+    TEXT("Print the execution count and cost of each QL behavior tree node per bot, then reset them."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogBTProfileStats));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLBTProfiler::UQLBTProfiler()
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLBTProfiler::Deinitialize()
+{
+    StatsList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLBTProfiler::IsEnabled()
+{
+    return CVarQLBTProfile.GetValueOnGameThread() != 0;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLBTProfiler::Record(const UBTNode* Node, const AAIController* Controller, double Seconds)
+{
+    if (!Node || !Controller)
+    {
+        return;
+    }
+
+    TMap<TWeakObjectPtr<const UBTNode>, FQLBTNodeStats>& NodeStatsList = StatsList.FindOrAdd(Controller);
+
+    FQLBTNodeStats* Stats = NodeStatsList.Find(Node);
+    if (!Stats)
+    {
+        Stats = &NodeStatsList.Add(Node, { 0, 0.0, 0.0 });
+    }
+
+    ++Stats->ExecutionCount;
+    Stats->TotalSeconds += Seconds;
+    Stats->MaxSeconds = FMath::Max(Stats->MaxSeconds, Seconds);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLBTProfiler::LogStats()
+{
+    QLUtility::Log(FString::Printf(TEXT("behavior tree profile: %d bots%s"),
+        StatsList.Num(),
+        IsEnabled() ? TEXT("") : TEXT(", ql.BTProfile is off")));
+
+    for (const auto& BotItem : StatsList)
+    {
+        const AAIController* Controller = BotItem.Key.Get();
+        QLUtility::Log(FString::Printf(TEXT("    %s"), Controller ? *Controller->GetName() : TEXT("(destroyed)")));
+
+        for (const auto& NodeItem : BotItem.Value)
+        {
+            const UBTNode* Node = NodeItem.Key.Get();
+            const FQLBTNodeStats& Stats = NodeItem.Value;
+
+            QLUtility::Log(FString::Printf(TEXT("        %s: %d runs, %.3f ms total, %.2f us average, %.2f us max"),
+                Node ? *Node->GetNodeName() : TEXT("(unloaded)"),
+                Stats.ExecutionCount,
+                Stats.TotalSeconds * 1000.0,
+                Stats.ExecutionCount > 0 ? Stats.TotalSeconds * 1000000.0 / Stats.ExecutionCount : 0.0,
+                Stats.MaxSeconds * 1000000.0));
+        }
+    }
+
+    StatsList.Reset();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FQLBTProfileScope::FQLBTProfileScope(const UBTNode* InNode, UBehaviorTreeComponent& InOwnerComp) :
+Node(InNode),
+OwnerComp(&InOwnerComp),
+StartTime(UQLBTProfiler::IsEnabled() ? FPlatformTime::Seconds() : 0.0)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FQLBTProfileScope::~FQLBTProfileScope()
+{
+    if (StartTime == 0.0)
+    {
+        return;
+    }
+
+    const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+    UQLBTProfiler* Profiler = AQLGameModeBase::GetWorldService<UQLBTProfiler>(OwnerComp);
+    if (Profiler)
+    {
+        Profiler->Record(Node, OwnerComp->GetAIOwner(), Seconds);
+    }
+}
@@ -0,0 +1,73 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLBTProfiler.generated.h"
+
+class UBTNode;
+class UBehaviorTreeComponent;
+class AAIController;
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+struct FQLBTNodeStats
+{
+    int32 ExecutionCount;
+
+    double TotalSeconds;
+
+    double MaxSeconds;
+};
+
+//------------------------------------------------------------
+// Cost and execution count of each QL behavior tree node, per bot.
+// Off by default: ql.BTProfile 1 starts recording, ql.BTProfileStats
+// prints the counters and resets them.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLBTProfiler : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLBTProfiler();
+
+    virtual void Deinitialize() override;
+
+    static bool IsEnabled();
+
+    void Record(const UBTNode* Node, const AAIController* Controller, double Seconds);
+
+    void LogStats();
+
+protected:
+    TMap<TWeakObjectPtr<const AAIController>, TMap<TWeakObjectPtr<const UBTNode>, FQLBTNodeStats>> StatsList;
+};
+
+//------------------------------------------------------------
+// Measure the enclosing scope of a node and record it in the
+// profiler of the world when ql.BTProfile is set
+//------------------------------------------------------------
+struct QL_API FQLBTProfileScope
+{
+    FQLBTProfileScope(const UBTNode* InNode, UBehaviorTreeComponent& InOwnerComp);
+
+    ~FQLBTProfileScope();
+
+    const UBTNode* Node;
+
+    UBehaviorTreeComponent* OwnerComp;
+
+    // 0 when the profiler is off
+    double StartTime;
+};
@@ -16,6 +16,9 @@
 #include "QLCharacter.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "QLAIController.h"
+#include "QLBTNodeMemory.h"
+#include "QLBTProfiler.h"
+#include "BehaviorTree/BlackboardData.h"
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -23,6 +26,41 @@ UQLBTServiceUpdateTargetInfo::UQLBTServiceUpdateTargetInfo(const FObjectInitiali
     Super(ObjectInitializer)
 {
     NodeName = "UpdateTargetInfo";
+
+    // the keys of the blackboard asset, so the existing trees need no edit
+    CanAttackTargetKey.SelectedKeyName = FName(TEXT("CanAttackTarget"));
+    CanAttackTargetKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UQLBTServiceUpdateTargetInfo, CanAttackTargetKey));
+
+    TargetKey.SelectedKeyName = FName(TEXT("Target"));
+    TargetKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UQLBTServiceUpdateTargetInfo, TargetKey), AActor::StaticClass());
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLBTServiceUpdateTargetInfo::InitializeFromAsset(UBehaviorTree& Asset)
+{
+    Super::InitializeFromAsset(Asset);
+
+    UBlackboardData* BlackboardAsset = GetBlackboardAsset();
+    if (BlackboardAsset)
+    {
+        CanAttackTargetKey.ResolveSelectedKey(*BlackboardAsset);
+        TargetKey.ResolveSelectedKey(*BlackboardAsset);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+uint16 UQLBTServiceUpdateTargetInfo::GetInstanceMemorySize() const
+{
+    return sizeof(FQLBTNodeMemory);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLBTServiceUpdateTargetInfo::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+    new (NodeMemory) FQLBTNodeMemory();
 }
 
 //------------------------------------------------------------
@@ -31,9 +69,10 @@ void UQLBTServiceUpdateTargetInfo::TickNode(UBehaviorTreeComponent& OwnerComp, u
 {
     Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
 
-    auto* MyController = Cast<AQLAIController>(OwnerComp.GetAIOwner());
+    FQLBTProfileScope ProfileScope(this, OwnerComp);
 
-    if (!MyController)
+    FQLBTNodeMemory* Memory = CastInstanceNodeMemory<FQLBTNodeMemory>(NodeMemory);
+    if (!Memory->Resolve(OwnerComp))
     {
         return;
     }
@@ -41,13 +80,13 @@ void UQLBTServiceUpdateTargetInfo::TickNode(UBehaviorTreeComponent& OwnerComp, u
     UBlackboardComponent* BlackboardComponent = OwnerComp.GetBlackboardComponent();
     if (BlackboardComponent)
     {
-        AQLCharacter* Target = MyController->GetTarget();
+        AQLCharacter* Target = Memory->Controller->GetTarget();
         bool bResult = Target && Target->QLGetVisibility() && Target->IsAlive();
-        BlackboardComponent->SetValueAsBool(FName(TEXT("CanAttackTarget")), bResult);
+        BlackboardComponent->SetValue<UBlackboardKeyType_Bool>(CanAttackTargetKey.GetSelectedKeyID(), bResult);
 
         if (Target)
         {
-            BlackboardComponent->SetValueAsObject(FName(TEXT("Target")), Target);
+            BlackboardComponent->SetValue<UBlackboardKeyType_Object>(TargetKey.GetSelectedKeyID(), Target);
         }
     }
-}
\ No newline at end of file
+}
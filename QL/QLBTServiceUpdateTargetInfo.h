@@ -26,7 +26,22 @@ public:
     //------------------------------------------------------------
     UQLBTServiceUpdateTargetInfo(const FObjectInitializer& ObjectInitializer);
 
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
+    virtual uint16 GetInstanceMemorySize() const override;
+
+    virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+
     //------------------------------------------------------------
     //------------------------------------------------------------
     virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8 * NodeMemory, float DeltaSeconds) override;
+
+protected:
+    UPROPERTY(EditAnywhere, Category = "C++Property")
+    FBlackboardKeySelector CanAttackTargetKey;
+
+    UPROPERTY(EditAnywhere, Category = "C++Property")
+    FBlackboardKeySelector TargetKey;
 };
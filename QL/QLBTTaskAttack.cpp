@@ -11,6 +11,8 @@
 
 #include "QLBTTaskAttack.h"
 #include "QLAIController.h"
+#include "QLBTNodeMemory.h"
+#include "QLBTProfiler.h"
 #include "QLCharacter.h"
 #include "QLUtility.h"
 #include "GameFramework/CharacterMovementComponent.h"
@@ -26,29 +28,36 @@ UQLBTTaskAttack::UQLBTTaskAttack(const FObjectInitializer& ObjectInitializer) :
     NodeName = "Attack";
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+uint16 UQLBTTaskAttack::GetInstanceMemorySize() const
+{
+    return sizeof(FQLBTNodeMemory);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLBTTaskAttack::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+    new (NodeMemory) FQLBTNodeMemory();
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 EBTNodeResult::Type UQLBTTaskAttack::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
     Super::ExecuteTask(OwnerComp, NodeMemory);
 
-    auto* MyController = Cast<AQLAIController>(OwnerComp.GetAIOwner());
-    if (!MyController)
-    {
-        return EBTNodeResult::Failed;
-    }
+    FQLBTProfileScope ProfileScope(this, OwnerComp);
 
-    APawn* MyBot = MyController->GetPawn();
-    if (!MyBot)
+    FQLBTNodeMemory* Memory = CastInstanceNodeMemory<FQLBTNodeMemory>(NodeMemory);
+    if (!Memory->Resolve(OwnerComp))
     {
         return EBTNodeResult::Failed;
     }
 
-    AQLCharacter* MyBotCharacter = Cast<AQLCharacter>(MyBot);
-    if (!MyBotCharacter)
-    {
-        return EBTNodeResult::Failed;
-    }
+    AQLAIController* MyController = Memory->Controller.Get();
+    AQLCharacter* MyBotCharacter = Memory->Character.Get();
 
     UBlackboardComponent* BlackboardComponent = OwnerComp.GetBlackboardComponent();
     if (BlackboardComponent)
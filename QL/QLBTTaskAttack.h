@@ -26,6 +26,12 @@ public:
     //------------------------------------------------------------
     UQLBTTaskAttack(const FObjectInitializer& ObjectInitializer);
 
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    virtual uint16 GetInstanceMemorySize() const override;
+
+    virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+
     //------------------------------------------------------------
     //------------------------------------------------------------
     virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
@@ -11,6 +11,8 @@
 
 #include "QLBTTaskFollowTarget.h"
 #include "QLAIController.h"
+#include "QLBTNodeMemory.h"
+#include "QLBTProfiler.h"
 #include "QLCharacter.h"
 #include "QLUtility.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyAllTypes.h"
@@ -24,29 +26,36 @@ UQLBTTaskFollowTarget::UQLBTTaskFollowTarget(const FObjectInitializer& ObjectIni
     NodeName = "FollowTarget";
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+uint16 UQLBTTaskFollowTarget::GetInstanceMemorySize() const
+{
+    return sizeof(FQLBTNodeMemory);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLBTTaskFollowTarget::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+    new (NodeMemory) FQLBTNodeMemory();
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 EBTNodeResult::Type UQLBTTaskFollowTarget::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
 {
     Super::ExecuteTask(OwnerComp, NodeMemory);
 
-    auto* MyController = Cast<AQLAIController>(OwnerComp.GetAIOwner());
-    if (!MyController)
-    {
-        return EBTNodeResult::Failed;
-    }
+    FQLBTProfileScope ProfileScope(this, OwnerComp);
 
-    APawn* MyBot = MyController->GetPawn();
-    if (!MyBot)
+    FQLBTNodeMemory* Memory = CastInstanceNodeMemory<FQLBTNodeMemory>(NodeMemory);
+    if (!Memory->Resolve(OwnerComp))
     {
         return EBTNodeResult::Failed;
     }
 
-    AQLCharacter* MyBotCharacter = Cast<AQLCharacter>(MyBot);
-    if (!MyBotCharacter)
-    {
-        return EBTNodeResult::Failed;
-    }
+    AQLAIController* MyController = Memory->Controller.Get();
+    AQLCharacter* MyBotCharacter = Memory->Character.Get();
 
     MyBotCharacter->ResetMaxWalkSpeed();
 
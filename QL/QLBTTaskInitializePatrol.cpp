@@ -11,11 +11,16 @@
 
 #include "QLBTTaskInitializePatrol.h"
 #include "QLAIController.h"
+#include "QLBTNodeMemory.h"
+#include "QLBTProfiler.h"
 #include "QLCharacter.h"
+#include "QLGameModeBase.h"
+#include "QLPatrolPointManager.h"
 #include "QLUtility.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyAllTypes.h"
 #include "NavigationSystem.h"
+#include "BehaviorTree/BlackboardData.h"
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -23,32 +28,56 @@ UQLBTTaskInitializePatrol::UQLBTTaskInitializePatrol(const FObjectInitializer& O
     Super(ObjectInitializer)
 {
     NodeName = "InitializePatrol";
+
+    // the key of the blackboard asset, so the existing trees need no edit
+    PatrolLocationKey.SelectedKeyName = FName(TEXT("PatrolLocation"));
+    PatrolLocationKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UQLBTTaskInitializePatrol, PatrolLocationKey));
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-EBTNodeResult::Type UQLBTTaskInitializePatrol::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+void UQLBTTaskInitializePatrol::InitializeFromAsset(UBehaviorTree& Asset)
 {
-    Super::ExecuteTask(OwnerComp, NodeMemory);
+    Super::InitializeFromAsset(Asset);
 
-    auto* MyController = Cast<AQLAIController>(OwnerComp.GetAIOwner());
-    if (!MyController)
+    UBlackboardData* BlackboardAsset = GetBlackboardAsset();
+    if (BlackboardAsset)
     {
-        return EBTNodeResult::Failed;
+        PatrolLocationKey.ResolveSelectedKey(*BlackboardAsset);
     }
+}
 
-    APawn* MyBot = MyController->GetPawn();
-    if (!MyBot)
-    {
-        return EBTNodeResult::Failed;
-    }
+//------------------------------------------------------------
+//------------------------------------------------------------
+uint16 UQLBTTaskInitializePatrol::GetInstanceMemorySize() const
+{
+    return sizeof(FQLBTNodeMemory);
+}
 
-    AQLCharacter* MyBotCharacter = Cast<AQLCharacter>(MyBot);
-    if (!MyBotCharacter)
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLBTTaskInitializePatrol::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+    new (NodeMemory) FQLBTNodeMemory();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+EBTNodeResult::Type UQLBTTaskInitializePatrol::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+    Super::ExecuteTask(OwnerComp, NodeMemory);
+
+    FQLBTProfileScope ProfileScope(this, OwnerComp);
+
+    FQLBTNodeMemory* Memory = CastInstanceNodeMemory<FQLBTNodeMemory>(NodeMemory);
+    if (!Memory->Resolve(OwnerComp))
     {
         return EBTNodeResult::Failed;
     }
 
+    AQLAIController* MyController = Memory->Controller.Get();
+    AQLCharacter* MyBotCharacter = Memory->Character.Get();
+
     // disable weapon in use
     AQLWeapon* CurrentWeapon = MyBotCharacter->GetCurrentWeapon();
     if (CurrentWeapon)
@@ -56,15 +85,19 @@ EBTNodeResult::Type UQLBTTaskInitializePatrol::ExecuteTask(UBehaviorTreeComponen
         CurrentWeapon->StopFire();
     }
 
-    // get a random location
+    // get a random location, from the patrol point pool if it covers the bot
     FVector RandomLocation;
-    float SearchRadius = 1000.0f;
-    UNavigationSystemV1::K2_GetRandomReachablePointInRadius(MyController, MyBotCharacter->GetActorLocation(), RandomLocation, SearchRadius);
+    UQLPatrolPointManager* PatrolPointManager = AQLGameModeBase::GetWorldService<UQLPatrolPointManager>(MyController);
+    if (!PatrolPointManager || !PatrolPointManager->GetPatrolLocation(MyBotCharacter->GetActorLocation(), RandomLocation))
+    {
+        float SearchRadius = 1000.0f;
+        UNavigationSystemV1::K2_GetRandomReachablePointInRadius(MyController, MyBotCharacter->GetActorLocation(), RandomLocation, SearchRadius);
+    }
 
     UBlackboardComponent* BlackboardComponent = OwnerComp.GetBlackboardComponent();
     if (BlackboardComponent)
     {
-        BlackboardComponent->SetValueAsVector(FName(TEXT("PatrolLocation")), RandomLocation);
+        BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(PatrolLocationKey.GetSelectedKeyID(), RandomLocation);
     }
 
     MyBotCharacter->SetMaxWalkSpeed(125.0f);
@@ -26,7 +26,21 @@ public:
     //------------------------------------------------------------
     UQLBTTaskInitializePatrol(const FObjectInitializer& ObjectInitializer);
 
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    virtual uint16 GetInstanceMemorySize() const override;
+
+    virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+
     //------------------------------------------------------------
     //------------------------------------------------------------
     virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+
+protected:
+    UPROPERTY(EditAnywhere, Category = "C++Property")
+    FBlackboardKeySelector PatrolLocationKey;
 };
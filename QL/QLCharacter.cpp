@@ -23,6 +23,7 @@
 #include "QLPowerupManager.h"
 #include "QLUtility.h"
 #include "QLPlayerController.h"
+#include "QLHUDViewModel.h"
 #include "Components/WidgetComponent.h"
 #include "QLPlayerController.h"
 #include "Materials/MaterialInstanceDynamic.h"
@@ -38,8 +39,115 @@
 #include "Classes/Perception/AISense_Hearing.h"
 #include "Classes/Perception/AISense_Prediction.h"
 #include "Classes/Perception/AISense_Damage.h"
+#include "QLGameModeBase.h"
+#include "QLTraceManager.h"
+#include "QLSpatialQueryManager.h"
+#include "QLDamageManager.h"
+#include "QLSpawnPointManager.h"
+#include "QLVisibilityManager.h"
 #include "Classes/Perception/AISense_Team.h"
 #include "NavigationSystem.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLViewTraceCache(
+    TEXT("ql.ViewTraceCache"),
+    1,
+    TEXT("1: view traces with the same range and channel from the same camera transform are performed once per frame.\n")
+    TEXT("0: every view trace is performed."),
+    ECVF_Default);
+
+//------------------------------------------------------------
+// Print the view trace cache counters of all characters
+//------------------------------------------------------------
+static void LogViewTraceCacheStats(UWorld* World)
+{
+    if (!World)
+    {
+        return;
+    }
+
+    int32 TotalHitCount = 0;
+    int32 TotalMissCount = 0;
+
+    for (TActorIterator<AQLCharacter> It(World); It; ++It)
+    {
+        TotalHitCount += It->GetViewTraceCacheHitCount();
+        TotalMissCount += It->GetViewTraceCacheMissCount();
+    }
+
+    const int32 Total = TotalHitCount + TotalMissCount;
+    const float HitRate = Total > 0 ? 100.0f * TotalHitCount / Total : 0.0f;
+
+    // the hits include the async requests merged in the same frame
+    QLUtility::Log(FString::Printf(TEXT("view trace cache: %d hits, %d misses (%.1f%% saved)"), TotalHitCount, TotalMissCount, HitRate));
+
+    UQLTraceManager* TraceManager = AQLGameModeBase::GetWorldService<UQLTraceManager>(World);
+    if (TraceManager)
+    {
+        QLUtility::Log(FString::Printf(TEXT("    of which async weapon traces merged in the same frame: %d"), TraceManager->GetCoalescedRequestCount()));
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLViewTraceCacheStatsCommand(
+    TEXT("ql.ViewTraceCacheStats"),
+    TEXT("Print how many view traces have been saved by the per-character view trace cache."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogViewTraceCacheStats));
+
+//------------------------------------------------------------
+// Respawn up to Count living bots at once and print the time it
+// took and the number of actors spawned. Recycle: 1 to recycle
+// the pawns, 0 to spawn new ones, default to bRecycleOnRespawn.
+//------------------------------------------------------------
+static void RunRespawnStorm(const TArray<FString>& Args, UWorld* World)
+{
+    if (!World)
+    {
+        return;
+    }
+
+    const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 16;
+    const int32 Recycle = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : -1;
+
+    TArray<AQLCharacter*> BotList;
+    for (TActorIterator<AQLCharacter> It(World); It && BotList.Num() < Count; ++It)
+    {
+        if (It->GetIsBot() && It->IsAlive() && !It->IsPendingKill())
+        {
+            BotList.Add(*It);
+        }
+    }
+
+    int32 SpawnedActorCount = 0;
+    FDelegateHandle ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateLambda([&SpawnedActorCount](AActor* Actor)
+    {
+        ++SpawnedActorCount;
+    }));
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    for (AQLCharacter* Bot : BotList)
+    {
+        Bot->Respawn(Recycle < 0 ? Bot->GetRecycleOnRespawn() : Recycle != 0);
+    }
+
+    const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+    World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+
+    QLUtility::Log(FString::Printf(TEXT("respawn storm: %d bots (%s) in %.2f ms, %d actors spawned"),
+        BotList.Num(),
+        Recycle == 0 ? TEXT("new pawns") : (Recycle > 0 ? TEXT("recycled pawns") : TEXT("default mode")),
+        ElapsedTime * 1000.0,
+        SpawnedActorCount));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs QLRespawnStormCommand(
+    TEXT("ql.RespawnStorm"),
+    TEXT("Respawn up to [Count] bots at once and print the hitch. [Recycle] 1: recycle the pawns, 0: spawn new pawns."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunRespawnStorm));
 
 //------------------------------------------------------------
 // Sets default values
@@ -99,6 +207,11 @@ AQLCharacter::AQLCharacter()
     PlayerHealthArmorBarWidgetComponent = CreateDefaultSubobject<UWidgetComponent>(TEXT("PlayerHealthArmorBarWidgetComponent"));
     PlayerHealthArmorBarWidgetComponent->SetupAttachment(GetCapsuleComponent());
     PlayerHealthArmorBarWidgetComponent->SetWidgetSpace(EWidgetSpace::Screen);
+    bDrawHealthArmorBarOnHUD = true;
+    HealthArmorBarHeightOffset = 30.0f;
+    bIsHealthArmorBarVisible = true;
+    SignificanceTier = EQLSignificanceTier::High;
+    bIsCustomDepthForced = false;
 
     // ai
     AIPerceptionStimuliSourceComponent = CreateDefaultSubobject<UAIPerceptionStimuliSourceComponent>(TEXT("AIPerceptionStimuliSourceComponent"));
@@ -109,6 +222,10 @@ AQLCharacter::AQLCharacter()
     bQLIsVisible = true;
     bQLIsVulnerable = true;
 
+    bHasQueuedDamage = false;
+    QueuedHealth = 0.0f;
+    QueuedArmor = 0.0f;
+
     bJumpButtonDown = false;
 
     bQLIsBot = false;
@@ -121,9 +238,16 @@ AQLCharacter::AQLCharacter()
 
     DurationAfterDeathBeforeDestroyed = 3.0f;
     DurationAfterDeathBeforeRespawn = 2.5f;
+    bRecycleOnRespawn = true;
 
     // movement
     GetCharacterMovement()->AirControl = 0.5;
+
+    ViewTraceCacheFrameNumber = 0;
+    ViewTraceCacheCameraLocation = FVector::ZeroVector;
+    ViewTraceCacheCameraRotation = FQuat::Identity;
+    ViewTraceCacheHitCount = 0;
+    ViewTraceCacheMissCount = 0;
 }
 
 //------------------------------------------------------------
@@ -135,6 +259,55 @@ void AQLCharacter::BeginPlay()
 
     UpdateHealth();
     UpdateArmor();
+
+    UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(this);
+    if (SpatialQueryManager)
+    {
+        SpatialQueryManager->RegisterCharacter(this);
+    }
+
+    UQLSignificanceManager* SignificanceManager = AQLGameModeBase::GetWorldService<UQLSignificanceManager>(this);
+    if (SignificanceManager)
+    {
+        SignificanceManager->RegisterCharacter(this);
+    }
+
+    UQLVisibilityManager* VisibilityManager = AQLGameModeBase::GetWorldService<UQLVisibilityManager>(this);
+    if (VisibilityManager)
+    {
+        VisibilityManager->RegisterCharacter(this);
+    }
+
+    UQLAudioManager* AudioManager = AQLGameModeBase::GetWorldService<UQLAudioManager>(this);
+    if (AudioManager)
+    {
+        AudioManager->ResolveSoundList(SoundList, nullptr, SoundHandleList);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(this);
+    if (SpatialQueryManager)
+    {
+        SpatialQueryManager->UnregisterCharacter(this);
+    }
+
+    UQLSignificanceManager* SignificanceManager = AQLGameModeBase::GetWorldService<UQLSignificanceManager>(this);
+    if (SignificanceManager)
+    {
+        SignificanceManager->UnregisterCharacter(this);
+    }
+
+    UQLVisibilityManager* VisibilityManager = AQLGameModeBase::GetWorldService<UQLVisibilityManager>(this);
+    if (VisibilityManager)
+    {
+        VisibilityManager->UnregisterCharacter(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 //------------------------------------------------------------
@@ -156,6 +329,13 @@ void AQLCharacter::PostInitializeComponents()
     PowerupManager = NewObject<UQLPowerupManager>(this);
     PowerupManager->SetUser(this);
 
+    // do not pay for a widget tree per character
+    if (bDrawHealthArmorBarOnHUD && PlayerHealthArmorBarWidgetComponent)
+    {
+        PlayerHealthArmorBarWidgetComponent->DestroyComponent();
+        PlayerHealthArmorBarWidgetComponent = nullptr;
+    }
+
     if (FirstPersonMesh)
     {
         UMaterialInterface* BasicMaterial = FirstPersonMesh->GetMaterial(0);
@@ -177,10 +357,16 @@ void AQLCharacter::PostInitializeComponents()
 //------------------------------------------------------------
 // Called every frame
 //------------------------------------------------------------
-//void AQLCharacter::Tick(float DeltaTime)
-//{
-//    Super::Tick(DeltaTime);
-//}
+void AQLCharacter::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    // fire scheduler
+    if (WeaponManager)
+    {
+        WeaponManager->Tick(DeltaTime);
+    }
+}
 
 //------------------------------------------------------------
 // Called to bind functionality to input
@@ -372,6 +558,12 @@ void AQLCharacter::AddHealth(float Increment)
         Health = Temp;
     }
 
+    // a pickup taken between a hit and its resolution counts toward the prediction
+    if (bHasQueuedDamage)
+    {
+        QueuedHealth = FMath::Min(QueuedHealth + Increment, MaxHealth);
+    }
+
     UpdateHealth();
 }
 
@@ -404,6 +596,12 @@ void AQLCharacter::AddArmor(float Increment)
         Armor = Temp;
     }
 
+    // a pickup taken between a hit and its resolution counts toward the prediction
+    if (bHasQueuedDamage)
+    {
+        QueuedArmor = FMath::Min(QueuedArmor + Increment, MaxArmor);
+    }
+
     UpdateArmor();
 }
 
@@ -523,8 +721,16 @@ void AQLCharacter::SetCurrentAbility(const FName& QLName)
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-FHitResult AQLCharacter::RayTraceFromCharacterPOV(float rayTraceRange)
+FHitResult AQLCharacter::RayTraceFromCharacterPOV(float rayTraceRange, ECollisionChannel TraceChannel)
 {
+    FHitResult hitResult(ForceInit);
+
+    // the same ray has already been traced in this frame
+    if (FindCachedViewTrace(rayTraceRange, TraceChannel, hitResult))
+    {
+        return hitResult;
+    }
+
     FCollisionQueryParams params(FName(TEXT("lineTrace")),
                                  true, // bTraceComplex
                                  this); // ignore actor
@@ -533,9 +739,8 @@ FHitResult AQLCharacter::RayTraceFromCharacterPOV(float rayTraceRange)
     FVector start = FirstPersonCameraComponent->GetComponentLocation();
     FVector end = FirstPersonCameraComponent->GetForwardVector() * rayTraceRange + start;
 
-    FHitResult hitResult(ForceInit);
-    // only hit the object that reponds to ray-trace, i.e. ECollisionChannel::ECC_Camera is set to ECollisionResponse::ECR_Block
-    GetWorld()->LineTraceSingleByChannel(hitResult, start, end, ECollisionChannel::ECC_Camera, params);
+    // by default, only hit the object that reponds to ray-trace, i.e. ECollisionChannel::ECC_Camera is set to ECollisionResponse::ECR_Block
+    GetWorld()->LineTraceSingleByChannel(hitResult, start, end, TraceChannel, params);
 
     // useful properties
     // hitResult.bBlockingHit  // did ray hit something
@@ -546,52 +751,143 @@ FHitResult AQLCharacter::RayTraceFromCharacterPOV(float rayTraceRange)
     // for debugging purpose
     // DrawDebugLine(GetWorld(), start, hitResult.ImpactPoint, FColor(255, 0, 0), true, -1, 0, 10);
 
+    AddViewTraceToCache(rayTraceRange, TraceChannel, hitResult);
+
     return hitResult;
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-float AQLCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+bool AQLCharacter::FindCachedViewTrace(float rayTraceRange, ECollisionChannel TraceChannel, FHitResult& OutHitResult)
 {
-    float ActualDamage = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
+    if (CVarQLViewTraceCache.GetValueOnGameThread() == 0)
+    {
+        return false;
+    }
 
-    // bot sense damage
-    if (GetIsBot())
+    if (IsViewTraceCacheValid())
     {
-        if (EventInstigator)
+        for (const auto& Entry : ViewTraceCacheList)
         {
-            auto* MyPawn = EventInstigator->GetPawn();
-            if (MyPawn)
+            if (Entry.TraceRange == rayTraceRange && Entry.TraceChannel == TraceChannel)
             {
-                auto* Enemy = Cast<AQLCharacter>(MyPawn);
-                if (Enemy)
-                {
-                    UAISense_Damage::ReportDamageEvent(
-                        GetWorld(),
-                        this, // AActor* DamagedActor
-                        Enemy, // AActor* Instigator: somehow this argument must be the player who initiates the damage, not the controller
-                        ActualDamage,
-                        Enemy->GetActorLocation(), // EventLocation: will be reported as Instigator's location at the moment of event happening
-                        GetActorLocation() // HitLocation
-                    );
-                }
+                OutHitResult = Entry.HitResult;
+                ++ViewTraceCacheHitCount;
+                return true;
             }
         }
     }
 
-    if (!bQLIsVulnerable)
+    ++ViewTraceCacheMissCount;
+    return false;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLCharacter::IsViewTraceCacheValid() const
+{
+    if (!FirstPersonCameraComponent || ViewTraceCacheFrameNumber != GFrameCounter)
+    {
+        return false;
+    }
+
+    // the camera may be turned within a frame, e.g. by a bot aiming at its target
+    return ViewTraceCacheCameraLocation == FirstPersonCameraComponent->GetComponentLocation() &&
+        ViewTraceCacheCameraRotation == FirstPersonCameraComponent->GetComponentQuat();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::AddViewTraceToCache(float rayTraceRange, ECollisionChannel TraceChannel, const FHitResult& HitResult)
+{
+    if (CVarQLViewTraceCache.GetValueOnGameThread() == 0 || !FirstPersonCameraComponent)
+    {
+        return;
+    }
+
+    // start over if the cache is built in a previous frame or from a different camera transform
+    if (!IsViewTraceCacheValid())
     {
-        return 0.0f;
+        ViewTraceCacheList.Reset();
+        ViewTraceCacheFrameNumber = GFrameCounter;
+        ViewTraceCacheCameraLocation = FirstPersonCameraComponent->GetComponentLocation();
+        ViewTraceCacheCameraRotation = FirstPersonCameraComponent->GetComponentQuat();
     }
 
-    // if the character is already dead, no further damage
-    if (Health <= 0.0f)
+    FQLViewTraceCacheEntry Entry;
+    Entry.TraceRange = rayTraceRange;
+    Entry.TraceChannel = TraceChannel;
+    Entry.HitResult = HitResult;
+    ViewTraceCacheList.Add(Entry);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::AddAsyncViewTraceToCache(const FVector& CameraLocation, const FQuat& CameraRotation, float rayTraceRange, ECollisionChannel TraceChannel, const FHitResult& HitResult)
+{
+    if (!FirstPersonCameraComponent)
+    {
+        return;
+    }
+
+    // the result comes in a later frame, it only stands for a camera that has not moved
+    if (CameraLocation == FirstPersonCameraComponent->GetComponentLocation() &&
+        CameraRotation == FirstPersonCameraComponent->GetComponentQuat())
     {
-        return 0.0f;
+        AddViewTraceToCache(rayTraceRange, TraceChannel, HitResult);
     }
+}
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::CountViewTraceCacheHit()
+{
+    ++ViewTraceCacheHitCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 AQLCharacter::GetViewTraceCacheHitCount() const
+{
+    return ViewTraceCacheHitCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 AQLCharacter::GetViewTraceCacheMissCount() const
+{
+    return ViewTraceCacheMissCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float AQLCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+{
+    float ActualDamage = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
+
+    FQLDamageEvent QLDamageEvent;
+    QLDamageEvent.Victim = this;
+    QLDamageEvent.EventInstigator = EventInstigator;
+    QLDamageEvent.DamageCauser = DamageCauser;
+    QLDamageEvent.SensedDamage = ActualDamage;
+    QLDamageEvent.SequenceNumber = 0;
+
+    // bot sense damage
+    // somehow the instigator reported to the perception must be the player who initiates the damage, not the controller
+    if (GetIsBot() && EventInstigator)
+    {
+        QLDamageEvent.Enemy = Cast<AQLCharacter>(EventInstigator->GetPawn());
+    }
+
+    // if the character is already dead, or will be once the hits queued
+    // in the current frame are resolved, no further damage, so that no
+    // damage number is shown for a hit ResolveDamage() is going to ignore
+    if (!bQLIsVulnerable || Health <= 0.0f || (bHasQueuedDamage && QueuedHealth <= 0.0f))
+    {
+        ActualDamage = 0.0f;
+    }
     // handle point damage
-    if (DamageEvent.GetTypeID() == FPointDamageEvent::ClassID)
+    else if (DamageEvent.GetTypeID() == FPointDamageEvent::ClassID)
     {
         // adjust damage according to ProtectionMultiplier
         ActualDamage *= ProtectionMultiplier;
@@ -620,26 +916,144 @@ float AQLCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEve
         }
     }
 
-    if (ActualDamage > 0.0f)
+    QLDamageEvent.Damage = ActualDamage;
+
+    if (QLDamageEvent.Damage > 0.0f)
     {
-        TakeDamageQuakeStyle(ActualDamage);
+        if (!bHasQueuedDamage)
+        {
+            QueuedHealth = Health;
+            QueuedArmor = Armor;
+            bHasQueuedDamage = true;
+        }
 
-        UpdateArmor();
+        ApplyDamageQuakeStyle(QLDamageEvent.Damage, QueuedHealth, QueuedArmor);
+    }
 
-        UpdateHealth();
+    if (QLDamageEvent.Damage > 0.0f || QLDamageEvent.Enemy.IsValid())
+    {
+        UQLDamageManager* DamageManager = AQLGameModeBase::GetWorldService<UQLDamageManager>(this);
+        if (DamageManager)
+        {
+            DamageManager->QueueDamage(QLDamageEvent);
+        }
+        else
+        {
+            ResolveDamage(TArrayView<const FQLDamageEvent>(&QLDamageEvent, 1));
+        }
+    }
+
+    return ActualDamage;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::ResolveDamage(const TArrayView<const FQLDamageEvent>& EventList)
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    AQLGameModeBase* QLGameMode = World->GetAuthGameMode<AQLGameModeBase>();
+
+    const FQLDamageEvent* FatalEvent = nullptr;
+    bool bDamaged = false;
+
+    // damage sensed by the bot, summed per enemy
+    TArray<TPair<AQLCharacter*, float>, TInlineAllocator<4>> SensedDamageList;
+
+    for (const FQLDamageEvent& Event : EventList)
+    {
+        AQLCharacter* Enemy = Event.Enemy.Get();
+        if (Enemy)
+        {
+            auto* SensedDamage = SensedDamageList.FindByPredicate([Enemy](const TPair<AQLCharacter*, float>& Item)
+            {
+                return Item.Key == Enemy;
+            });
+
+            if (SensedDamage)
+            {
+                SensedDamage->Value += Event.SensedDamage;
+            }
+            else
+            {
+                SensedDamageList.Add(TPair<AQLCharacter*, float>(Enemy, Event.SensedDamage));
+            }
+        }
+
+        // already killed, possibly by an earlier hit of the list
+        if (Event.Damage <= 0.0f || Health <= 0.0f)
+        {
+            continue;
+        }
+
+        TakeDamageQuakeStyle(Event.Damage);
+        bDamaged = true;
+
+        if (QLGameMode)
+        {
+            QLGameMode->NotifyCharacterDamaged(this, Event.Damage, Event.EventInstigator.Get(), Event.DamageCauser.Get());
+        }
 
         if (Health <= 0.0f)
         {
-            Die();
+            FatalEvent = &Event;
         }
     }
 
-    return ActualDamage;
+    // the hits taken from now on are predicted from the resolved health and armor
+    bHasQueuedDamage = false;
+
+    for (const auto& Item : SensedDamageList)
+    {
+        UAISense_Damage::ReportDamageEvent(
+            World,
+            this, // AActor* DamagedActor
+            Item.Key, // AActor* Instigator
+            Item.Value,
+            Item.Key->GetActorLocation(), // EventLocation: will be reported as Instigator's location at the moment of event happening
+            GetActorLocation() // HitLocation
+        );
+    }
+
+    // the damage sense is only processed on the next perception update
+    AQLAIController* MyQLAIController = Cast<AQLAIController>(GetController());
+    if (MyQLAIController && SensedDamageList.Num() > 0)
+    {
+        MyQLAIController->NotifyTookDamage();
+    }
+
+    if (bDamaged)
+    {
+        UpdateArmor();
+
+        UpdateHealth();
+    }
+
+    if (FatalEvent)
+    {
+        if (QLGameMode)
+        {
+            QLGameMode->NotifyCharacterKilled(this, FatalEvent->EventInstigator.Get(), FatalEvent->DamageCauser.Get());
+        }
+
+        Die();
+    }
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLCharacter::TakeDamageQuakeStyle(float ActualDamage)
+{
+    ApplyDamageQuakeStyle(ActualDamage, Health, Armor);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::ApplyDamageQuakeStyle(float ActualDamage, float& InOutHealth, float& InOutArmor)
 {
     if (ActualDamage > 0.0f)
     {
@@ -649,26 +1063,26 @@ void AQLCharacter::TakeDamageQuakeStyle(float ActualDamage)
         float ArmorDamage = ArmorAbsorbingFraction * ActualDamage;
 
         // calculate armor
-        float RemainingAmor = Armor - ArmorDamage;
+        float RemainingAmor = InOutArmor - ArmorDamage;
         if (RemainingAmor < 0.0f)
         {
             HealthDamage -= RemainingAmor;
-            Armor = 0.0f;
+            InOutArmor = 0.0f;
         }
         else
         {
-            Armor = RemainingAmor;
+            InOutArmor = RemainingAmor;
         }
 
         // calculate health
-        float RemainingHealth = Health - HealthDamage;
+        float RemainingHealth = InOutHealth - HealthDamage;
         if (RemainingHealth < 0.0f)
         {
-            Health = 0.0f;
+            InOutHealth = 0.0f;
         }
         else
         {
-            Health = RemainingHealth;
+            InOutHealth = RemainingHealth;
         }
     }
 }
@@ -677,12 +1091,64 @@ void AQLCharacter::TakeDamageQuakeStyle(float ActualDamage)
 //------------------------------------------------------------
 void AQLCharacter::SetHealthArmorBarVisible(bool bFlag)
 {
+    bIsHealthArmorBarVisible = bFlag;
+
     if (PlayerHealthArmorBarWidgetComponent)
     {
-        PlayerHealthArmorBarWidgetComponent->SetVisibility(bFlag);
+        const bool bShowAtTier = UQLSignificanceManager::GetTierSettings(SignificanceTier).bShowHealthArmorBar;
+        PlayerHealthArmorBarWidgetComponent->SetVisibility(bFlag && bShowAtTier);
     }
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLCharacter::ShouldDrawHealthArmorBarOnHUD() const
+{
+    return bDrawHealthArmorBarOnHUD
+        && bIsHealthArmorBarVisible
+        && Health > 0.0f
+        && UQLSignificanceManager::GetTierSettings(SignificanceTier).bShowHealthArmorBar;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::SetSignificanceTier(EQLSignificanceTier Tier, bool bForceCustomDepth)
+{
+    if (SignificanceTier == Tier && bIsCustomDepthForced == bForceCustomDepth)
+    {
+        return;
+    }
+
+    SignificanceTier = Tier;
+    bIsCustomDepthForced = bForceCustomDepth;
+
+    const FQLSignificanceSettings& Settings = UQLSignificanceManager::GetTierSettings(Tier);
+
+    if (ThirdPersonMesh)
+    {
+        ThirdPersonMesh->VisibilityBasedAnimTickOption = Settings.AnimTickOption;
+        ThirdPersonMesh->SetComponentTickInterval(Settings.AnimTickInterval);
+        ThirdPersonMesh->SetRenderCustomDepth(Settings.bRenderCustomDepth || bForceCustomDepth);
+    }
+
+    SetHealthArmorBarVisible(bIsHealthArmorBarVisible);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+EQLSignificanceTier AQLCharacter::GetSignificanceTier() const
+{
+    return SignificanceTier;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FVector AQLCharacter::GetHealthArmorBarLocation() const
+{
+    float HalfHeight = GetCapsuleComponent() ? GetCapsuleComponent()->GetScaledCapsuleHalfHeight() : 0.0f;
+    return GetActorLocation() + FVector(0.0f, 0.0f, HalfHeight + HealthArmorBarHeightOffset);
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLCharacter::UpdateHealth()
@@ -706,7 +1172,7 @@ void AQLCharacter::UpdateHealth()
     AQLPlayerController* QLPlayerController = Cast<AQLPlayerController>(GetController());
     if (QLPlayerController)
     {
-        QLPlayerController->GetUMG()->UpdateTextHealthValue(Health);
+        QLPlayerController->GetHUDViewModel()->SetHealth(Health);
     }
 }
 
@@ -733,7 +1199,7 @@ void AQLCharacter::UpdateArmor()
     AQLPlayerController* QLPlayerController = Cast<AQLPlayerController>(GetController());
     if (QLPlayerController)
     {
-        QLPlayerController->GetUMG()->UpdateTextArmorValue(Armor);
+        QLPlayerController->GetHUDViewModel()->SetArmor(Armor);
     }
 }
 
@@ -822,7 +1288,21 @@ void AQLCharacter::Die()
 {
     if (WeaponManager)
     {
-        WeaponManager->DestroyAllWeapon();
+        if (bRecycleOnRespawn)
+        {
+            // the weapons are kept for the next life
+            AQLWeapon* CurrentWeapon = WeaponManager->GetCurrentWeapon();
+            if (CurrentWeapon)
+            {
+                CurrentWeapon->StopFire();
+            }
+
+            WeaponManager->SetCurrentWeaponVisibility(false);
+        }
+        else
+        {
+            WeaponManager->DestroyAllWeapon();
+        }
     }
 
     UAnimSequence* Animation = PlayAnimationSequence("Death1");
@@ -830,22 +1310,31 @@ void AQLCharacter::Die()
     // get animation length
     // float ActualAnimationLength = Animation->SequenceLength / Animation->RateScale;
 
-    PlaySoundFireAndForget(FName(TEXT("Die")));
+    PlaySoundFireAndForget(FName(TEXT("Die")), EQLSoundCategory::Voice);
+
+    // keep the next spawns away from here
+    UQLSpawnPointManager* SpawnPointManager = AQLGameModeBase::GetWorldService<UQLSpawnPointManager>(this);
+    if (SpawnPointManager)
+    {
+        SpawnPointManager->AddDeathLocation(GetActorLocation());
+    }
 
     // avoid blocking living characters
     GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
     ThirdPersonMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
 
     // destroy the character
-    GetWorldTimerManager().SetTimer(DieTimerHandle,
-        this,
-        &AQLCharacter::OnDie,
-        1.0f, // time interval in second
-        false, // loop
-        DurationAfterDeathBeforeDestroyed); // delay in second
+    if (!bRecycleOnRespawn)
+    {
+        GetWorldTimerManager().SetTimer(DieTimerHandle,
+            this,
+            &AQLCharacter::OnDie,
+            1.0f, // time interval in second
+            false, // loop
+            DurationAfterDeathBeforeDestroyed); // delay in second
+    }
 
     // respawn the character
-    constexpr float DurationBeforeRespawn = 2.0f;
     GetWorldTimerManager().SetTimer(RespawnTimerHandle,
         this,
         &AQLCharacter::OnRespawnNewCharacter,
@@ -853,22 +1342,81 @@ void AQLCharacter::Die()
         false, // loop
         DurationAfterDeathBeforeRespawn); // delay in second
 
-    // prevent dead character from still being controlled
-    DetachFromControllerPendingDestroy();
+    // a recycled bot keeps its controller, whose logic is paused until the respawn
+    AAIController* MyAIController = Cast<AAIController>(GetController());
+    if (bRecycleOnRespawn && MyAIController)
+    {
+        if (MyAIController->GetBrainComponent())
+        {
+            MyAIController->GetBrainComponent()->StopLogic(TEXT("Dead"));
+        }
+    }
+    else
+    {
+        // prevent dead character from still being controlled
+        DetachFromControllerPendingDestroy();
+    }
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLCharacter::OnDie()
 {
+    DestroyEquipment();
     Destroy();
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::DestroyEquipment()
+{
+    if (WeaponManager)
+    {
+        WeaponManager->DestroyAllWeapon();
+    }
+
+    if (AbilityManager)
+    {
+        AbilityManager->DestroyAllAbilities();
+    }
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLCharacter::OnRespawnNewCharacter()
 {
-    RespawnCharacterRandomly();
+    Respawn(bRecycleOnRespawn);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::Respawn(bool bRecycle)
+{
+    if (bRecycle)
+    {
+        RecycleCharacter();
+    }
+    else
+    {
+        RespawnCharacterRandomly();
+
+        // the new character takes over
+        GetWorldTimerManager().ClearTimer(RespawnTimerHandle);
+        if (!GetWorldTimerManager().IsTimerActive(DieTimerHandle))
+        {
+            // still alive, e.g. ql.RespawnStorm, tear down as Die() and OnDie() do
+            DestroyEquipment();
+            DetachFromControllerPendingDestroy();
+            Destroy();
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLCharacter::GetRecycleOnRespawn() const
+{
+    return bRecycleOnRespawn;
 }
 
 //------------------------------------------------------------
@@ -1004,6 +1552,13 @@ bool AQLCharacter::IsAlive()
     }
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLCharacter::IsDoomed() const
+{
+    return Health <= 0.0f || (bHasQueuedDamage && QueuedHealth <= 0.0f);
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLCharacter::OnUseAbility()
@@ -1022,8 +1577,19 @@ void AQLCharacter::OnUseAbility()
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void AQLCharacter::PlaySoundFireAndForget(const FName& SoundName)
+void AQLCharacter::PlaySoundFireAndForget(const FName& SoundName, EQLSoundCategory SoundCategory)
 {
+    UQLAudioManager* AudioManager = AQLGameModeBase::GetWorldService<UQLAudioManager>(this);
+    if (AudioManager)
+    {
+        const FQLSoundHandle* SoundHandle = SoundHandleList.Find(SoundName);
+        if (SoundHandle)
+        {
+            AudioManager->PlaySoundAtLocation(*SoundHandle, GetActorLocation(), SoundCategory);
+        }
+        return;
+    }
+
     USoundBase** Result = SoundList.Find(SoundName);
     if (Result)
     {
@@ -1183,24 +1749,70 @@ void AQLCharacter::EquipAll()
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void AQLCharacter::RespawnCharacterRandomly()
+void AQLCharacter::EquipAllPrecreated(const TArray<AQLWeapon*>& NewWeaponList, const TArray<AQLAbility*>& NewAbilityList)
 {
+    if (WeaponManager)
+    {
+        WeaponManager->AddAllWeapons(NewWeaponList);
+    }
+
+    if (AbilityManager)
+    {
+        AbilityManager->AddAllAbilities(NewAbilityList);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+const TArray<TSoftClassPtr<AQLWeapon>>& AQLCharacter::GetWeaponClassList() const
+{
+    return WeaponClassList;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+const TArray<TSoftClassPtr<AQLAbility>>& AQLCharacter::GetAbilityClassList() const
+{
+    return AbilityClassList;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLCharacter::FindRespawnTransform(FTransform& OutTransform)
+{
+    UQLSpawnPointManager* SpawnPointManager = AQLGameModeBase::GetWorldService<UQLSpawnPointManager>(this);
+    if (SpawnPointManager && SpawnPointManager->GetSpawnTransform(OutTransform))
+    {
+        return true;
+    }
+
     UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+    if (!NavSys)
+    {
+        return false;
+    }
 
-    if (NavSys)
+    FNavLocation RandomLocation;
+    bool bFound = NavSys->GetRandomPoint(RandomLocation);
+    if (!bFound)
     {
-        FNavLocation RandomLocation;
-        bool bFound = NavSys->GetRandomPoint(RandomLocation);
-        if (!bFound)
-        {
-            return;
-        }
-        RandomLocation.Location.Z += 100.0f;
+        return false;
+    }
+    RandomLocation.Location.Z += 100.0f;
 
-        FRotator RandomYawRotation = FRotator(0.0f, FMath::RandRange(0.0f, 360.0f), 0.0f);
+    FRotator RandomYawRotation = FRotator(0.0f, QLUtility::RandRange(0.0f, 360.0f), 0.0f);
 
-        FTransform RandomTransform(RandomYawRotation, RandomLocation.Location, FVector(1.0f));
+    OutTransform = FTransform(RandomYawRotation, RandomLocation.Location, FVector(1.0f));
+    return true;
+}
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::RespawnCharacterRandomly()
+{
+    FTransform RandomTransform;
+    if (FindRespawnTransform(RandomTransform))
+    {
         // deferred spawn in order to timely specify human/bot identity
         AQLCharacter* NewCharacter = GetWorld()->SpawnActorDeferred<AQLCharacter>(GetClass(), RandomTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
         if (bQLIsBot)
@@ -1222,6 +1834,87 @@ void AQLCharacter::RespawnCharacterRandomly()
     }
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLCharacter::RecycleCharacter()
+{
+    FTransform RespawnTransform;
+    if (!FindRespawnTransform(RespawnTransform))
+    {
+        return;
+    }
+
+    GetWorldTimerManager().ClearTimer(DieTimerHandle);
+    GetWorldTimerManager().ClearTimer(RespawnTimerHandle);
+
+    const AQLCharacter* DefaultCharacter = GetClass()->GetDefaultObject<AQLCharacter>();
+
+    // undo the effects of the powerups and of the abilities in use, and reset the cooldowns
+    if (PowerupManager)
+    {
+        PowerupManager->RemoveAllPowerups();
+    }
+
+    if (AbilityManager)
+    {
+        AbilityManager->ResetAllAbilities();
+    }
+
+    Health = DefaultCharacter->Health;
+    Armor = DefaultCharacter->Armor;
+
+    // collision responses changed by Die()
+    GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn,
+        DefaultCharacter->GetCapsuleComponent()->GetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn));
+    ThirdPersonMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn,
+        DefaultCharacter->ThirdPersonMesh->GetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn));
+
+    // back from the death animation to the animation blueprint
+    ThirdPersonMesh->SetAnimationMode(DefaultCharacter->ThirdPersonMesh->GetAnimationMode());
+
+    UCharacterMovementComponent* CharacterMovementComponent = GetCharacterMovement();
+    if (CharacterMovementComponent)
+    {
+        CharacterMovementComponent->bOrientRotationToMovement = DefaultCharacter->GetCharacterMovement()->bOrientRotationToMovement;
+        CharacterMovementComponent->StopMovementImmediately();
+    }
+
+    SetActorLocationAndRotation(RespawnTransform.GetLocation(),
+        RespawnTransform.GetRotation(),
+        false, // sweep
+        nullptr, // hit result
+        ETeleportType::TeleportPhysics);
+
+    if (WeaponManager)
+    {
+        WeaponManager->SetCurrentWeaponVisibility(bQLIsVisible);
+    }
+
+    if (bQLIsBot)
+    {
+        AAIController* MyAIController = Cast<AAIController>(GetController());
+        if (!MyAIController)
+        {
+            SpawnDefaultController();
+        }
+        else if (MyAIController->GetBrainComponent())
+        {
+            MyAIController->GetBrainComponent()->RestartLogic();
+        }
+    }
+    else
+    {
+        APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+        if (PlayerController && PlayerController->GetPawn() != this)
+        {
+            PlayerController->Possess(this);
+        }
+    }
+
+    UpdateHealth();
+    UpdateArmor();
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLCharacter::FellOutOfWorld(const UDamageType& dmgType)
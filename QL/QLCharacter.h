@@ -14,6 +14,8 @@
 #include "GameFramework/Character.h"
 #include "QLPlayerHealthArmorBarUserWidget.h"
 #include "Components/TimelineComponent.h"
+#include "QLAudioManager.h"
+#include "QLSignificanceManager.h"
 #include "QLCharacter.generated.h"
 
 class AQLWeapon;
@@ -23,6 +25,20 @@ class UQLAbilityManager;
 class UWidgetComponent;
 class UQLPowerupManager;
 class UAIPerceptionStimuliSourceComponent;
+struct FQLDamageEvent;
+
+//------------------------------------------------------------
+// A view trace performed in the current frame, see
+// AQLCharacter::RayTraceFromCharacterPOV()
+//------------------------------------------------------------
+struct FQLViewTraceCacheEntry
+{
+    float TraceRange;
+
+    ECollisionChannel TraceChannel;
+
+    FHitResult HitResult;
+};
 
 //------------------------------------------------------------
 // In Blueprint,
@@ -49,10 +65,44 @@ public:
     AQLCharacter();
 
     // Called every frame
-    // virtual void Tick(float DeltaTime) override;
+    virtual void Tick(float DeltaTime) override;
+
+    //------------------------------------------------------------
+    // Ray trace along the first person camera. The result is cached
+    // for the rest of the frame, so that subsequent traces with the
+    // same range and channel from the same camera transform are free.
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    FHitResult RayTraceFromCharacterPOV(float rayTraceRange = 1e5f, ECollisionChannel TraceChannel = ECC_Camera);
+
+    //------------------------------------------------------------
+    // Return true and fill OutHitResult if a view trace with the same
+    // range and channel has been performed in the current frame
+    // from the current camera transform
+    //------------------------------------------------------------
+    bool FindCachedViewTrace(float rayTraceRange, ECollisionChannel TraceChannel, FHitResult& OutHitResult);
+
+    //------------------------------------------------------------
+    // Cache the result of an async view trace requested from the
+    // given camera transform, if the camera has not moved since
+    //------------------------------------------------------------
+    void AddAsyncViewTraceToCache(const FVector& CameraLocation, const FQuat& CameraRotation, float rayTraceRange, ECollisionChannel TraceChannel, const FHitResult& HitResult);
+
+    //------------------------------------------------------------
+    // Count a view trace saved outside of the cache, e.g. an async
+    // request merged into an identical one, see UQLTraceManager
+    //------------------------------------------------------------
+    void CountViewTraceCacheHit();
+
+    //------------------------------------------------------------
+    // Number of view traces saved / performed, on the synchronous
+    // and the async path alike
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    int32 GetViewTraceCacheHitCount() const;
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
-    FHitResult RayTraceFromCharacterPOV(float rayTraceRange = 1e5f);
+    int32 GetViewTraceCacheMissCount() const;
 
     // Returns FirstPersonMesh subobject
     UFUNCTION(BlueprintCallable, Category = "C++Function")
@@ -68,11 +118,47 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void SetHealthArmorBarVisible(bool bFlag);
 
+    //------------------------------------------------------------
+    // True if AQLHUD draws the health and armor bar of the
+    // character, instead of the widget component
+    //------------------------------------------------------------
+    bool ShouldDrawHealthArmorBarOnHUD() const;
+
+    FVector GetHealthArmorBarLocation() const;
+
+    //------------------------------------------------------------
+    // Set by UQLSignificanceManager. Adjust the animation tick,
+    // custom depth, health and armor bar, behavior tree tick and
+    // perception senses of the bot to the tier.
+    //------------------------------------------------------------
+    void SetSignificanceTier(EQLSignificanceTier Tier, bool bForceCustomDepth);
+
+    EQLSignificanceTier GetSignificanceTier() const;
+
+    //------------------------------------------------------------
+    // Compute the damage of the hit and queue it in UQLDamageManager,
+    // or resolve it right away when the world has no damage queue.
+    // Return 0 if the character is dead or will be killed by the
+    // hits already queued, since ResolveDamage() ignores the hit.
+    //------------------------------------------------------------
     virtual float TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
+    //------------------------------------------------------------
+    // Apply the hits taken since the last resolution, in order:
+    // armor and health, one damage report per enemy if this is a bot,
+    // one refresh of the health bar and the HUD, and the death check.
+    // The hits following the fatal one are ignored.
+    //------------------------------------------------------------
+    void ResolveDamage(const TArrayView<const FQLDamageEvent>& EventList);
+
     UFUNCTION()
     void TakeDamageQuakeStyle(float ActualDamage);
 
+    //------------------------------------------------------------
+    // Split the damage between armor and health, as TakeDamageQuakeStyle()
+    //------------------------------------------------------------
+    static void ApplyDamageQuakeStyle(float ActualDamage, float& InOutHealth, float& InOutArmor);
+
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void UpdateHealth();
 
@@ -109,12 +195,24 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void OnDie();
 
+    //------------------------------------------------------------
+    // Destroy the weapon and ability actors, before the character
+    // itself is destroyed
+    //------------------------------------------------------------
+    void DestroyEquipment();
+
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void OnRespawnNewCharacter();
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     bool IsAlive();
 
+    //------------------------------------------------------------
+    // Whether the character is dead, or will be once the hits queued
+    // in UQLDamageManager are resolved at the end of the frame
+    //------------------------------------------------------------
+    bool IsDoomed() const;
+
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     float GetHealth() const;
 
@@ -227,6 +325,16 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void EquipAll();
 
+    //------------------------------------------------------------
+    // Same as EquipAll(), with weapons and abilities spawned ahead
+    // of the character, see AQLAIHelper
+    //------------------------------------------------------------
+    void EquipAllPrecreated(const TArray<AQLWeapon*>& NewWeaponList, const TArray<AQLAbility*>& NewAbilityList);
+
+    const TArray<TSoftClassPtr<AQLWeapon>>& GetWeaponClassList() const;
+
+    const TArray<TSoftClassPtr<AQLAbility>>& GetAbilityClassList() const;
+
     virtual void FellOutOfWorld(const UDamageType& dmgType) override;
 protected:
 
@@ -260,6 +368,8 @@ protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
 
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     virtual void PostInitializeComponents() override;
 
     // Called to bind functionality to input
@@ -302,7 +412,7 @@ protected:
     void OnUseAbility();
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
-    void PlaySoundFireAndForget(const FName& SoundName);
+    void PlaySoundFireAndForget(const FName& SoundName, EQLSoundCategory SoundCategory = EQLSoundCategory::Default);
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void PlaySound(const FName& SoundName);
@@ -312,10 +422,42 @@ protected:
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void RespawnCharacterRandomly();
+
+    //------------------------------------------------------------
+    // Reset health, armor, powerups, abilities, collision and
+    // animation, and teleport the character to a respawn location.
+    // The weapons, abilities, dynamic materials and controller are
+    // kept, so that no actor is spawned.
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    void RecycleCharacter();
+
+    //------------------------------------------------------------
+    // Recycle the character, or spawn a new one and destroy this one
+    //------------------------------------------------------------
+    void Respawn(bool bRecycle);
+
+    bool GetRecycleOnRespawn() const;
 protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "C++Property")
     UWidgetComponent* PlayerHealthArmorBarWidgetComponent;
 
+    // the bar is drawn by AQLHUD together with the bars of the other characters,
+    // and the widget component is destroyed. uncheck to keep the widget component.
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "C++Property")
+    bool bDrawHealthArmorBarOnHUD;
+
+    // height of the bar above the capsule
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "C++Property")
+    float HealthArmorBarHeightOffset;
+
+    UPROPERTY()
+    bool bIsHealthArmorBarVisible;
+
+    EQLSignificanceTier SignificanceTier;
+
+    bool bIsCustomDepthForced;
+
     UPROPERTY()
     UQLWeaponManager* WeaponManager;
 
@@ -344,11 +486,15 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     TMap<FName, USoundBase*> SoundList;
 
+    // SoundList resolved by the audio manager
+    TMap<FName, FQLSoundHandle> SoundHandleList;
+
+    // loaded by UQLAssetPreloadManager while the map loads
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
-    TArray<TSubclassOf<AQLWeapon>> WeaponClassList;
+    TArray<TSoftClassPtr<AQLWeapon>> WeaponClassList;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
-    TArray<TSubclassOf<AQLAbility>> AbilityClassList;
+    TArray<TSoftClassPtr<AQLAbility>> AbilityClassList;
 
     UPROPERTY()
     bool bCanFireAndAltFire;
@@ -365,6 +511,13 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     bool bQLIsVulnerable;
 
+    // health and armor once the hits queued in UQLDamageManager are resolved
+    bool bHasQueuedDamage;
+
+    float QueuedHealth;
+
+    float QueuedArmor;
+
     // monitor jump status for animation purpose
     UPROPERTY()
     bool bJumpButtonDown;
@@ -377,4 +530,32 @@ protected:
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     float DurationAfterDeathBeforeRespawn;
+
+    // respawn by resetting and teleporting the dead character instead of spawning a new one
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    bool bRecycleOnRespawn;
+
+    bool FindRespawnTransform(FTransform& OutTransform);
+
+    //------------------------------------------------------------
+    // Return true if the view trace cache was built in the current
+    // frame from the current camera transform
+    //------------------------------------------------------------
+    bool IsViewTraceCacheValid() const;
+
+    void AddViewTraceToCache(float rayTraceRange, ECollisionChannel TraceChannel, const FHitResult& HitResult);
+
+    // view traces performed in the current frame
+    TArray<FQLViewTraceCacheEntry> ViewTraceCacheList;
+
+    // key of the view trace cache
+    uint64 ViewTraceCacheFrameNumber;
+
+    FVector ViewTraceCacheCameraLocation;
+
+    FQuat ViewTraceCacheCameraRotation;
+
+    int32 ViewTraceCacheHitCount;
+
+    int32 ViewTraceCacheMissCount;
 };
@@ -0,0 +1,159 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLDamageManager.h"
+#include "QLGameModeBase.h"
+#include "QLCharacter.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+//------------------------------------------------------------
+// Print the counters of the damage queue of the world
+//------------------------------------------------------------
+static void LogDamageStats(UWorld* World)
+{
+    UQLDamageManager* DamageManager = AQLGameModeBase::GetWorldService<UQLDamageManager>(World);
+    if (DamageManager)
+    {
+        DamageManager->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLDamageStatsCommand(
+    TEXT("ql.DamageStats"),
+    TEXT("Print the number of hits queued and of victims resolved by the damage queue."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogDamageStats));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLDamageManager::UQLDamageManager() :
+NextSequenceNumber(0),
+QueuedCount(0),
+ResolvedVictimCount(0),
+FlushCount(0)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDamageManager::Initialize()
+{
+    Super::Initialize();
+
+    // resolve once the weapons and projectiles have hit, i.e. after the actors have ticked
+    PostActorTickDelegateHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UQLDamageManager::OnWorldPostActorTick);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDamageManager::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickDelegateHandle);
+
+    PendingEventList.Empty();
+    ResolvingEventList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDamageManager::QueueDamage(const FQLDamageEvent& DamageEvent)
+{
+    const int32 Index = PendingEventList.Add(DamageEvent);
+    PendingEventList[Index].SequenceNumber = NextSequenceNumber++;
+
+    ++QueuedCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDamageManager::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    if (World != GetWorld())
+    {
+        return;
+    }
+
+    Flush();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDamageManager::Flush()
+{
+    if (PendingEventList.Num() == 0)
+    {
+        return;
+    }
+
+    Swap(PendingEventList, ResolvingEventList);
+    PendingEventList.Reset();
+
+    // group the hits by victim, victims in the order of their first hit
+    // the queue is already in sequence order
+    TMap<AQLCharacter*, int32> VictimOrderMap;
+    for (const FQLDamageEvent& Event : ResolvingEventList)
+    {
+        AQLCharacter* Victim = Event.Victim.Get();
+        if (!VictimOrderMap.Contains(Victim))
+        {
+            VictimOrderMap.Add(Victim, VictimOrderMap.Num());
+        }
+    }
+
+    ResolvingEventList.Sort([&VictimOrderMap](const FQLDamageEvent& A, const FQLDamageEvent& B)
+    {
+        const int32 VictimOrderA = VictimOrderMap.FindRef(A.Victim.Get());
+        const int32 VictimOrderB = VictimOrderMap.FindRef(B.Victim.Get());
+        if (VictimOrderA != VictimOrderB)
+        {
+            return VictimOrderA < VictimOrderB;
+        }
+
+        return A.SequenceNumber < B.SequenceNumber;
+    });
+
+    // one pass per victim
+    int32 FirstIndex = 0;
+    while (FirstIndex < ResolvingEventList.Num())
+    {
+        AQLCharacter* Victim = ResolvingEventList[FirstIndex].Victim.Get();
+
+        int32 EndIndex = FirstIndex + 1;
+        while (EndIndex < ResolvingEventList.Num() && ResolvingEventList[EndIndex].Victim.Get() == Victim)
+        {
+            ++EndIndex;
+        }
+
+        if (Victim && !Victim->IsPendingKill())
+        {
+            Victim->ResolveDamage(TArrayView<const FQLDamageEvent>(ResolvingEventList.GetData() + FirstIndex, EndIndex - FirstIndex));
+            ++ResolvedVictimCount;
+        }
+
+        FirstIndex = EndIndex;
+    }
+
+    ResolvingEventList.Reset();
+    ++FlushCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDamageManager::LogStats() const
+{
+    QLUtility::Log(FString::Printf(TEXT("damage queue: %d hits queued, %d victims resolved in %d frames"),
+        QueuedCount,
+        ResolvedVictimCount,
+        FlushCount));
+}
@@ -0,0 +1,93 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "QLWorldService.h"
+#include "QLDamageManager.generated.h"
+
+class AQLCharacter;
+class AController;
+
+//------------------------------------------------------------
+// A hit taken by a character, waiting to be resolved
+//------------------------------------------------------------
+struct FQLDamageEvent
+{
+    TWeakObjectPtr<AQLCharacter> Victim;
+
+    TWeakObjectPtr<AController> EventInstigator;
+
+    TWeakObjectPtr<AActor> DamageCauser;
+
+    // character reported to the perception of a bot victim
+    TWeakObjectPtr<AQLCharacter> Enemy;
+
+    // damage applied to armor and health, after protection and falloff
+    float Damage;
+
+    // damage reported to the perception of a bot victim
+    float SensedDamage;
+
+    // order in which the hits were taken
+    int32 SequenceNumber;
+};
+
+//------------------------------------------------------------
+// Per-frame queue of the damage taken by the characters.
+// AQLCharacter::TakeDamage() only computes the damage of the hit
+// and queues it. Once the actors have ticked, the hits are
+// resolved in one pass per victim: armor and health math, one
+// damage report per enemy for the bots, one refresh of the health
+// bar and the HUD, and the death check. The victims are resolved
+// in the order of their first hit, and the hits of a victim in the
+// order they were taken, so that simultaneous kills always resolve
+// the same way.
+//
+// ql.DamageStats prints the counters of the queue.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLDamageManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLDamageManager();
+
+    virtual void Initialize() override;
+
+    virtual void Deinitialize() override;
+
+    void QueueDamage(const FQLDamageEvent& DamageEvent);
+
+    void LogStats() const;
+
+protected:
+    void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+    void Flush();
+
+    FDelegateHandle PostActorTickDelegateHandle;
+
+    TArray<FQLDamageEvent> PendingEventList;
+
+    // events being resolved; hits taken meanwhile, e.g. upon death, wait for the next frame
+    TArray<FQLDamageEvent> ResolvingEventList;
+
+    int32 NextSequenceNumber;
+
+    int32 QueuedCount;
+
+    int32 ResolvedVictimCount;
+
+    int32 FlushCount;
+};
@@ -0,0 +1,397 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLDecalManager.h"
+#include "QLGameModeBase.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "Engine/DecalActor.h"
+#include "Components/DecalComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLMaxDecals(
+    TEXT("ql.MaxDecals"),
+    64,
+    TEXT("Size of the impact decal ring buffer. The oldest decal is recycled when the buffer is full.\n")
+    TEXT("Read when the decal manager of the world is created."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarQLDecalSpawnBudget(
+    TEXT("ql.DecalSpawnBudget"),
+    8,
+    TEXT("Maximum number of impact decals spawned per frame. Extra decals are dropped."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarQLDecalFadeDistance(
+    TEXT("ql.DecalFadeDistance"),
+    5000.0f,
+    TEXT("Impact decals farther than this distance from every local player fade out and are recycled.\n")
+    TEXT("0: no distance fade."),
+    ECVF_Default);
+
+namespace
+{
+    // number of slots checked against the fade distance every frame
+    const int32 FadeCheckSlotCountPerFrame = 8;
+}
+
+//------------------------------------------------------------
+// Print the counters of the decal manager of the world
+//------------------------------------------------------------
+static void LogDecalStats(UWorld* World)
+{
+    UQLDecalManager* DecalManager = AQLGameModeBase::GetWorldService<UQLDecalManager>(World);
+    if (DecalManager)
+    {
+        DecalManager->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLDecalStatsCommand(
+    TEXT("ql.DecalStats"),
+    TEXT("Print the number of impact decals live, recycled, faded out and dropped."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogDecalStats));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLDecalManager::UQLDecalManager() :
+HostActor(nullptr),
+NextSlotIndex(0),
+FadeCheckSlotIndex(0),
+SpawnCountThisFrame(0),
+SpawnFrameNumber(0),
+LiveDecalCount(0),
+RecycledDecalCount(0),
+FadedDecalCount(0),
+DroppedDecalCount(0),
+FadeDuration(1.0f)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDecalManager::Initialize()
+{
+    Super::Initialize();
+
+    SlotList.SetNum(FMath::Max(CVarQLMaxDecals.GetValueOnGameThread(), 1));
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    // the decal components are created on demand and owned by this actor
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    HostActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDecalManager::Deinitialize()
+{
+    // the host actor and its decal components belong to the level and are destroyed with it
+    SlotList.Empty();
+    HostActor = nullptr;
+    LiveDecalCount = 0;
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDecalManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    // free the decals whose fade-out is over
+    const float CurrentTime = World->GetTimeSeconds();
+    for (FQLDecalSlot& Slot : SlotList)
+    {
+        if (Slot.bIsFading && CurrentTime >= Slot.FadeEndTime)
+        {
+            FreeSlot(Slot);
+            ++FadedDecalCount;
+        }
+    }
+
+    UpdateDistanceFade();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLDecalManager::SpawnDecal(UMaterialInterface* DecalMaterial, const FVector& DecalSize, const FVector& Location, const FRotator& Rotation)
+{
+    UWorld* World = GetWorld();
+    if (!World || !DecalMaterial || SlotList.Num() == 0)
+    {
+        return false;
+    }
+
+    // decals are never seen on a dedicated server
+    if (World->GetNetMode() == NM_DedicatedServer)
+    {
+        return false;
+    }
+
+    if (SpawnFrameNumber != GFrameCounter)
+    {
+        SpawnFrameNumber = GFrameCounter;
+        SpawnCountThisFrame = 0;
+    }
+
+    if (SpawnCountThisFrame >= CVarQLDecalSpawnBudget.GetValueOnGameThread())
+    {
+        ++DroppedDecalCount;
+        return false;
+    }
+
+    FQLDecalSlot& Slot = SlotList[NextSlotIndex];
+
+    UDecalComponent* DecalComponent = GetOrCreateDecalComponent(Slot);
+    if (!DecalComponent)
+    {
+        return false;
+    }
+
+    // the buffer is full, overwrite the oldest decal
+    if (Slot.bIsLive)
+    {
+        FreeSlot(Slot);
+        ++RecycledDecalCount;
+    }
+
+    DecalComponent->SetDecalMaterial(DecalMaterial);
+    DecalComponent->DecalSize = DecalSize;
+    DecalComponent->SetWorldLocationAndRotation(Location, Rotation);
+    DecalComponent->SetVisibility(true);
+
+    Slot.bIsLive = true;
+    Slot.bIsFading = false;
+    ++LiveDecalCount;
+    ++SpawnCountThisFrame;
+
+    NextSlotIndex = (NextSlotIndex + 1) % SlotList.Num();
+
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLDecalManager::SpawnDecal(TSubclassOf<ADecalActor> DecalClass, const FVector& Location, const FRotator& Rotation)
+{
+    if (!DecalClass)
+    {
+        return false;
+    }
+
+    // the class default object holds the material and size set in Blueprint
+    ADecalActor* DefaultDecalActor = DecalClass->GetDefaultObject<ADecalActor>();
+    if (!DefaultDecalActor)
+    {
+        return false;
+    }
+
+    UDecalComponent* DefaultDecal = DefaultDecalActor->GetDecal();
+    if (!DefaultDecal)
+    {
+        return false;
+    }
+
+    return SpawnDecal(DefaultDecal->GetDecalMaterial(),
+        DefaultDecal->DecalSize * DefaultDecal->RelativeScale3D,
+        Location,
+        Rotation);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLDecalManager::GetLiveDecalCount() const
+{
+    return LiveDecalCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLDecalManager::GetRecycledDecalCount() const
+{
+    return RecycledDecalCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLDecalManager::GetFadedDecalCount() const
+{
+    return FadedDecalCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLDecalManager::GetDroppedDecalCount() const
+{
+    return DroppedDecalCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDecalManager::LogStats() const
+{
+    QLUtility::Log(FString::Printf(TEXT("decals: capacity %d, live %d, recycled %d, faded out %d, dropped %d"),
+        SlotList.Num(),
+        LiveDecalCount,
+        RecycledDecalCount,
+        FadedDecalCount,
+        DroppedDecalCount));
+}
+
+//------------------------------------------------------------
+// The fade-out timer of a decal component destroys the component
+// if it fires before the slot is freed. In that case a new
+// component is created the next time the slot is used.
+//------------------------------------------------------------
+UDecalComponent* UQLDecalManager::GetOrCreateDecalComponent(FQLDecalSlot& Slot)
+{
+    if (Slot.DecalComponent.IsValid() && !Slot.DecalComponent->IsPendingKill())
+    {
+        return Slot.DecalComponent.Get();
+    }
+
+    if (Slot.bIsLive)
+    {
+        Slot.bIsLive = false;
+        Slot.bIsFading = false;
+        LiveDecalCount = FMath::Max(LiveDecalCount - 1, 0);
+    }
+
+    if (!HostActor || HostActor->IsPendingKill())
+    {
+        return nullptr;
+    }
+
+    UDecalComponent* DecalComponent = NewObject<UDecalComponent>(HostActor);
+    DecalComponent->SetMobility(EComponentMobility::Movable);
+    DecalComponent->SetVisibility(false);
+    DecalComponent->RegisterComponent();
+
+    Slot.DecalComponent = DecalComponent;
+
+    return DecalComponent;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDecalManager::FreeSlot(FQLDecalSlot& Slot)
+{
+    if (Slot.bIsLive)
+    {
+        LiveDecalCount = FMath::Max(LiveDecalCount - 1, 0);
+    }
+
+    Slot.bIsLive = false;
+    Slot.bIsFading = false;
+
+    UDecalComponent* DecalComponent = Slot.DecalComponent.Get();
+    if (DecalComponent && !DecalComponent->IsPendingKill())
+    {
+        // cancel any fade-out
+        DecalComponent->SetFadeOut(0.0f, 0.0f, false);
+        DecalComponent->SetVisibility(false);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLDecalManager::UpdateDistanceFade()
+{
+    const float FadeDistance = CVarQLDecalFadeDistance.GetValueOnGameThread();
+    if (FadeDistance <= 0.0f || LiveDecalCount == 0)
+    {
+        return;
+    }
+
+    TArray<FVector> ViewLocationList;
+    if (!GetViewLocationList(ViewLocationList))
+    {
+        return;
+    }
+
+    UWorld* World = GetWorld();
+    const float FadeDistanceSquared = FadeDistance * FadeDistance;
+    const int32 CheckCount = FMath::Min(FadeCheckSlotCountPerFrame, SlotList.Num());
+
+    for (int32 Count = 0; Count < CheckCount; ++Count)
+    {
+        FQLDecalSlot& Slot = SlotList[FadeCheckSlotIndex];
+        FadeCheckSlotIndex = (FadeCheckSlotIndex + 1) % SlotList.Num();
+
+        if (!Slot.bIsLive || Slot.bIsFading)
+        {
+            continue;
+        }
+
+        UDecalComponent* DecalComponent = Slot.DecalComponent.Get();
+        if (!DecalComponent)
+        {
+            continue;
+        }
+
+        const FVector DecalLocation = DecalComponent->GetComponentLocation();
+
+        bool bIsNearPlayer = false;
+        for (const FVector& ViewLocation : ViewLocationList)
+        {
+            if (FVector::DistSquared(DecalLocation, ViewLocation) < FadeDistanceSquared)
+            {
+                bIsNearPlayer = true;
+                break;
+            }
+        }
+
+        if (!bIsNearPlayer)
+        {
+            DecalComponent->SetFadeOut(0.0f, FadeDuration, false);
+            Slot.bIsFading = true;
+            Slot.FadeEndTime = World->GetTimeSeconds() + FadeDuration;
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLDecalManager::GetViewLocationList(TArray<FVector>& OutViewLocationList) const
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return false;
+    }
+
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        APlayerController* PlayerController = It->Get();
+        if (PlayerController && PlayerController->IsLocalController() && PlayerController->PlayerCameraManager)
+        {
+            OutViewLocationList.Add(PlayerController->PlayerCameraManager->GetCameraLocation());
+        }
+    }
+
+    return OutViewLocationList.Num() > 0;
+}
@@ -0,0 +1,128 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLDecalManager.generated.h"
+
+class ADecalActor;
+class UDecalComponent;
+class UMaterialInterface;
+
+//------------------------------------------------------------
+// A slot of the decal ring buffer
+//------------------------------------------------------------
+struct FQLDecalSlot
+{
+    FQLDecalSlot() :
+    bIsLive(false),
+    bIsFading(false),
+    FadeEndTime(0.0f)
+    {
+    }
+
+    TWeakObjectPtr<UDecalComponent> DecalComponent;
+
+    bool bIsLive;
+
+    bool bIsFading;
+
+    // world time at which a fading decal is hidden
+    float FadeEndTime;
+};
+
+//------------------------------------------------------------
+// Impact decals (bullet holes, scorch marks, etc.) drawn from
+// a fixed-size ring buffer of decal components. When the buffer
+// is full, the oldest decal is recycled. The number of decals
+// spawned per frame is capped, and the decals far from every
+// local player fade out and are freed.
+//
+// ql.MaxDecals, ql.DecalSpawnBudget and ql.DecalFadeDistance
+// tune the manager. ql.DecalStats prints its counters.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLDecalManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLDecalManager();
+
+    virtual void Initialize() override;
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    //------------------------------------------------------------
+    // Draw a decal. Return false if the per-frame budget is used up.
+    //------------------------------------------------------------
+    bool SpawnDecal(UMaterialInterface* DecalMaterial, const FVector& DecalSize, const FVector& Location, const FRotator& Rotation);
+
+    //------------------------------------------------------------
+    // Draw the decal set up in the Blueprint of DecalClass
+    //------------------------------------------------------------
+    bool SpawnDecal(TSubclassOf<ADecalActor> DecalClass, const FVector& Location, const FRotator& Rotation);
+
+    int32 GetLiveDecalCount() const;
+
+    int32 GetRecycledDecalCount() const;
+
+    int32 GetFadedDecalCount() const;
+
+    int32 GetDroppedDecalCount() const;
+
+    void LogStats() const;
+
+protected:
+    UDecalComponent* GetOrCreateDecalComponent(FQLDecalSlot& Slot);
+
+    void FreeSlot(FQLDecalSlot& Slot);
+
+    //------------------------------------------------------------
+    // Fade out the live decals too far from every local player,
+    // checking a few slots per frame
+    //------------------------------------------------------------
+    void UpdateDistanceFade();
+
+    bool GetViewLocationList(TArray<FVector>& OutViewLocationList) const;
+
+    UPROPERTY()
+    AActor* HostActor;
+
+    TArray<FQLDecalSlot> SlotList;
+
+    // slot of the next decal, i.e. the oldest one when the buffer is full
+    int32 NextSlotIndex;
+
+    // slot from which the distance check resumes next frame
+    int32 FadeCheckSlotIndex;
+
+    // number of decals spawned in the current frame
+    int32 SpawnCountThisFrame;
+
+    uint64 SpawnFrameNumber;
+
+    int32 LiveDecalCount;
+
+    // live decals overwritten because the buffer was full
+    int32 RecycledDecalCount;
+
+    // live decals freed because they were far from every local player
+    int32 FadedDecalCount;
+
+    // decals not drawn because the per-frame budget was used up
+    int32 DroppedDecalCount;
+
+    float FadeDuration;
+};
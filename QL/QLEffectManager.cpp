@@ -0,0 +1,363 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLEffectManager.h"
+#include "QLGameModeBase.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundAttenuation.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarQLEffectMergeDistance(
+    TEXT("ql.EffectMergeDistance"),
+    200.0f,
+    TEXT("Sounds and emitters of the same asset closer than this distance are merged into one event."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarQLEffectMergeTime(
+    TEXT("ql.EffectMergeTime"),
+    0.1f,
+    TEXT("An event is merged into an event of the same asset played less than this many seconds ago nearby."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarQLEffectCullDistance(
+    TEXT("ql.EffectCullDistance"),
+    8000.0f,
+    TEXT("Sounds and emitters farther than this distance from every listener are not played.\n")
+    TEXT("0: no distance culling."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarQLSoundEventBudget(
+    TEXT("ql.SoundEventBudget"),
+    12,
+    TEXT("Maximum number of queued sounds played per frame, nearest first."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarQLEmitterEventBudget(
+    TEXT("ql.EmitterEventBudget"),
+    8,
+    TEXT("Maximum number of queued emitters spawned per frame, nearest first."),
+    ECVF_Default);
+
+//------------------------------------------------------------
+// Print the counters of the effect queue of the world
+//------------------------------------------------------------
+static void LogEffectStats(UWorld* World)
+{
+    UQLEffectManager* EffectManager = AQLGameModeBase::GetWorldService<UQLEffectManager>(World);
+    if (EffectManager)
+    {
+        EffectManager->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLEffectStatsCommand(
+    TEXT("ql.EffectStats"),
+    TEXT("Print the number of queued sounds and emitters played, merged, culled and over budget."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogEffectStats));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLEffectManager::UQLEffectManager() :
+PlayedCount(0),
+MergedCount(0),
+CulledCount(0),
+OverBudgetCount(0)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::Initialize()
+{
+    Super::Initialize();
+
+    // flush once the projectiles have exploded, i.e. after the actors have ticked
+    PostActorTickDelegateHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UQLEffectManager::OnWorldPostActorTick);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickDelegateHandle);
+
+    PendingSoundList.Empty();
+    PendingEmitterList.Empty();
+    RecentEventList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::QueueSound(const FQLSoundHandle& SoundHandle, const FVector& Location, EQLSoundCategory Category)
+{
+    UQLAudioManager* AudioManager = AQLGameModeBase::GetWorldService<UQLAudioManager>(this);
+    if (!AudioManager)
+    {
+        return;
+    }
+
+    // the shooter must hear the hit wherever the victim stands,
+    // and the audio manager already caps the category to a couple of voices
+    if (Category == EQLSoundCategory::HitConfirm)
+    {
+        AudioManager->PlaySoundAtLocation(SoundHandle, Location, Category);
+        return;
+    }
+
+    USoundBase* Sound = AudioManager->GetSound(SoundHandle);
+    if (Sound)
+    {
+        QueueEvent(PendingSoundList, Sound, Location, 1.0f, SoundHandle, Category);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::QueueEmitter(UParticleSystem* ParticleSystem, const FVector& Location, float Scale)
+{
+    if (ParticleSystem)
+    {
+        QueueEvent(PendingEmitterList, ParticleSystem, Location, Scale, FQLSoundHandle(), EQLSoundCategory::Default);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLEffectManager::QueueEvent(TArray<FQLEffectEvent>& EventList, UObject* Asset, const FVector& Location, float Scale, const FQLSoundHandle& SoundHandle, EQLSoundCategory SoundCategory)
+{
+    const float MergeDistance = CVarQLEffectMergeDistance.GetValueOnGameThread();
+    const float MergeDistanceSquared = MergeDistance * MergeDistance;
+
+    // same asset queued nearby in this frame
+    for (FQLEffectEvent& Event : EventList)
+    {
+        if (Event.Asset.Get() == Asset && FVector::DistSquared(Event.Location, Location) <= MergeDistanceSquared)
+        {
+            ++Event.MergeCount;
+            ++MergedCount;
+            return false;
+        }
+    }
+
+    // same asset played nearby a moment ago
+    UWorld* World = GetWorld();
+    if (World)
+    {
+        const float MinTime = World->GetTimeSeconds() - CVarQLEffectMergeTime.GetValueOnGameThread();
+        for (const FQLPlayedEffectEvent& PlayedEvent : RecentEventList)
+        {
+            if (PlayedEvent.Time >= MinTime
+                && PlayedEvent.Asset.Get() == Asset
+                && FVector::DistSquared(PlayedEvent.Location, Location) <= MergeDistanceSquared)
+            {
+                ++MergedCount;
+                return false;
+            }
+        }
+    }
+
+    FQLEffectEvent Event;
+    Event.Asset = Asset;
+    Event.SoundHandle = SoundHandle;
+    Event.SoundCategory = SoundCategory;
+    Event.Location = Location;
+    Event.Scale = Scale;
+    Event.MergeCount = 1;
+    Event.SoundPriority = 0;
+    Event.ListenerDistanceSquared = 0.0f;
+    EventList.Add(Event);
+
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    if (World != GetWorld())
+    {
+        return;
+    }
+
+    Flush();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::UpdateListenerLocationList()
+{
+    ListenerLocationList.Reset();
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        APlayerController* PlayerController = It->Get();
+        if (PlayerController && PlayerController->IsLocalController() && PlayerController->PlayerCameraManager)
+        {
+            ListenerLocationList.Add(PlayerController->PlayerCameraManager->GetCameraLocation());
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::SelectEvents(TArray<FQLEffectEvent>& EventList, int32 Budget)
+{
+    const float CullDistance = CVarQLEffectCullDistance.GetValueOnGameThread();
+    const float CullDistanceSquared = CullDistance * CullDistance;
+
+    for (int32 Index = EventList.Num() - 1; Index >= 0; --Index)
+    {
+        FQLEffectEvent& Event = EventList[Index];
+
+        Event.SoundPriority = UQLAudioManager::GetCategoryPriority(Event.SoundCategory);
+        Event.ListenerDistanceSquared = MAX_flt;
+        for (const FVector& ListenerLocation : ListenerLocationList)
+        {
+            Event.ListenerDistanceSquared = FMath::Min(Event.ListenerDistanceSquared, FVector::DistSquared(Event.Location, ListenerLocation));
+        }
+
+        if (CullDistance > 0.0f && Event.ListenerDistanceSquared > CullDistanceSquared)
+        {
+            CulledCount += Event.MergeCount;
+            EventList.RemoveAtSwap(Index);
+        }
+    }
+
+    if (EventList.Num() <= Budget)
+    {
+        return;
+    }
+
+    // the budget goes to the categories the audio manager would keep anyway, nearest first within a category
+    EventList.Sort([](const FQLEffectEvent& A, const FQLEffectEvent& B)
+    {
+        if (A.SoundPriority != B.SoundPriority)
+        {
+            return A.SoundPriority > B.SoundPriority;
+        }
+
+        return A.ListenerDistanceSquared < B.ListenerDistanceSquared;
+    });
+
+    for (int32 Index = FMath::Max(Budget, 0); Index < EventList.Num(); ++Index)
+    {
+        OverBudgetCount += EventList[Index].MergeCount;
+    }
+
+    EventList.SetNum(FMath::Max(Budget, 0), false);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::Flush()
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    const float CurrentTime = World->GetTimeSeconds();
+    const float MinTime = CurrentTime - CVarQLEffectMergeTime.GetValueOnGameThread();
+    RecentEventList.RemoveAllSwap([MinTime](const FQLPlayedEffectEvent& PlayedEvent)
+    {
+        return PlayedEvent.Time < MinTime;
+    });
+
+    if (PendingSoundList.Num() == 0 && PendingEmitterList.Num() == 0)
+    {
+        return;
+    }
+
+    // nobody to hear or see the effects, e.g. on a dedicated server
+    UpdateListenerLocationList();
+    if (ListenerLocationList.Num() == 0)
+    {
+        for (const FQLEffectEvent& Event : PendingSoundList)
+        {
+            CulledCount += Event.MergeCount;
+        }
+        for (const FQLEffectEvent& Event : PendingEmitterList)
+        {
+            CulledCount += Event.MergeCount;
+        }
+
+        PendingSoundList.Reset();
+        PendingEmitterList.Reset();
+        return;
+    }
+
+    SelectEvents(PendingSoundList, CVarQLSoundEventBudget.GetValueOnGameThread());
+    SelectEvents(PendingEmitterList, CVarQLEmitterEventBudget.GetValueOnGameThread());
+
+    UQLAudioManager* AudioManager = AQLGameModeBase::GetWorldService<UQLAudioManager>(this);
+    for (const FQLEffectEvent& Event : PendingSoundList)
+    {
+        if (!AudioManager || !AudioManager->PlaySoundAtLocation(Event.SoundHandle, Event.Location, Event.SoundCategory))
+        {
+            continue;
+        }
+
+        RecentEventList.Add({ Event.Asset, Event.Location, CurrentTime });
+        ++PlayedCount;
+    }
+
+    for (const FQLEffectEvent& Event : PendingEmitterList)
+    {
+        UParticleSystem* ParticleSystem = Cast<UParticleSystem>(Event.Asset.Get());
+        if (!ParticleSystem)
+        {
+            continue;
+        }
+
+        FTransform Transform(FRotator::ZeroRotator,
+            Event.Location,
+            FVector(Event.Scale)); // scale
+
+        UGameplayStatics::SpawnEmitterAtLocation(World,
+            ParticleSystem,
+            Transform,
+            true, // auto destroy
+            EPSCPoolMethod::AutoRelease);
+
+        RecentEventList.Add({ Event.Asset, Event.Location, CurrentTime });
+        ++PlayedCount;
+    }
+
+    PendingSoundList.Reset();
+    PendingEmitterList.Reset();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLEffectManager::LogStats() const
+{
+    QLUtility::Log(FString::Printf(TEXT("effect queue: played %d, merged %d, culled %d, over budget %d"),
+        PlayedCount,
+        MergedCount,
+        CulledCount,
+        OverBudgetCount));
+}
@@ -0,0 +1,131 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "QLWorldService.h"
+#include "QLAudioManager.h"
+#include "QLEffectManager.generated.h"
+
+class UParticleSystem;
+
+//------------------------------------------------------------
+// A sound or particle system waiting to be played
+//------------------------------------------------------------
+struct FQLEffectEvent
+{
+    // USoundBase or UParticleSystem
+    TWeakObjectPtr<UObject> Asset;
+
+    // sounds only, played by the audio manager
+    FQLSoundHandle SoundHandle;
+
+    EQLSoundCategory SoundCategory;
+
+    FVector Location;
+
+    float Scale;
+
+    // number of events folded into this one
+    int32 MergeCount;
+
+    // priority of the sound category, computed when the queue is flushed
+    int32 SoundPriority;
+
+    // distance to the nearest listener, computed when the queue is flushed
+    float ListenerDistanceSquared;
+};
+
+//------------------------------------------------------------
+// An event played recently, kept to merge the events that follow it
+//------------------------------------------------------------
+struct FQLPlayedEffectEvent
+{
+    TWeakObjectPtr<UObject> Asset;
+
+    FVector Location;
+
+    float Time;
+};
+
+//------------------------------------------------------------
+// Per-frame queue of the fire-and-forget sounds and explosion
+// particle systems. The events of the same asset close in time
+// and space are merged, the events too far from every listener
+// are culled, and at most a fixed number of sounds and emitters
+// are played per frame, by category priority of UQLAudioManager
+// then nearest first. Hit confirms skip the queue and go straight
+// to the audio manager. The queue is flushed once
+// the actors have ticked, so rocket and nail spam costs about as
+// much as a single explosion. The selected sounds are played by
+// UQLAudioManager.
+//
+// ql.EffectMergeDistance, ql.EffectMergeTime,
+// ql.EffectCullDistance, ql.SoundEventBudget and
+// ql.EmitterEventBudget tune the queue. ql.EffectStats prints
+// its counters.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLEffectManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLEffectManager();
+
+    virtual void Initialize() override;
+
+    virtual void Deinitialize() override;
+
+    void QueueSound(const FQLSoundHandle& SoundHandle, const FVector& Location, EQLSoundCategory Category);
+
+    void QueueEmitter(UParticleSystem* ParticleSystem, const FVector& Location, float Scale);
+
+    void LogStats() const;
+
+protected:
+    void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+    //------------------------------------------------------------
+    // Add the event to the queue. Return false if it has been merged
+    // into a queued or recently played event.
+    //------------------------------------------------------------
+    bool QueueEvent(TArray<FQLEffectEvent>& EventList, UObject* Asset, const FVector& Location, float Scale, const FQLSoundHandle& SoundHandle, EQLSoundCategory SoundCategory);
+
+    //------------------------------------------------------------
+    // Cull the queued events, sort them by sound priority then
+    // listener distance, and trim them to the budget
+    //------------------------------------------------------------
+    void SelectEvents(TArray<FQLEffectEvent>& EventList, int32 Budget);
+
+    void Flush();
+
+    void UpdateListenerLocationList();
+
+    FDelegateHandle PostActorTickDelegateHandle;
+
+    TArray<FQLEffectEvent> PendingSoundList;
+
+    TArray<FQLEffectEvent> PendingEmitterList;
+
+    TArray<FQLPlayedEffectEvent> RecentEventList;
+
+    TArray<FVector> ListenerLocationList;
+
+    int32 PlayedCount;
+
+    int32 MergedCount;
+
+    int32 CulledCount;
+
+    int32 OverBudgetCount;
+};
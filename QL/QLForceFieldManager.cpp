@@ -0,0 +1,148 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLForceFieldManager.h"
+#include "QLSpatialQueryManager.h"
+#include "QLGameModeBase.h"
+#include "QLCharacter.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLForceFieldManager::UQLForceFieldManager() :
+NextId(0)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLForceFieldManager::Deinitialize()
+{
+    ForceFieldList.Empty();
+    CharacterList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLForceFieldManager::AddForceField(const FQLForceField& ForceField)
+{
+    const int32 Index = ForceFieldList.Add(ForceField);
+    ForceFieldList[Index].Id = NextId++;
+
+    return ForceFieldList[Index].Id;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLForceFieldManager::RemoveForceField(int32 Id)
+{
+    ForceFieldList.RemoveAllSwap([Id](const FQLForceField& ForceField)
+    {
+        return ForceField.Id == Id;
+    });
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLForceFieldManager::GetForceFieldCount() const
+{
+    return ForceFieldList.Num();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLForceFieldManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (ForceFieldList.Num() == 0)
+    {
+        return;
+    }
+
+    // move the fields with their source, and drop the ones whose source is gone
+    FBox Bounds(ForceInit);
+    for (int32 Index = ForceFieldList.Num() - 1; Index >= 0; --Index)
+    {
+        FQLForceField& ForceField = ForceFieldList[Index];
+
+        if (!ForceField.SourceActor.IsExplicitlyNull())
+        {
+            if (!ForceField.SourceActor.IsValid() || ForceField.SourceActor->IsPendingKill())
+            {
+                ForceFieldList.RemoveAtSwap(Index);
+                continue;
+            }
+
+            ForceField.Center = ForceField.SourceActor->GetActorLocation();
+        }
+
+        Bounds += FBox(ForceField.Center - FVector(ForceField.Radius), ForceField.Center + FVector(ForceField.Radius));
+    }
+
+    if (ForceFieldList.Num() == 0)
+    {
+        return;
+    }
+
+    UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(this);
+    if (!SpatialQueryManager)
+    {
+        return;
+    }
+
+    // one query for all the fields
+    CharacterList.Reset();
+    SpatialQueryManager->FindCharactersInBox(Bounds, CharacterList);
+
+    for (AQLCharacter* Character : CharacterList)
+    {
+        UCharacterMovementComponent* CharacterMovementComponent = Character->GetCharacterMovement();
+        if (!CharacterMovementComponent)
+        {
+            continue;
+        }
+
+        const FVector Location = Character->GetActorLocation();
+        FVector VelocityChange = FVector::ZeroVector;
+
+        // same formula as UCharacterMovementComponent::AddRadialImpulse(), summed over the fields
+        for (const FQLForceField& ForceField : ForceFieldList)
+        {
+            const FVector Delta = Location - ForceField.Center;
+            const float Distance = Delta.Size();
+            if (Distance > ForceField.Radius)
+            {
+                continue;
+            }
+
+            float Magnitude = ForceField.Strength * DeltaTime;
+            if (ForceField.Falloff == ERadialImpulseFalloff::RIF_Linear && ForceField.Radius > 0.0f)
+            {
+                Magnitude *= 1.0f - Distance / ForceField.Radius;
+            }
+
+            if (ForceField.ScaledCharacter.Get() == Character)
+            {
+                Magnitude *= ForceField.ScaledCharacterMultiplier;
+            }
+
+            VelocityChange += Delta.GetSafeNormal() * Magnitude;
+        }
+
+        if (!VelocityChange.IsNearlyZero())
+        {
+            CharacterMovementComponent->AddImpulse(VelocityChange, true); // velocity change (true) or impulse (false)
+        }
+    }
+}
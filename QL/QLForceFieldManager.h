@@ -0,0 +1,92 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "QLWorldService.h"
+#include "QLForceFieldManager.generated.h"
+
+class AQLCharacter;
+
+//------------------------------------------------------------
+// A spherical field changing the velocity of the characters
+// inside it, e.g. the pull of an imploding recycler grenade
+//------------------------------------------------------------
+struct FQLForceField
+{
+    FQLForceField() :
+    Id(INDEX_NONE),
+    Center(FVector::ZeroVector),
+    Radius(0.0f),
+    Strength(0.0f),
+    Falloff(ERadialImpulseFalloff::RIF_Linear),
+    ScaledCharacterMultiplier(1.0f)
+    {
+    }
+
+    int32 Id;
+
+    FVector Center;
+
+    float Radius;
+
+    // velocity change per second at the center
+    // positive values push the characters away (repulsor), negative values pull them in (attractor)
+    float Strength;
+
+    ERadialImpulseFalloff Falloff;
+
+    // if set, the field follows this actor and is removed when the actor is gone
+    TWeakObjectPtr<AActor> SourceActor;
+
+    // character receiving a different strength, e.g. the thrower of the grenade
+    TWeakObjectPtr<AQLCharacter> ScaledCharacter;
+
+    float ScaledCharacterMultiplier;
+};
+
+//------------------------------------------------------------
+// Apply all the force fields of the world in a single pass per
+// frame: one character query covering every field, then the
+// combined velocity change of each affected character is applied
+// at once. The change is scaled by the frame time, so the pull
+// does not depend on the frame rate.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLForceFieldManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLForceFieldManager();
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    //------------------------------------------------------------
+    // Return the id used to remove the field
+    //------------------------------------------------------------
+    int32 AddForceField(const FQLForceField& ForceField);
+
+    void RemoveForceField(int32 Id);
+
+    int32 GetForceFieldCount() const;
+
+protected:
+    TArray<FQLForceField> ForceFieldList;
+
+    int32 NextId;
+
+    // scratch buffer of the characters inside the fields
+    TArray<AQLCharacter*> CharacterList;
+};
@@ -13,6 +13,12 @@
 #include "QLCharacter.h"
 #include "QLHUD.h"
 #include "QLPlayerController.h"
+#include "QLActorPoolManager.h"
+#include "QLAssetPreloadManager.h"
+#include "QLPatrolPointManager.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/PlatformTime.h"
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -24,4 +30,161 @@ Super()
     HUDClass = AQLHUD::StaticClass();
 
     PlayerControllerClass = AQLPlayerController::StaticClass();
-}
\ No newline at end of file
+
+    // world services are ticked by the game mode
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = true;
+
+    bWorldServicesShutDown = false;
+    bTimeWorldServices = false;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLGameModeBase::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+    Super::InitGame(MapName, Options, ErrorMessage);
+
+    UQLAssetPreloadManager* AssetPreloadManager = GetWorldService<UQLAssetPreloadManager>(this);
+    if (AssetPreloadManager && DefaultPawnClass && DefaultPawnClass->IsChildOf(AQLCharacter::StaticClass()))
+    {
+        AssetPreloadManager->PreloadCharacterEquipment(*DefaultPawnClass);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLGameModeBase::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // start building the patrol points before the bots need them
+    GetWorldService<UQLPatrolPointManager>(this);
+
+    if (ActorPoolWarmUpList.Num() > 0)
+    {
+        UQLActorPoolManager* ActorPoolManager = GetWorldService<UQLActorPoolManager>(this);
+        if (ActorPoolManager)
+        {
+            for (const auto& Item : ActorPoolWarmUpList)
+            {
+                ActorPoolManager->WarmUp(Item.Key, Item.Value);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLGameModeBase::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    // a service may create another service while being ticked
+    // so do not use range-based for loop here
+    for (int32 Index = 0; Index < WorldServiceList.Num(); ++Index)
+    {
+        UQLWorldService* Service = WorldServiceList[Index];
+        if (!Service)
+        {
+            continue;
+        }
+
+        if (bTimeWorldServices)
+        {
+            const double StartTime = FPlatformTime::Seconds();
+            Service->Tick(DeltaSeconds);
+            RecordWorldServiceTime(Service, FPlatformTime::Seconds() - StartTime);
+        }
+        else
+        {
+            Service->Tick(DeltaSeconds);
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLGameModeBase::RecordWorldServiceTime(UQLWorldService* Service, double Seconds)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLGameModeBase::NotifyCharacterDamaged(AQLCharacter* Victim, float DamageAmount, AController* EventInstigator, AActor* DamageCauser)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLGameModeBase::NotifyCharacterKilled(AQLCharacter* Victim, AController* EventInstigator, AActor* DamageCauser)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // shut down in the reverse order of creation
+    for (int32 Index = WorldServiceList.Num() - 1; Index >= 0; --Index)
+    {
+        UQLWorldService* Service = WorldServiceList[Index];
+        if (Service)
+        {
+            Service->Deinitialize();
+        }
+    }
+
+    WorldServiceList.Empty();
+    bWorldServicesShutDown = true;
+
+    Super::EndPlay(EndPlayReason);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLWorldService* AQLGameModeBase::GetWorldServiceInternal(const UObject* WorldContextObject, TSubclassOf<UQLWorldService> ServiceClass)
+{
+    if (!WorldContextObject || !GEngine)
+    {
+        return nullptr;
+    }
+
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    AQLGameModeBase* QLGameMode = World->GetAuthGameMode<AQLGameModeBase>();
+    if (!QLGameMode)
+    {
+        return nullptr;
+    }
+
+    return QLGameMode->FindOrCreateWorldService(ServiceClass);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLWorldService* AQLGameModeBase::FindOrCreateWorldService(TSubclassOf<UQLWorldService> ServiceClass)
+{
+    if (!ServiceClass || bWorldServicesShutDown)
+    {
+        return nullptr;
+    }
+
+    for (auto&& Item : WorldServiceList)
+    {
+        if (Item && Item->GetClass() == ServiceClass)
+        {
+            return Item;
+        }
+    }
+
+    UQLWorldService* Service = NewObject<UQLWorldService>(this, ServiceClass);
+    WorldServiceList.Add(Service);
+    Service->Initialize();
+
+    return Service;
+}
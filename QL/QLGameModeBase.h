@@ -12,9 +12,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "QLWorldService.h"
 #include "QLGameModeBase.generated.h"
 
 class QLCharacterHelper;
+class AQLCharacter;
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -26,5 +28,61 @@ class QL_API AQLGameModeBase : public AGameModeBase
 public:
     AQLGameModeBase();
 
+    //------------------------------------------------------------
+    // Start preloading the equipment of the default pawn class
+    // while the map loads, see UQLAssetPreloadManager
+    //------------------------------------------------------------
+    virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+    virtual void Tick(float DeltaSeconds) override;
+
+    //------------------------------------------------------------
+    // Return the world service of type T, creating it on first use.
+    // Return nullptr if the world is not run by AQLGameModeBase,
+    // in which case the caller should fall back to its own logic.
+    //------------------------------------------------------------
+    template <typename T>
+    static T* GetWorldService(const UObject* WorldContextObject)
+    {
+        return Cast<T>(GetWorldServiceInternal(WorldContextObject, T::StaticClass()));
+    }
+
+    //------------------------------------------------------------
+    // Called by AQLCharacter when it takes damage, and when the damage kills it
+    //------------------------------------------------------------
+    virtual void NotifyCharacterDamaged(AQLCharacter* Victim, float DamageAmount, AController* EventInstigator, AActor* DamageCauser);
+
+    virtual void NotifyCharacterKilled(AQLCharacter* Victim, AController* EventInstigator, AActor* DamageCauser);
+
 protected:
+    virtual void BeginPlay() override;
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    static UQLWorldService* GetWorldServiceInternal(const UObject* WorldContextObject, TSubclassOf<UQLWorldService> ServiceClass);
+
+    UQLWorldService* FindOrCreateWorldService(TSubclassOf<UQLWorldService> ServiceClass);
+
+    //------------------------------------------------------------
+    // Called after each world service tick when bTimeWorldServices is set
+    //------------------------------------------------------------
+    virtual void RecordWorldServiceTime(UQLWorldService* Service, double Seconds);
+
+    // services are ticked in the order of creation
+    UPROPERTY()
+    TArray<UQLWorldService*> WorldServiceList;
+
+    UPROPERTY()
+    bool bWorldServicesShutDown;
+
+    // measure the tick of each world service, see RecordWorldServiceTime()
+    UPROPERTY()
+    bool bTimeWorldServices;
+
+    //------------------------------------------------------------
+    // Number of actors spawned into the actor pool of each class
+    // when the match starts, e.g. nail projectile: 60
+    //------------------------------------------------------------
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    TMap<TSubclassOf<AActor>, int32> ActorPoolWarmUpList;
 };
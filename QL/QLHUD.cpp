@@ -14,10 +14,29 @@
 #include "Engine/Texture2D.h"
 #include "TextureResource.h"
 #include "CanvasItem.h"
+#include "RenderUtils.h"
+#include "QLCharacter.h"
+#include "QLGameModeBase.h"
+#include "QLSpatialQueryManager.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarQLHealthBarDrawDistance(
+    TEXT("ql.HealthBarDrawDistance"),
+    4000.0f,
+    TEXT("Health and armor bars of the characters farther than this distance from the camera are not drawn.\n")
+    TEXT("0: no bar."),
+    ECVF_Default);
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-AQLHUD::AQLHUD()
+AQLHUD::AQLHUD() :
+HealthArmorBarSize(64.0f, 5.0f),
+HealthBarColor(0.1f, 0.8f, 0.1f, 0.8f),
+ArmorBarColor(1.0f, 0.8f, 0.0f, 0.8f),
+HealthArmorBarBackgroundColor(0.0f, 0.0f, 0.0f, 0.5f)
 {
 }
 
@@ -27,6 +46,8 @@ void AQLHUD::DrawHUD()
 {
     Super::DrawHUD();
 
+    DrawHealthArmorBars();
+
     if (CrosshairTexture.IsValid() && Canvas)
     {
         // Find the center of our canvas.
@@ -47,4 +68,98 @@ void AQLHUD::DrawHUD()
 void AQLHUD::UpdateCrossHair(UTexture2D* CrosshairTextureExt)
 {
     CrosshairTexture = CrosshairTextureExt;
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLHUD::DrawHealthArmorBars()
+{
+    const float DrawDistance = CVarQLHealthBarDrawDistance.GetValueOnGameThread();
+    if (!Canvas || !PlayerOwner || !PlayerOwner->PlayerCameraManager || DrawDistance <= 0.0f)
+    {
+        return;
+    }
+
+    const FVector CameraLocation = PlayerOwner->PlayerCameraManager->GetCameraLocation();
+    const FVector CameraDirection = PlayerOwner->PlayerCameraManager->GetCameraRotation().Vector();
+
+    // distance culling
+    CharacterList.Reset();
+    UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(this);
+    if (SpatialQueryManager)
+    {
+        SpatialQueryManager->FindCharactersInRadius(CameraLocation, DrawDistance, CharacterList);
+    }
+    else
+    {
+        for (TActorIterator<AQLCharacter> It(GetWorld()); It; ++It)
+        {
+            CharacterList.Add(*It);
+        }
+    }
+
+    const float DrawDistanceSquared = DrawDistance * DrawDistance;
+    APawn* OwningPawn = GetOwningPawn();
+
+    HealthArmorBarList.Reset();
+    for (AQLCharacter* Character : CharacterList)
+    {
+        if (!Character || Character == OwningPawn || !Character->ShouldDrawHealthArmorBarOnHUD())
+        {
+            continue;
+        }
+
+        const FVector BarLocation = Character->GetHealthArmorBarLocation();
+        const FVector ToBar = BarLocation - CameraLocation;
+        if (FVector::DotProduct(ToBar, CameraDirection) <= 0.0f || ToBar.SizeSquared() > DrawDistanceSquared)
+        {
+            continue;
+        }
+
+        // hidden, or culled by the occlusion queries of the renderer
+        if (!Character->WasRecentlyRendered(0.2f))
+        {
+            continue;
+        }
+
+        const FVector ScreenLocation = Canvas->Project(BarLocation);
+        if (ScreenLocation.Z <= 0.0f
+            || ScreenLocation.X < -HealthArmorBarSize.X
+            || ScreenLocation.X > Canvas->ClipX + HealthArmorBarSize.X
+            || ScreenLocation.Y < 0.0f
+            || ScreenLocation.Y > Canvas->ClipY + 2.0f * HealthArmorBarSize.Y)
+        {
+            continue;
+        }
+
+        FQLHealthArmorBarEntry Entry;
+        Entry.ScreenPosition = FVector2D(ScreenLocation.X, ScreenLocation.Y);
+        Entry.HealthPercent = Character->GetMaxHealth() > 0.0f ? FMath::Clamp(Character->GetHealth() / Character->GetMaxHealth(), 0.0f, 1.0f) : 0.0f;
+        Entry.ArmorPercent = Character->GetMaxArmor() > 0.0f ? FMath::Clamp(Character->GetArmor() / Character->GetMaxArmor(), 0.0f, 1.0f) : 0.0f;
+        HealthArmorBarList.Add(Entry);
+    }
+
+    // the tiles share the white texture and the blend mode, the canvas draws them in one batch
+    FCanvasTileItem TileItem(FVector2D::ZeroVector, GWhiteTexture, HealthArmorBarSize, FLinearColor::White);
+    TileItem.BlendMode = SE_BLEND_Translucent;
+
+    for (const FQLHealthArmorBarEntry& Entry : HealthArmorBarList)
+    {
+        const FVector2D ArmorBarPosition(Entry.ScreenPosition.X - 0.5f * HealthArmorBarSize.X, Entry.ScreenPosition.Y - 2.0f * HealthArmorBarSize.Y);
+        const FVector2D HealthBarPosition(ArmorBarPosition.X, ArmorBarPosition.Y + HealthArmorBarSize.Y);
+
+        TileItem.Position = ArmorBarPosition;
+        TileItem.Size = FVector2D(HealthArmorBarSize.X, 2.0f * HealthArmorBarSize.Y);
+        TileItem.SetColor(HealthArmorBarBackgroundColor);
+        Canvas->DrawItem(TileItem);
+
+        TileItem.Size = FVector2D(Entry.ArmorPercent * HealthArmorBarSize.X, HealthArmorBarSize.Y);
+        TileItem.SetColor(ArmorBarColor);
+        Canvas->DrawItem(TileItem);
+
+        TileItem.Position = HealthBarPosition;
+        TileItem.Size = FVector2D(Entry.HealthPercent * HealthArmorBarSize.X, HealthArmorBarSize.Y);
+        TileItem.SetColor(HealthBarColor);
+        Canvas->DrawItem(TileItem);
+    }
+}
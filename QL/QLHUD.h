@@ -14,7 +14,28 @@
 #include "GameFramework/HUD.h"
 #include "QLHUD.generated.h"
 
+class AQLCharacter;
+
+//------------------------------------------------------------
+// Health and armor bar of a character, ready to be drawn
+//------------------------------------------------------------
+struct FQLHealthArmorBarEntry
+{
+    // bottom center of the bar
+    FVector2D ScreenPosition;
+
+    float HealthPercent;
+
+    float ArmorPercent;
+};
+
 //------------------------------------------------------------
+// Besides the crosshair, the HUD draws the health and armor bars
+// of the characters that opted in (see
+// AQLCharacter::bDrawHealthArmorBarOnHUD) in a single batched pass
+// of canvas tiles. The bars behind the camera, off screen, farther
+// than ql.HealthBarDrawDistance or not rendered recently, i.e.
+// occluded, are culled.
 //------------------------------------------------------------
 UCLASS()
 class QL_API AQLHUD : public AHUD
@@ -31,6 +52,25 @@ public:
     void UpdateCrossHair(UTexture2D* CrosshairTextureExt);
 
 protected:
+    void DrawHealthArmorBars();
+
     UPROPERTY()
     TWeakObjectPtr<UTexture2D> CrosshairTexture;
+
+    // size of the health bar and of the armor bar above it (pixel)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    FVector2D HealthArmorBarSize;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    FLinearColor HealthBarColor;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    FLinearColor ArmorBarColor;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    FLinearColor HealthArmorBarBackgroundColor;
+
+    TArray<AQLCharacter*> CharacterList;
+
+    TArray<FQLHealthArmorBarEntry> HealthArmorBarList;
 };
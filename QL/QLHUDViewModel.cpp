@@ -0,0 +1,238 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLHUDViewModel.h"
+#include "QLUmgFirstPerson.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLHUDViewModel::UQLHUDViewModel() :
+bQuadDamageProgressVisible(false),
+bProtectionProgressVisible(false),
+bIsVisibilityDirty(false),
+FPSWindow(0.5f),
+FPSElapsedTime(0.0f),
+FPSFrameCount(0)
+{
+    InitValue(Health, 0.0f, 1.0f);
+    InitValue(Armor, 0.0f, 1.0f);
+    InitValue(Speed, 0.0f, 10.0f);
+    InitValue(FPS, 0.0f, 1.0f);
+    InitValue(QuadDamageProgress, 0.0f, 0.01f);
+    InitValue(ProtectionProgress, 0.0f, 0.01f);
+    InitValue(AbilityCooldownProgress, 0.0f, 0.01f);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::InitValue(FQLHUDValue& HUDValue, float Value, float Step)
+{
+    HUDValue.Value = Value;
+    HUDValue.Step = Step;
+    HUDValue.DisplayedStep = FMath::RoundToInt(Value / Step);
+    HUDValue.bIsDirty = false;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetValue(FQLHUDValue& HUDValue, float Value)
+{
+    HUDValue.Value = Value;
+
+    if (FMath::RoundToInt(Value / HUDValue.Step) != HUDValue.DisplayedStep)
+    {
+        HUDValue.bIsDirty = true;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLHUDViewModel::ConsumeValue(FQLHUDValue& HUDValue, bool bForce)
+{
+    if (!HUDValue.bIsDirty && !bForce)
+    {
+        return false;
+    }
+
+    HUDValue.DisplayedStep = FMath::RoundToInt(HUDValue.Value / HUDValue.Step);
+    HUDValue.bIsDirty = false;
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetWidget(UQLUmgFirstPerson* WidgetExt)
+{
+    Widget = WidgetExt;
+
+    PushValues(true);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetHealth(float Value)
+{
+    SetValue(Health, Value);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetArmor(float Value)
+{
+    SetValue(Armor, Value);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetSpeed(float Value)
+{
+    SetValue(Speed, Value);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetQuadDamageProgress(float ProgressPercent)
+{
+    SetValue(QuadDamageProgress, ProgressPercent);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetProtectionProgress(float ProgressPercent)
+{
+    SetValue(ProtectionProgress, ProgressPercent);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetAbilityCooldownProgress(float ProgressPercent)
+{
+    SetValue(AbilityCooldownProgress, ProgressPercent);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetQuadDamageProgressVisible(bool bFlag)
+{
+    if (bQuadDamageProgressVisible != bFlag)
+    {
+        bQuadDamageProgressVisible = bFlag;
+        bIsVisibilityDirty = true;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::SetProtectionProgressVisible(bool bFlag)
+{
+    if (bProtectionProgressVisible != bFlag)
+    {
+        bProtectionProgressVisible = bFlag;
+        bIsVisibilityDirty = true;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::AddFrameTime(float RealDeltaSeconds)
+{
+    FPSElapsedTime += RealDeltaSeconds;
+    ++FPSFrameCount;
+
+    if (FPSElapsedTime >= FPSWindow)
+    {
+        SetValue(FPS, FPSFrameCount / FPSElapsedTime);
+
+        FPSElapsedTime = 0.0f;
+        FPSFrameCount = 0;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float UQLHUDViewModel::GetFPS() const
+{
+    return FPS.Value;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::Flush()
+{
+    PushValues(false);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLHUDViewModel::PushValues(bool bForce)
+{
+    if (!Widget.IsValid())
+    {
+        return;
+    }
+
+    bool bIsPushed = false;
+
+    if (ConsumeValue(Health, bForce))
+    {
+        Widget->UpdateTextHealthValue(Health.Value);
+        bIsPushed = true;
+    }
+
+    if (ConsumeValue(Armor, bForce))
+    {
+        Widget->UpdateTextArmorValue(Armor.Value);
+        bIsPushed = true;
+    }
+
+    if (ConsumeValue(Speed, bForce))
+    {
+        Widget->SetTextSpeedValue(Speed.Value);
+        bIsPushed = true;
+    }
+
+    if (ConsumeValue(FPS, bForce))
+    {
+        Widget->SetTextFPSValue(FPS.Value);
+        bIsPushed = true;
+    }
+
+    if (ConsumeValue(QuadDamageProgress, bForce))
+    {
+        Widget->UpdateQuadDamageProgress(QuadDamageProgress.Value);
+        bIsPushed = true;
+    }
+
+    if (ConsumeValue(ProtectionProgress, bForce))
+    {
+        Widget->UpdateProtectionDamageProgress(ProtectionProgress.Value);
+        bIsPushed = true;
+    }
+
+    if (ConsumeValue(AbilityCooldownProgress, bForce))
+    {
+        Widget->UpdateAbilityCooldownProgress(AbilityCooldownProgress.Value);
+        bIsPushed = true;
+    }
+
+    if (bIsVisibilityDirty || bForce)
+    {
+        Widget->SetQuadDamageProgressVisibility(bQuadDamageProgressVisible);
+        Widget->SetProtectionProgressVisibility(bProtectionProgressVisible);
+        bIsVisibilityDirty = false;
+        bIsPushed = true;
+    }
+
+    if (bIsPushed)
+    {
+        Widget->InvalidateHUD();
+    }
+}
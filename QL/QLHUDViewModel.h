@@ -0,0 +1,127 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "QLHUDViewModel.generated.h"
+
+class UQLUmgFirstPerson;
+
+//------------------------------------------------------------
+// A value shown on the HUD. The widget only hears about it
+// when the displayed step changes, e.g. the health going from
+// 74.6 to 73.9 is pushed, but not from 74.6 to 74.4.
+//------------------------------------------------------------
+struct FQLHUDValue
+{
+    float Value;
+
+    // smallest change visible on the HUD
+    float Step;
+
+    // step last pushed to the widget
+    int32 DisplayedStep;
+
+    bool bIsDirty;
+};
+
+//------------------------------------------------------------
+// Values displayed by the first person UMG of a player
+// controller. The game code sets the values whenever it likes,
+// the view model pushes the ones whose displayed step changed to
+// the widget once per frame, and invalidates the cached HUD only
+// if something was pushed. A HUD at rest costs nothing but the
+// comparisons.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLHUDViewModel : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UQLHUDViewModel();
+
+    //------------------------------------------------------------
+    // Bind the widget and push every value to it
+    //------------------------------------------------------------
+    void SetWidget(UQLUmgFirstPerson* WidgetExt);
+
+    void SetHealth(float Value);
+
+    void SetArmor(float Value);
+
+    void SetSpeed(float Value);
+
+    void SetQuadDamageProgress(float ProgressPercent);
+
+    void SetProtectionProgress(float ProgressPercent);
+
+    void SetAbilityCooldownProgress(float ProgressPercent);
+
+    void SetQuadDamageProgressVisible(bool bFlag);
+
+    void SetProtectionProgressVisible(bool bFlag);
+
+    //------------------------------------------------------------
+    // Accumulate the frame time, the FPS is averaged over FPSWindow
+    //------------------------------------------------------------
+    void AddFrameTime(float RealDeltaSeconds);
+
+    float GetFPS() const;
+
+    //------------------------------------------------------------
+    // Push the changed values to the widget
+    //------------------------------------------------------------
+    void Flush();
+
+protected:
+    static void InitValue(FQLHUDValue& HUDValue, float Value, float Step);
+
+    static void SetValue(FQLHUDValue& HUDValue, float Value);
+
+    //------------------------------------------------------------
+    // Return true if the value has to be pushed
+    //------------------------------------------------------------
+    static bool ConsumeValue(FQLHUDValue& HUDValue, bool bForce);
+
+    void PushValues(bool bForce);
+
+    UPROPERTY()
+    TWeakObjectPtr<UQLUmgFirstPerson> Widget;
+
+    FQLHUDValue Health;
+
+    FQLHUDValue Armor;
+
+    FQLHUDValue Speed;
+
+    FQLHUDValue FPS;
+
+    FQLHUDValue QuadDamageProgress;
+
+    FQLHUDValue ProtectionProgress;
+
+    FQLHUDValue AbilityCooldownProgress;
+
+    bool bQuadDamageProgressVisible;
+
+    bool bProtectionProgressVisible;
+
+    bool bIsVisibilityDirty;
+
+    // second
+    float FPSWindow;
+
+    float FPSElapsedTime;
+
+    int32 FPSFrameCount;
+};
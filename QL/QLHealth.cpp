@@ -37,7 +37,7 @@ void AQLHealth::OnComponentBeginOverlapImpl(UPrimitiveComponent* OverlappedComp,
             {
                 Character->AddHealth(HealthIncrement);
 
-                PlaySoundFireAndForget("PickUp");
+                PlaySoundFireAndForget("PickUp", EQLSoundCategory::Pickup);
 
                 SetActorEnableCollision(false);
                 SetActorHiddenInGame(true);
@@ -21,6 +21,18 @@
 #include "GameFramework/DamageType.h"
 #include "QLPlayerController.h"
 #include "Engine/DecalActor.h"
+#include "QLDecalManager.h"
+#include "QLGameModeBase.h"
+
+namespace
+{
+    // sound names built once rather than on every hit
+    const FName NailGunHitSoundNameList[] = {
+        FName(TEXT("NailGunHit1")),
+        FName(TEXT("NailGunHit2")),
+        FName(TEXT("NailGunHit3"))
+    };
+}
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -53,7 +65,7 @@ void AQLNailProjectile::PostInitializeComponents()
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void AQLNailProjectile::OnBeginOverlapForComponent(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+bool AQLNailProjectile::ResolveHit(AActor* OtherActor, const FHitResult& HitResult)
 {
     // create bullet hole decal, if the hit actor is not a character
     if (OtherActor)
@@ -61,18 +73,39 @@ void AQLNailProjectile::OnBeginOverlapForComponent(UPrimitiveComponent* Overlapp
         AQLCharacter* Character = Cast<AQLCharacter>(OtherActor);
         if (!Character)
         {
-            FMatrix RotationMatrix = FRotationMatrix::MakeFromZ(SweepResult.ImpactNormal);
+            FMatrix RotationMatrix = FRotationMatrix::MakeFromZ(HitResult.ImpactNormal);
             FRotator Rotation = RotationMatrix.Rotator();
-            ADecalActor* Decal = GetWorld()->SpawnActor<ADecalActor>(DecalClass, SweepResult.ImpactPoint, Rotation);
+
+            // the decal manager caps the number of decals, a world without one spawns a decal actor
+            UQLDecalManager* DecalManager = AQLGameModeBase::GetWorldService<UQLDecalManager>(this);
+            if (DecalManager)
+            {
+                DecalManager->SpawnDecal(DecalClass, HitResult.ImpactPoint, Rotation);
+            }
+            else
+            {
+                GetWorld()->SpawnActor<ADecalActor>(DecalClass, HitResult.ImpactPoint, Rotation);
+            }
         }
     }
 
     // randomly sample from one of 3 nail gun hit sound effects to play
-    int32 Min = 1;
-    int32 Max = 3;
-    int32 Idx = FMath::RandRange(Min, Max);
-    FString SoundName = "NailGunHit" + FString::FromInt(Idx);
-    PlaySoundFireAndForget(FName(*SoundName));
+    int32 Idx = FMath::RandRange(0, ARRAY_COUNT(NailGunHitSoundNameList) - 1);
+    PlaySoundFireAndForget(NailGunHitSoundNameList[Idx], EQLSoundCategory::Impact);
 
-    Super::OnBeginOverlapForComponent(OverlappedComp, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
-}
\ No newline at end of file
+    return Super::ResolveHit(OtherActor, HitResult);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+USphereComponent* AQLNailProjectile::GetRootSphereComponent() const
+{
+    return RootSphereComponent;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UStaticMeshComponent* AQLNailProjectile::GetStaticMeshComponent() const
+{
+    return StaticMeshComponent;
+}
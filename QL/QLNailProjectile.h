@@ -29,11 +29,15 @@ class QL_API AQLNailProjectile : public AQLProjectile
 public:
     AQLNailProjectile();
 
+    virtual bool ResolveHit(AActor* OtherActor, const FHitResult& HitResult) override;
+
+    USphereComponent* GetRootSphereComponent() const;
+
+    UStaticMeshComponent* GetStaticMeshComponent() const;
+
 protected:
     virtual void PostInitializeComponents() override;
 
-    virtual void OnBeginOverlapForComponent(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult) override;
-
     UPROPERTY(EditDefaultsOnly, Category = "C++Property")
     TSubclassOf<ADecalActor> DecalClass;
 };
@@ -0,0 +1,383 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLNailSimulationManager.h"
+#include "QLNailProjectile.h"
+#include "QLPlayerController.h"
+#include "Engine/World.h"
+#include "Components/SphereComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLNailSimulationManager::UQLNailSimulationManager()
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLNailSimulationManager::Deinitialize()
+{
+    // the proxies and the instanced mesh components belong to the level and are destroyed with it
+    PositionList.Empty();
+    VelocityList.Empty();
+    RemainingLifeSpanList.Empty();
+    DamageMultiplierList.Empty();
+    ClassIndexList.Empty();
+    PlayerControllerList.Empty();
+    ShooterList.Empty();
+    NailClassDataList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLNailSimulationManager::AddNail(TSubclassOf<AQLNailProjectile> NailClass,
+    const FVector& Location,
+    const FVector& Velocity,
+    AQLPlayerController* PlayerController,
+    AActor* Shooter,
+    float DamageMultiplier,
+    float InitialAdvanceTime)
+{
+    const int32 ClassIndex = FindOrAddNailClass(NailClass);
+    if (ClassIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    PositionList.Add(Location);
+    VelocityList.Add(Velocity);
+    RemainingLifeSpanList.Add(NailClassDataList[ClassIndex].LifeSpan);
+    DamageMultiplierList.Add(DamageMultiplier);
+    ClassIndexList.Add(ClassIndex);
+    PlayerControllerList.Add(PlayerController);
+    ShooterList.Add(Shooter);
+
+    // catch up with the time elapsed since the shot
+    if (InitialAdvanceTime > 0.0f)
+    {
+        const int32 Index = PositionList.Num() - 1;
+
+        FHitResult HitResult;
+        if (AdvanceNail(Index, InitialAdvanceTime, HitResult))
+        {
+            if (ResolveNailHit(Index, HitResult))
+            {
+                RemoveNail(Index);
+            }
+            else
+            {
+                PositionList[Index] = HitResult.TraceEnd;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLNailSimulationManager::GetNailCount() const
+{
+    return PositionList.Num();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLNailSimulationManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    RemovalList.Reset();
+
+    // advance and sweep all nails in one pass
+    for (int32 Index = 0; Index < PositionList.Num(); ++Index)
+    {
+        RemainingLifeSpanList[Index] -= DeltaTime;
+
+        FHitResult HitResult;
+        if (AdvanceNail(Index, DeltaTime, HitResult))
+        {
+            if (ResolveNailHit(Index, HitResult))
+            {
+                RemovalList.Add(Index);
+                continue;
+            }
+
+            // the hit is ignored, keep flying
+            PositionList[Index] = HitResult.TraceEnd;
+        }
+
+        // an expired nail explodes, as AQLProjectile does when its lifespan ends
+        if (RemainingLifeSpanList[Index] <= 0.0f)
+        {
+            ExplodeNail(Index, PositionList[Index]);
+            RemovalList.Add(Index);
+        }
+    }
+
+    // remove from the back, so that the nail swapped into a removed slot is never itself pending removal
+    for (int32 Index = RemovalList.Num() - 1; Index >= 0; --Index)
+    {
+        RemoveNail(RemovalList[Index]);
+    }
+
+    UpdateInstances();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLNailSimulationManager::FindOrAddNailClass(TSubclassOf<AQLNailProjectile> NailClass)
+{
+    if (!NailClass)
+    {
+        return INDEX_NONE;
+    }
+
+    for (int32 Index = 0; Index < NailClassDataList.Num(); ++Index)
+    {
+        if (NailClassDataList[Index].NailClass == NailClass)
+        {
+            return Index;
+        }
+    }
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return INDEX_NONE;
+    }
+
+    // the class default object holds the properties set in Blueprint
+    AQLNailProjectile* DefaultNail = NailClass->GetDefaultObject<AQLNailProjectile>();
+    if (!DefaultNail)
+    {
+        return INDEX_NONE;
+    }
+
+    FQLNailClassData Data;
+    Data.NailClass = NailClass;
+    Data.LifeSpan = DefaultNail->GetProjectileLifeSpan();
+    Data.SweepRadius = 20.0f;
+    Data.MeshRelativeTransform = FTransform::Identity;
+
+    USphereComponent* DefaultSphere = DefaultNail->GetRootSphereComponent();
+    if (DefaultSphere)
+    {
+        Data.SweepRadius = DefaultSphere->GetUnscaledSphereRadius();
+    }
+
+    FActorSpawnParameters SpawnParameters;
+    SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    // park the hit proxy like a pooled actor: hidden, without collision, tick, movement or lifespan
+    AQLNailProjectile* HitProxy = World->SpawnActor<AQLNailProjectile>(NailClass, FTransform::Identity, SpawnParameters);
+    if (HitProxy)
+    {
+        HitProxy->OnReleasedToPool();
+    }
+    Data.HitProxy = HitProxy;
+
+    // one instanced mesh component draws all the nails of the class
+    UStaticMeshComponent* DefaultMesh = DefaultNail->GetStaticMeshComponent();
+    if (DefaultMesh && DefaultMesh->GetStaticMesh())
+    {
+        AActor* HostActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+        if (HostActor)
+        {
+            UInstancedStaticMeshComponent* InstancedMeshComponent = NewObject<UInstancedStaticMeshComponent>(HostActor);
+            InstancedMeshComponent->SetMobility(EComponentMobility::Movable);
+            InstancedMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+            InstancedMeshComponent->SetStaticMesh(DefaultMesh->GetStaticMesh());
+            for (int32 MaterialIndex = 0; MaterialIndex < DefaultMesh->GetNumMaterials(); ++MaterialIndex)
+            {
+                InstancedMeshComponent->SetMaterial(MaterialIndex, DefaultMesh->GetMaterial(MaterialIndex));
+            }
+            InstancedMeshComponent->CastShadow = DefaultMesh->CastShadow;
+
+            HostActor->SetRootComponent(InstancedMeshComponent);
+            InstancedMeshComponent->RegisterComponent();
+
+            Data.InstancedMeshComponent = InstancedMeshComponent;
+            Data.MeshRelativeTransform = DefaultMesh->GetRelativeTransform();
+        }
+    }
+
+    return NailClassDataList.Add(Data);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLNailSimulationManager::AdvanceNail(int32 Index, float DeltaTime, FHitResult& OutHitResult)
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return false;
+    }
+
+    const FQLNailClassData& Data = NailClassDataList[ClassIndexList[Index]];
+    const FVector Start = PositionList[Index];
+    const FVector End = Start + VelocityList[Index] * DeltaTime;
+
+    FCollisionQueryParams Params(FName(TEXT("nailSweep")), false);
+
+    // self-hit exclusion, see AQLProjectile::HandleDirectHit()
+    if (ShooterList[Index].IsValid())
+    {
+        Params.AddIgnoredActor(ShooterList[Index].Get());
+    }
+
+    if (Data.HitProxy.IsValid())
+    {
+        Params.AddIgnoredActor(Data.HitProxy.Get());
+    }
+
+    // the nail actor overlaps everything as a world dynamic object,
+    // so gather every overlap along the way and take the first one
+    TArray<FHitResult> HitResultList;
+    World->SweepMultiByChannel(HitResultList,
+        Start,
+        End,
+        FQuat::Identity,
+        ECollisionChannel::ECC_WorldDynamic,
+        FCollisionShape::MakeSphere(Data.SweepRadius),
+        Params,
+        FCollisionResponseParams(ECollisionResponse::ECR_Overlap));
+
+    PositionList[Index] = End;
+
+    for (auto&& HitResult : HitResultList)
+    {
+        if (HitResult.GetActor())
+        {
+            OutHitResult = HitResult;
+            PositionList[Index] = HitResult.Location;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLNailSimulationManager::ResolveNailHit(int32 Index, const FHitResult& HitResult)
+{
+    const FQLNailClassData& Data = NailClassDataList[ClassIndexList[Index]];
+
+    AQLNailProjectile* HitProxy = Data.HitProxy.Get();
+    if (!HitProxy)
+    {
+        return true;
+    }
+
+    // the proxy stands in for the nail at the impact point
+    HitProxy->SetActorLocation(HitResult.Location);
+    HitProxy->QLSetPlayerController(PlayerControllerList[Index].Get());
+    HitProxy->SetDamageMultiplier(DamageMultiplierList[Index]);
+
+    const bool bHit = HitProxy->ResolveHit(HitResult.GetActor(), HitResult);
+    if (bHit)
+    {
+        HitProxy->PlayExplosionEffect();
+    }
+
+    // forget the shooter and the splash victims
+    HitProxy->OnReleasedToPool();
+
+    return bHit;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLNailSimulationManager::ExplodeNail(int32 Index, const FVector& Location)
+{
+    const FQLNailClassData& Data = NailClassDataList[ClassIndexList[Index]];
+
+    AQLNailProjectile* HitProxy = Data.HitProxy.Get();
+    if (HitProxy)
+    {
+        HitProxy->SetActorLocation(Location);
+        HitProxy->PlayExplosionEffect();
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLNailSimulationManager::RemoveNail(int32 Index)
+{
+    PositionList.RemoveAtSwap(Index, 1, false);
+    VelocityList.RemoveAtSwap(Index, 1, false);
+    RemainingLifeSpanList.RemoveAtSwap(Index, 1, false);
+    DamageMultiplierList.RemoveAtSwap(Index, 1, false);
+    ClassIndexList.RemoveAtSwap(Index, 1, false);
+    PlayerControllerList.RemoveAtSwap(Index, 1, false);
+    ShooterList.RemoveAtSwap(Index, 1, false);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLNailSimulationManager::UpdateInstances()
+{
+    for (auto&& Data : NailClassDataList)
+    {
+        Data.InstanceTransformList.Reset();
+    }
+
+    for (int32 Index = 0; Index < PositionList.Num(); ++Index)
+    {
+        FQLNailClassData& Data = NailClassDataList[ClassIndexList[Index]];
+        const FTransform NailTransform(VelocityList[Index].Rotation(), PositionList[Index]);
+        Data.InstanceTransformList.Add(Data.MeshRelativeTransform * NailTransform);
+    }
+
+    for (auto&& Data : NailClassDataList)
+    {
+        UInstancedStaticMeshComponent* InstancedMeshComponent = Data.InstancedMeshComponent.Get();
+        if (!InstancedMeshComponent)
+        {
+            continue;
+        }
+
+        const int32 NailCount = Data.InstanceTransformList.Num();
+        if (NailCount == 0 && InstancedMeshComponent->GetInstanceCount() == 0)
+        {
+            continue;
+        }
+
+        while (InstancedMeshComponent->GetInstanceCount() > NailCount)
+        {
+            InstancedMeshComponent->RemoveInstance(InstancedMeshComponent->GetInstanceCount() - 1);
+        }
+
+        for (int32 InstanceIndex = 0; InstanceIndex < NailCount; ++InstanceIndex)
+        {
+            const FTransform& InstanceTransform = Data.InstanceTransformList[InstanceIndex];
+
+            if (InstanceIndex < InstancedMeshComponent->GetInstanceCount())
+            {
+                InstancedMeshComponent->UpdateInstanceTransform(InstanceIndex,
+                    InstanceTransform,
+                    true, // world space
+                    false, // mark render state dirty
+                    true); // teleport
+            }
+            else
+            {
+                InstancedMeshComponent->AddInstanceWorldSpace(InstanceTransform);
+            }
+        }
+
+        InstancedMeshComponent->MarkRenderStateDirty();
+    }
+}
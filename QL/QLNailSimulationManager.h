@@ -0,0 +1,118 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLNailSimulationManager.generated.h"
+
+class AQLNailProjectile;
+class AQLPlayerController;
+class UInstancedStaticMeshComponent;
+
+//------------------------------------------------------------
+// Shared data of the nails of one projectile class
+//------------------------------------------------------------
+struct FQLNailClassData
+{
+    TSubclassOf<AQLNailProjectile> NailClass;
+
+    // hidden nail actor used to apply the hit logic of AQLNailProjectile
+    // (direct hit, splash, decal, sound, explosion) at the impact point
+    TWeakObjectPtr<AQLNailProjectile> HitProxy;
+
+    // draws all the nails of this class in one go
+    TWeakObjectPtr<UInstancedStaticMeshComponent> InstancedMeshComponent;
+
+    FTransform MeshRelativeTransform;
+
+    float SweepRadius;
+
+    float LifeSpan;
+
+    // scratch buffer of the instance transforms
+    TArray<FTransform> InstanceTransformList;
+};
+
+//------------------------------------------------------------
+// Simulate nails without spawning one actor per nail.
+// The nails are stored in structure-of-arrays buffers, advanced
+// and swept in a single pass every frame, and rendered with one
+// instanced static mesh component per nail class. A hit is
+// resolved by a hidden nail actor so that the behavior of
+// AQLNailProjectile is kept as is.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLNailSimulationManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLNailSimulationManager();
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    //------------------------------------------------------------
+    // Launch a nail from Location. The nail is advanced right away
+    // by InitialAdvanceTime to account for a sub-frame shot.
+    //------------------------------------------------------------
+    void AddNail(TSubclassOf<AQLNailProjectile> NailClass,
+        const FVector& Location,
+        const FVector& Velocity,
+        AQLPlayerController* PlayerController,
+        AActor* Shooter,
+        float DamageMultiplier,
+        float InitialAdvanceTime = 0.0f);
+
+    int32 GetNailCount() const;
+
+protected:
+    int32 FindOrAddNailClass(TSubclassOf<AQLNailProjectile> NailClass);
+
+    //------------------------------------------------------------
+    // Sweep nail Index over DeltaTime. Return true if it hits something.
+    //------------------------------------------------------------
+    bool AdvanceNail(int32 Index, float DeltaTime, FHitResult& OutHitResult);
+
+    //------------------------------------------------------------
+    // Apply the hit logic of the nail class at the impact point.
+    // Return false if the hit is ignored and the nail keeps flying.
+    //------------------------------------------------------------
+    bool ResolveNailHit(int32 Index, const FHitResult& HitResult);
+
+    void ExplodeNail(int32 Index, const FVector& Location);
+
+    void RemoveNail(int32 Index);
+
+    void UpdateInstances();
+
+    // structure of arrays, one entry per nail
+    TArray<FVector> PositionList;
+
+    TArray<FVector> VelocityList;
+
+    TArray<float> RemainingLifeSpanList;
+
+    TArray<float> DamageMultiplierList;
+
+    TArray<int32> ClassIndexList;
+
+    TArray<TWeakObjectPtr<AQLPlayerController>> PlayerControllerList;
+
+    TArray<TWeakObjectPtr<AActor>> ShooterList;
+
+    TArray<FQLNailClassData> NailClassDataList;
+
+    // scratch buffer of the nails to be removed at the end of the frame
+    TArray<int32> RemovalList;
+};
@@ -0,0 +1,372 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLPatrolPointManager.h"
+#include "QLGameModeBase.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLPatrolPointCount(
+    TEXT("ql.PatrolPointCount"),
+    256,
+    TEXT("Number of patrol points sampled from the navmesh."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarQLPatrolPointWorkPerFrame(
+    TEXT("ql.PatrolPointWorkPerFrame"),
+    16,
+    TEXT("Maximum number of navmesh queries spent on building the patrol points per frame."),
+    ECVF_Default);
+
+namespace
+{
+    // same as the former random reachable point query of the patrol task
+    const float PatrolRadius = 1000.0f;
+
+    const float PatrolPointMinSpacing = 400.0f;
+
+    // the links of a point are tested from the nearest neighbor on
+    const int32 MaxLinkTestCount = 16;
+
+    // refinement of the returned location, so that the bots sharing a point do not stack
+    const float PatrolJitterRadius = 150.0f;
+
+    const FVector ProjectionExtent(50.0f, 50.0f, 250.0f);
+}
+
+//------------------------------------------------------------
+// Print the size of the patrol point pool of the world
+//------------------------------------------------------------
+static void LogPatrolPointStats(UWorld* World)
+{
+    UQLPatrolPointManager* PatrolPointManager = AQLGameModeBase::GetWorldService<UQLPatrolPointManager>(World);
+    if (PatrolPointManager)
+    {
+        PatrolPointManager->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLPatrolPointStatsCommand(
+    TEXT("ql.PatrolPointStats"),
+    TEXT("Print the number of patrol points, links and cells, and the progress of the build."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogPatrolPointStats));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLPatrolPointManager::UQLPatrolPointManager() :
+ValidPointCount(0),
+SampleAttemptCount(0),
+ValidateCursor(0),
+LinkCursor(0)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPatrolPointManager::Initialize()
+{
+    Super::Initialize();
+
+    UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+    if (NavSys)
+    {
+        NavSys->OnNavigationGenerationFinishedDelegate.AddDynamic(this, &UQLPatrolPointManager::OnNavigationGenerationFinished);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPatrolPointManager::Deinitialize()
+{
+    UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+    if (NavSys)
+    {
+        NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UQLPatrolPointManager::OnNavigationGenerationFinished);
+    }
+
+    PointList.Empty();
+    CellMap.Empty();
+    ValidPointCount = 0;
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPatrolPointManager::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+    // keep serving the current points while they are revalidated, topped up and relinked
+    ValidateCursor = 0;
+    LinkCursor = 0;
+    SampleAttemptCount = 0;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPatrolPointManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    const int32 PointCount = FMath::Max(CVarQLPatrolPointCount.GetValueOnGameThread(), 1);
+    const int32 WorkPerFrame = FMath::Max(CVarQLPatrolPointWorkPerFrame.GetValueOnGameThread(), 1);
+    int32 WorkCount = 0;
+
+    while (WorkCount < WorkPerFrame)
+    {
+        if (ValidateCursor < PointList.Num())
+        {
+            WorkCount += ValidatePoint(ValidateCursor);
+            ++ValidateCursor;
+        }
+        else if (ValidPointCount < PointCount && SampleAttemptCount < 4 * PointCount)
+        {
+            WorkCount += SamplePoint();
+            ++SampleAttemptCount;
+        }
+        else if (LinkCursor < PointList.Num())
+        {
+            WorkCount += LinkPoint(LinkCursor);
+            ++LinkCursor;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLPatrolPointManager::SamplePoint()
+{
+    UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+    if (!NavSys)
+    {
+        return 1;
+    }
+
+    // the navmesh may not be built yet, the build resumes when it is
+    FNavLocation NavLocation;
+    if (!NavSys->GetRandomPoint(NavLocation))
+    {
+        return 1;
+    }
+
+    // spread the points over the map
+    if (FindNearestPoint(NavLocation.Location, PatrolPointMinSpacing) != INDEX_NONE)
+    {
+        return 1;
+    }
+
+    const int32 PointIndex = PointList.Add({ NavLocation.Location, TArray<int32>(), true });
+    CellMap.FindOrAdd(GetCell(NavLocation.Location)).Add(PointIndex);
+    ++ValidPointCount;
+
+    return 1;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLPatrolPointManager::ValidatePoint(int32 PointIndex)
+{
+    FQLPatrolPoint& Point = PointList[PointIndex];
+    if (!Point.bIsValid)
+    {
+        return 0;
+    }
+
+    UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+    if (!NavSys)
+    {
+        return 1;
+    }
+
+    FNavLocation NavLocation;
+    if (NavSys->ProjectPointToNavigation(Point.Location, NavLocation, ProjectionExtent))
+    {
+        // within the extent, the point stays in its cell
+        Point.Location = NavLocation.Location;
+        return 1;
+    }
+
+    Point.bIsValid = false;
+    Point.LinkList.Empty();
+    --ValidPointCount;
+
+    TArray<int32>* CellPointList = CellMap.Find(GetCell(Point.Location));
+    if (CellPointList)
+    {
+        CellPointList->RemoveSwap(PointIndex);
+    }
+
+    return 1;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLPatrolPointManager::LinkPoint(int32 PointIndex)
+{
+    FQLPatrolPoint& Point = PointList[PointIndex];
+    if (!Point.bIsValid)
+    {
+        return 0;
+    }
+
+    const FIntPoint Cell = GetCell(Point.Location);
+
+    // the neighbors within the patrol radius, nearest first
+    TArray<TPair<float, int32>> NeighborList;
+    for (int32 X = Cell.X - 1; X <= Cell.X + 1; ++X)
+    {
+        for (int32 Y = Cell.Y - 1; Y <= Cell.Y + 1; ++Y)
+        {
+            const TArray<int32>* CellPointList = CellMap.Find(FIntPoint(X, Y));
+            if (!CellPointList)
+            {
+                continue;
+            }
+
+            for (int32 NeighborIndex : *CellPointList)
+            {
+                const float DistanceSquared = FVector::DistSquared(Point.Location, PointList[NeighborIndex].Location);
+                if (NeighborIndex != PointIndex && DistanceSquared <= PatrolRadius * PatrolRadius)
+                {
+                    NeighborList.Add(TPair<float, int32>(DistanceSquared, NeighborIndex));
+                }
+            }
+        }
+    }
+
+    NeighborList.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+    // a straight walk on the navmesh, far cheaper than a path query
+    TArray<int32> NewLinkList;
+    const int32 TestCount = FMath::Min(NeighborList.Num(), MaxLinkTestCount);
+    for (int32 Index = 0; Index < TestCount; ++Index)
+    {
+        const int32 NeighborIndex = NeighborList[Index].Value;
+
+        FVector HitLocation;
+        const bool bBlocked = UNavigationSystemV1::NavigationRaycast(this, Point.Location, PointList[NeighborIndex].Location, HitLocation);
+        if (!bBlocked)
+        {
+            NewLinkList.Add(NeighborIndex);
+        }
+    }
+
+    // the point may be queried while the other points are relinked
+    PointList[PointIndex].LinkList = MoveTemp(NewLinkList);
+
+    return FMath::Max(TestCount, 1);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FIntPoint UQLPatrolPointManager::GetCell(const FVector& Location) const
+{
+    return FIntPoint(FMath::FloorToInt(Location.X / PatrolRadius), FMath::FloorToInt(Location.Y / PatrolRadius));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLPatrolPointManager::FindNearestPoint(const FVector& Location, float MaxDistance) const
+{
+    const FIntPoint Cell = GetCell(Location);
+
+    int32 NearestIndex = INDEX_NONE;
+    float NearestDistanceSquared = MaxDistance * MaxDistance;
+
+    for (int32 X = Cell.X - 1; X <= Cell.X + 1; ++X)
+    {
+        for (int32 Y = Cell.Y - 1; Y <= Cell.Y + 1; ++Y)
+        {
+            const TArray<int32>* CellPointList = CellMap.Find(FIntPoint(X, Y));
+            if (!CellPointList)
+            {
+                continue;
+            }
+
+            for (int32 PointIndex : *CellPointList)
+            {
+                const float DistanceSquared = FVector::DistSquared(Location, PointList[PointIndex].Location);
+                if (DistanceSquared < NearestDistanceSquared)
+                {
+                    NearestDistanceSquared = DistanceSquared;
+                    NearestIndex = PointIndex;
+                }
+            }
+        }
+    }
+
+    return NearestIndex;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLPatrolPointManager::GetPatrolLocation(const FVector& From, FVector& OutLocation) const
+{
+    const int32 NearestIndex = FindNearestPoint(From, PatrolRadius);
+    if (NearestIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    const TArray<int32>& LinkList = PointList[NearestIndex].LinkList;
+    if (LinkList.Num() == 0)
+    {
+        return false;
+    }
+
+    const FQLPatrolPoint& Target = PointList[LinkList[QLUtility::RandRange(0, LinkList.Num() - 1)]];
+    if (!Target.bIsValid)
+    {
+        return false;
+    }
+
+    OutLocation = Target.Location;
+
+    UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
+    if (NavSys)
+    {
+        const FVector Jitter(QLUtility::RandRange(-PatrolJitterRadius, PatrolJitterRadius), QLUtility::RandRange(-PatrolJitterRadius, PatrolJitterRadius), 0.0f);
+
+        FNavLocation NavLocation;
+        if (NavSys->ProjectPointToNavigation(Target.Location + Jitter, NavLocation, ProjectionExtent))
+        {
+            OutLocation = NavLocation.Location;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPatrolPointManager::LogStats() const
+{
+    int32 LinkCount = 0;
+    for (const FQLPatrolPoint& Point : PointList)
+    {
+        LinkCount += Point.LinkList.Num();
+    }
+
+    QLUtility::Log(FString::Printf(TEXT("patrol points: %d valid of %d sampled, %d links, %d cells, validated %d/%d, linked %d/%d"),
+        ValidPointCount,
+        PointList.Num(),
+        LinkCount,
+        CellMap.Num(),
+        ValidateCursor,
+        PointList.Num(),
+        LinkCursor,
+        PointList.Num()));
+}
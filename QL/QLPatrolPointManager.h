@@ -0,0 +1,103 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLPatrolPointManager.generated.h"
+
+class ANavigationData;
+
+//------------------------------------------------------------
+// A navmesh location the bots patrol to
+//------------------------------------------------------------
+struct FQLPatrolPoint
+{
+    FVector Location;
+
+    // points reachable in a straight walk on the navmesh
+    TArray<int32> LinkList;
+
+    // false once the navmesh under the point is gone
+    bool bIsValid;
+};
+
+//------------------------------------------------------------
+// Patrol points sampled from the navmesh, bucketed in a grid of
+// cells as large as the patrol radius, and linked into a graph
+// by navmesh raycasts. GetPatrolLocation() looks up the nearest
+// point in the 3x3 cells around the bot and returns one of its
+// links, slightly jittered, instead of flooding the navmesh for
+// every patrol decision.
+//
+// The pool is built a few navmesh queries per frame from the
+// start of the match, see ql.PatrolPointWorkPerFrame. When the
+// navmesh is rebuilt at runtime, the points are revalidated and
+// relinked the same way, without dropping the pool.
+// ql.PatrolPointStats prints the size of the pool and graph.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLPatrolPointManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLPatrolPointManager();
+
+    virtual void Initialize() override;
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    //------------------------------------------------------------
+    // Return false if no point is linked near From yet,
+    // in which case the caller should query the navmesh itself
+    //------------------------------------------------------------
+    bool GetPatrolLocation(const FVector& From, FVector& OutLocation) const;
+
+    void LogStats() const;
+
+protected:
+    UFUNCTION()
+    void OnNavigationGenerationFinished(ANavigationData* NavData);
+
+    //------------------------------------------------------------
+    // Return the number of navmesh queries spent
+    //------------------------------------------------------------
+    int32 SamplePoint();
+
+    int32 ValidatePoint(int32 PointIndex);
+
+    int32 LinkPoint(int32 PointIndex);
+
+    FIntPoint GetCell(const FVector& Location) const;
+
+    //------------------------------------------------------------
+    // Nearest valid point in the 3x3 cells around Location
+    //------------------------------------------------------------
+    int32 FindNearestPoint(const FVector& Location, float MaxDistance) const;
+
+    TArray<FQLPatrolPoint> PointList;
+
+    // point indices of each cell
+    TMap<FIntPoint, TArray<int32>> CellMap;
+
+    int32 ValidPointCount;
+
+    int32 SampleAttemptCount;
+
+    // next point to revalidate after a navmesh change
+    int32 ValidateCursor;
+
+    // next point to (re)link, every point is linked when it reaches PointList.Num()
+    int32 LinkCursor;
+};
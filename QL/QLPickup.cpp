@@ -19,11 +19,14 @@
 #include "Animation/AnimMontage.h"
 #include "Animation/AnimInstance.h"
 #include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
 #include "QLPlayerController.h"
 #include "QLWeaponManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "QLUtility.h"
 #include "TimerManager.h"
+#include "QLGameModeBase.h"
+#include "QLPickupAnimationManager.h"
 
 //------------------------------------------------------------
 // Sets default values
@@ -32,6 +35,8 @@ AQLPickup::AQLPickup()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
+    // idle pickups are animated by the pickup animation manager
+    PrimaryActorTick.bStartWithTickEnabled = false;
 
     RootSphereComponent = CreateDefaultSubobject<USphereComponent>(TEXT("RootSphereComponent"));
     RootSphereComponent->InitSphereRadius(40.0f);
@@ -54,6 +59,7 @@ AQLPickup::AQLPickup()
     GlowColor = FLinearColor(0.0f, 0.0f, 1.0f);
 
     bStartRotationInterp = false;
+    bIsAnimatedByManager = false;
 }
 
 //------------------------------------------------------------
@@ -63,7 +69,21 @@ void AQLPickup::BeginPlay()
 {
 	Super::BeginPlay();
 
+    UQLPickupAnimationManager* AnimationManager = AQLGameModeBase::GetWorldService<UQLPickupAnimationManager>(this);
+    bIsAnimatedByManager = (AnimationManager != nullptr);
+    if (!bIsAnimatedByManager)
+    {
+        SetActorTickEnabled(true);
+    }
+
     SetConstantRotationEnabled(true);
+
+    // a fire-and-forget sound needs an attenuation
+    UQLAudioManager* AudioManager = AQLGameModeBase::GetWorldService<UQLAudioManager>(this);
+    if (AudioManager && SoundAttenuation)
+    {
+        AudioManager->ResolveSoundList(SoundList, SoundAttenuation, SoundHandleList);
+    }
 }
 
 //------------------------------------------------------------
@@ -73,6 +93,15 @@ void AQLPickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
     Super::EndPlay(EndPlayReason);
 
     GetWorldTimerManager().ClearAllTimersForObject(this);
+
+    if (bIsAnimatedByManager)
+    {
+        UQLPickupAnimationManager* AnimationManager = AQLGameModeBase::GetWorldService<UQLPickupAnimationManager>(this);
+        if (AnimationManager)
+        {
+            AnimationManager->StopAnimation(this);
+        }
+    }
 }
 
 //------------------------------------------------------------
@@ -82,6 +111,11 @@ void AQLPickup::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+    if (bIsAnimatedByManager)
+    {
+        return;
+    }
+
     // constant rotation
     if (bConstantlyRotating)
     {
@@ -146,8 +180,19 @@ void AQLPickup::PlayAnimationMontage(const FName& AnimationMontageName)
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void AQLPickup::PlaySoundFireAndForget(const FName& SoundName)
+void AQLPickup::PlaySoundFireAndForget(const FName& SoundName, EQLSoundCategory SoundCategory)
 {
+    UQLAudioManager* AudioManager = AQLGameModeBase::GetWorldService<UQLAudioManager>(this);
+    if (AudioManager)
+    {
+        const FQLSoundHandle* SoundHandle = SoundHandleList.Find(SoundName);
+        if (SoundHandle)
+        {
+            AudioManager->PlaySoundAtLocation(*SoundHandle, GetActorLocation(), SoundCategory);
+        }
+        return;
+    }
+
     USoundBase** Result = SoundList.Find(SoundName);
     if (Result)
     {
@@ -201,6 +246,40 @@ void AQLPickup::StopSound()
 void AQLPickup::SetConstantRotationEnabled(const bool bFlag)
 {
     bConstantlyRotating = bFlag;
+
+    if (!bIsAnimatedByManager)
+    {
+        return;
+    }
+
+    UQLPickupAnimationManager* AnimationManager = AQLGameModeBase::GetWorldService<UQLPickupAnimationManager>(this);
+    if (!AnimationManager)
+    {
+        return;
+    }
+
+    if (bConstantlyRotating && !RotationRate.IsZero())
+    {
+        AnimationManager->StartConstantRotation(this, RotationRate);
+    }
+    else
+    {
+        AnimationManager->StopAnimation(this);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLPickup::IsConstantlyRotating() const
+{
+    return bConstantlyRotating;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FRotator AQLPickup::GetRotationRate() const
+{
+    return RotationRate;
 }
 
 //------------------------------------------------------------
@@ -286,5 +365,28 @@ void AQLPickup::PerformRotationInterpWithDelay(const float Delay)
 //------------------------------------------------------------
 void AQLPickup::PerformRotationInterpCallback()
 {
+    if (bIsAnimatedByManager)
+    {
+        UQLPickupAnimationManager* AnimationManager = AQLGameModeBase::GetWorldService<UQLPickupAnimationManager>(this);
+        if (AnimationManager)
+        {
+            AnimationManager->StartRotationInterp(this, 100.0f);
+            return;
+        }
+    }
+
     bStartRotationInterp = true;
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLPickup::GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const
+{
+    for (const auto& Item : SoundList)
+    {
+        if (Item.Value)
+        {
+            OutAssetList.AddUnique(Item.Value);
+        }
+    }
+}
@@ -12,6 +12,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "QLAudioManager.h"
 #include "QLPickup.generated.h"
 
 class UBoxComponent;
@@ -33,8 +34,11 @@ public:
     // Called every frame
     virtual void Tick(float DeltaTime) override;
 
+    //------------------------------------------------------------
+    // Played by the audio manager of the world, if any
+    //------------------------------------------------------------
     UFUNCTION(BlueprintCallable, Category = "C++Function")
-    void PlaySoundFireAndForget(const FName& SoundName);
+    void PlaySoundFireAndForget(const FName& SoundName, EQLSoundCategory SoundCategory = EQLSoundCategory::Default);
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void PlaySound(const FName& SoundName);
@@ -45,9 +49,19 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     virtual void PlayAnimationMontage(const FName& AnimationMontageName);
 
+    //------------------------------------------------------------
+    // The rotation is driven by UQLPickupAnimationManager, or by
+    // Tick() when the game mode has no world services
+    //------------------------------------------------------------
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void SetConstantRotationEnabled(const bool bFlag);
 
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    bool IsConstantlyRotating() const;
+
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    FRotator GetRotationRate() const;
+
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     USphereComponent* GetRootSphereComponent();
 
@@ -72,11 +86,17 @@ public:
 
     //------------------------------------------------------------
     // After Delay seconds, perform PerformRotationInterpCallback()
-    // which sets bStartRotationInterp to true, and performs rotation interpolation
-    // in Tick() until the rotation becomes FRotator::ZeroRotator
+    // which interpolates the rotation until it becomes FRotator::ZeroRotator
     //------------------------------------------------------------
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void PerformRotationInterpWithDelay(const float Delay);
+
+    //------------------------------------------------------------
+    // Particle systems and sounds used by the class, warmed up once
+    // the class is preloaded, see UQLAssetPreloadManager.
+    // Called on the class default object.
+    //------------------------------------------------------------
+    virtual void GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const;
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -124,6 +144,9 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     TMap<FName, USoundBase*> SoundList;
 
+    // SoundList resolved by the audio manager
+    TMap<FName, FQLSoundHandle> SoundHandleList;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     USoundAttenuation* SoundAttenuation;
 
@@ -155,4 +178,7 @@ protected:
     FTimerHandle StartRotationDelayTimerHandle;
 
     bool bStartRotationInterp;
+
+    // false if the pickup animation manager is not available
+    bool bIsAnimatedByManager;
 };
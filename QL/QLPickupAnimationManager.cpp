@@ -0,0 +1,161 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLPickupAnimationManager.h"
+#include "QLPickup.h"
+#include "Engine/World.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLPickupAnimationManager::UQLPickupAnimationManager()
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPickupAnimationManager::Deinitialize()
+{
+    EntryList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FQLPickupAnimationEntry& UQLPickupAnimationManager::FindOrAddEntry(AQLPickup* Pickup)
+{
+    for (FQLPickupAnimationEntry& Entry : EntryList)
+    {
+        if (Entry.Pickup.Get() == Pickup)
+        {
+            return Entry;
+        }
+    }
+
+    const int32 Index = EntryList.AddDefaulted();
+    FQLPickupAnimationEntry& Entry = EntryList[Index];
+    Entry.Pickup = Pickup;
+    Entry.RotationRate = FRotator::ZeroRotator;
+    Entry.InterpSpeed = 0.0f;
+    return Entry;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPickupAnimationManager::StartConstantRotation(AQLPickup* Pickup, const FRotator& RotationRate)
+{
+    UWorld* World = GetWorld();
+    if (!Pickup || !World)
+    {
+        return;
+    }
+
+    FQLPickupAnimationEntry& Entry = FindOrAddEntry(Pickup);
+    Entry.Animation = EQLPickupAnimation::ConstantRotation;
+    Entry.StartRotation = Pickup->GetActorRotation();
+    Entry.StartTime = World->GetTimeSeconds();
+    Entry.RotationRate = RotationRate;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPickupAnimationManager::StartRotationInterp(AQLPickup* Pickup, float InterpSpeed)
+{
+    if (!Pickup)
+    {
+        return;
+    }
+
+    FQLPickupAnimationEntry& Entry = FindOrAddEntry(Pickup);
+    Entry.Animation = EQLPickupAnimation::RotationInterp;
+    Entry.InterpSpeed = InterpSpeed;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPickupAnimationManager::StopAnimation(AQLPickup* Pickup)
+{
+    for (int32 Index = 0; Index < EntryList.Num(); ++Index)
+    {
+        if (EntryList[Index].Pickup.Get() == Pickup)
+        {
+            EntryList.RemoveAtSwap(Index);
+            return;
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLPickupAnimationManager::GetAnimatedPickupCount() const
+{
+    return EntryList.Num();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPickupAnimationManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    const float CurrentTime = World->GetTimeSeconds();
+
+    for (int32 Index = EntryList.Num() - 1; Index >= 0; --Index)
+    {
+        FQLPickupAnimationEntry& Entry = EntryList[Index];
+
+        AQLPickup* Pickup = Entry.Pickup.Get();
+        if (!Pickup || Pickup->IsPendingKill())
+        {
+            EntryList.RemoveAtSwap(Index);
+            continue;
+        }
+
+        if (Entry.Animation == EQLPickupAnimation::ConstantRotation)
+        {
+            // nobody sees it spin
+            if (!Pickup->WasRecentlyRendered(0.2f))
+            {
+                continue;
+            }
+
+            const float ElapsedTime = CurrentTime - Entry.StartTime;
+            const FRotator Rotation = Entry.StartRotation + (Entry.RotationRate * ElapsedTime).GetNormalized();
+            Pickup->SetActorRotation(Rotation);
+        }
+        else
+        {
+            const FRotator Rotation = FMath::RInterpConstantTo(Pickup->GetActorRotation(), FRotator::ZeroRotator, DeltaTime, Entry.InterpSpeed);
+            Pickup->SetActorRotation(Rotation);
+
+            if (Rotation.Equals(FRotator::ZeroRotator))
+            {
+                if (Pickup->IsConstantlyRotating() && !Pickup->GetRotationRate().IsZero())
+                {
+                    Entry.Animation = EQLPickupAnimation::ConstantRotation;
+                    Entry.StartRotation = FRotator::ZeroRotator;
+                    Entry.StartTime = CurrentTime;
+                    Entry.RotationRate = Pickup->GetRotationRate();
+                }
+                else
+                {
+                    EntryList.RemoveAtSwap(Index);
+                }
+            }
+        }
+    }
+}
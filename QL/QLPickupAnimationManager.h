@@ -0,0 +1,82 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLPickupAnimationManager.generated.h"
+
+class AQLPickup;
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+enum class EQLPickupAnimation : uint8
+{
+    // spin at the rotation rate of the pickup
+    ConstantRotation,
+    // turn back to the zero rotation, e.g. after a recycler drop
+    RotationInterp,
+};
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+struct FQLPickupAnimationEntry
+{
+    TWeakObjectPtr<AQLPickup> Pickup;
+
+    EQLPickupAnimation Animation;
+
+    FRotator StartRotation;
+
+    float StartTime;
+
+    // degree per second
+    FRotator RotationRate;
+
+    float InterpSpeed;
+};
+
+//------------------------------------------------------------
+// Animate the idle pickups of the world in one pass per frame,
+// so that the pickups do not need to tick. The constant rotation
+// only depends on the time elapsed since it started, hence the
+// pickups that are not on screen are skipped and simply catch up
+// when they are seen again.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLPickupAnimationManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLPickupAnimationManager();
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    void StartConstantRotation(AQLPickup* Pickup, const FRotator& RotationRate);
+
+    //------------------------------------------------------------
+    // Once the zero rotation is reached, the pickup resumes its
+    // constant rotation if it has one
+    //------------------------------------------------------------
+    void StartRotationInterp(AQLPickup* Pickup, float InterpSpeed);
+
+    void StopAnimation(AQLPickup* Pickup);
+
+    int32 GetAnimatedPickupCount() const;
+
+protected:
+    FQLPickupAnimationEntry& FindOrAddEntry(AQLPickup* Pickup);
+
+    TArray<FQLPickupAnimationEntry> EntryList;
+};
@@ -14,12 +14,14 @@
 #include "QLCharacter.h"
 #include "QLUmgFirstPerson.h"
 #include "QLUmgInventory.h"
+#include "QLHUDViewModel.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
 
 //------------------------------------------------------------
 //------------------------------------------------------------
 AQLPlayerController::AQLPlayerController() :
-FPS(0.0f)
+HUDViewModel(nullptr)
 {
     // ui
     UmgFirstPersonClass = UQLUmgFirstPerson::StaticClass();
@@ -35,7 +37,7 @@ FPS(0.0f)
 //------------------------------------------------------------
 float AQLPlayerController::GetFrameRate() const
 {
-    return FPS;
+    return HUDViewModel ? HUDViewModel->GetFPS() : 0.0f;
 }
 
 //------------------------------------------------------------
@@ -64,7 +66,13 @@ void AQLPlayerController::Tick(float DeltaSeconds)
 {
     Super::Tick(DeltaSeconds);
 
-    FPS = 1.0f / DeltaSeconds;
+    if (HUDViewModel)
+    {
+        // real frame time, not slowed down by the time dilation
+        HUDViewModel->AddFrameTime(FApp::GetDeltaTime());
+        HUDViewModel->SetSpeed(GetControlledPawnSpeed());
+        HUDViewModel->Flush();
+    }
 }
 
 //------------------------------------------------------------
@@ -74,6 +82,10 @@ void AQLPlayerController::AddUMG()
     UmgFirstPerson = CreateWidget<UQLUmgFirstPerson>(GetWorld(), UmgFirstPersonClass, FName(TEXT("UmgFirstPerson")));
     UmgFirstPerson->QLSetPlayerController(this);
     UmgFirstPerson->AddToViewport();
+    if (HUDViewModel)
+    {
+        HUDViewModel->SetWidget(UmgFirstPerson);
+    }
     bShowMouseCursor = false;
     SetInputMode(FInputModeGameOnly());
 
@@ -88,12 +100,21 @@ UQLUmgFirstPerson* AQLPlayerController::GetUMG()
     return UmgFirstPerson;
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLHUDViewModel* AQLPlayerController::GetHUDViewModel()
+{
+    return HUDViewModel;
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLPlayerController::PostInitializeComponents()
 {
     Super::PostInitializeComponents();
 
+    HUDViewModel = NewObject<UQLHUDViewModel>(this);
+
     SetGenericTeamId(QLTeamId);
 }
 
@@ -116,27 +137,27 @@ void AQLPlayerController::OnPossess(APawn* ControlledPawn)
         // controlled character does not see his own health and armor bar
         ControlledCharacter->SetHealthArmorBarVisible(false);
 
-        AddUMG();
-
-        if (UmgFirstPerson)
+        if (HUDViewModel)
         {
-            UmgFirstPerson->UpdateTextHealthValue(ControlledCharacter->GetHealth());
-            UmgFirstPerson->UpdateTextArmorValue(ControlledCharacter->GetArmor());
+            HUDViewModel->SetHealth(ControlledCharacter->GetHealth());
+            HUDViewModel->SetArmor(ControlledCharacter->GetArmor());
         }
+
+        // push the values to the new widget
+        AddUMG();
     }
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void AQLPlayerController::ShowDamageOnScreen(float DamageAmount, const FVector& WorldTextLocation)
+void AQLPlayerController::ShowDamageOnScreen(float DamageAmount, const FVector& WorldTextLocation, AActor* Victim)
 {
     if (!UmgFirstPerson)
     {
         return;
     }
 
-    int32 DamageAmountInt = FMath::RoundToInt(DamageAmount);
-    UmgFirstPerson->ShowDamageOnScreen(FString::FromInt(DamageAmountInt), WorldTextLocation);
+    UmgFirstPerson->ShowDamageOnScreen(DamageAmount, WorldTextLocation, Victim);
 }
 
 //------------------------------------------------------------
@@ -17,6 +17,7 @@
 
 class UQLUmgFirstPerson;
 class UQLUmgInventory;
+class UQLHUDViewModel;
 
 //------------------------------------------------------------
 //------------------------------------------------------------
@@ -42,14 +43,24 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     UQLUmgFirstPerson* GetUMG();
 
+    //------------------------------------------------------------
+    // Set the values displayed by the UMG through the view model,
+    // it pushes them to the widget when they visibly change
+    //------------------------------------------------------------
+    UQLHUDViewModel* GetHUDViewModel();
+
     UPROPERTY(EditDefaultsOnly, Category = "C++Property")
     TSubclassOf<UQLUmgFirstPerson> UmgFirstPersonClass;
 
     UPROPERTY(EditDefaultsOnly, Category = "C++Property")
     TSubclassOf<UQLUmgInventory> UmgInventoryClass;
 
+    //------------------------------------------------------------
+    // The hits on the same victim in a short window are shown as
+    // one running total
+    //------------------------------------------------------------
     UFUNCTION(BlueprintCallable, Category = "C++Function")
-    void ShowDamageOnScreen(float DamageAmount, const FVector& WorldTextLocation);
+    void ShowDamageOnScreen(float DamageAmount, const FVector& WorldTextLocation, AActor* Victim = nullptr);
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void ShowAbilityMenu();
@@ -83,7 +94,8 @@ protected:
     UPROPERTY()
     UQLUmgInventory* UmgInventory;
 
-    float FPS;
+    UPROPERTY()
+    UQLHUDViewModel* HUDViewModel;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     FGenericTeamId QLTeamId;
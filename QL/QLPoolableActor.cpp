@@ -0,0 +1,24 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLPoolableActor.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void IQLPoolableActor::OnAcquiredFromPool()
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void IQLPoolableActor::OnReleasedToPool()
+{
+}
@@ -0,0 +1,48 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "QLPoolableActor.generated.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
+class QL_API UQLPoolableActor : public UInterface
+{
+    GENERATED_BODY()
+};
+
+//------------------------------------------------------------
+// Actors implementing this interface can be recycled by
+// UQLActorPoolManager instead of being spawned and destroyed.
+// A pooled actor is spawned only once. Afterwards, it is
+// deactivated when released to the pool, and reactivated
+// when acquired from the pool.
+//------------------------------------------------------------
+class QL_API IQLPoolableActor
+{
+    GENERATED_BODY()
+
+public:
+    //------------------------------------------------------------
+    // Bring the actor back to the state of a freshly spawned one,
+    // after the caller has configured it (instigator, damage, etc.)
+    //------------------------------------------------------------
+    virtual void OnAcquiredFromPool();
+
+    //------------------------------------------------------------
+    // Hide the actor, disable its collision, tick and movement,
+    // and clear the state set by the last user
+    //------------------------------------------------------------
+    virtual void OnReleasedToPool();
+};
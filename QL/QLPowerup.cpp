@@ -63,7 +63,7 @@ void AQLPowerup::OnComponentBeginOverlapImpl(UPrimitiveComponent* OverlappedComp
                 return;
             }
 
-            PlaySoundFireAndForget("PickUp");
+            PlaySoundFireAndForget("PickUp", EQLSoundCategory::Pickup);
 
             PowerUpPlayer();
 
@@ -181,4 +181,11 @@ void AQLPowerup::SetPowerupManager(UQLPowerupManager* PowerupManagerExt)
 FName AQLPowerup::GetPowerupName()
 {
     return PowerupName;
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLPowerup::EndEffect()
+{
+    OnEffectEnd();
+}
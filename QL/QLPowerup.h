@@ -37,6 +37,12 @@ public:
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     void SetPowerupManager(UQLPowerupManager* PowerupManagerExt);
 
+    //------------------------------------------------------------
+    // End the effect before its duration has elapsed
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    void EndEffect();
+
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     FName GetPowerupName();
 protected:
@@ -108,4 +108,21 @@ AQLPowerup* UQLPowerupManager::GetTopPowerup()
     {
         return nullptr;
     }
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLPowerupManager::RemoveAllPowerups()
+{
+    // ending the effect removes the powerup from the list
+    TArray<AQLPowerup*> PowerupListCopy = PowerupList;
+    for (AQLPowerup* Powerup : PowerupListCopy)
+    {
+        if (Powerup)
+        {
+            Powerup->EndEffect();
+        }
+    }
+
+    PowerupList.Reset();
+}
@@ -48,6 +48,12 @@ public:
     //------------------------------------------------------------
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     AQLPowerup* GetTopPowerup();
+
+    //------------------------------------------------------------
+    // End the effect of every powerup, e.g. upon respawn
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    void RemoveAllPowerups();
 protected:
     // do not use UPROPERTY() here
     // it breaks the character weapon system
@@ -15,7 +15,7 @@
 #include "QLUtility.h"
 #include "QLCharacter.h"
 #include "TimerManager.h"
-#include "QLUmgFirstPerson.h"
+#include "QLHUDViewModel.h"
 #include "QLPlayerController.h"
 
 //------------------------------------------------------------
@@ -59,10 +59,10 @@ void AQLPowerupProtection::UpdateProgressOnUMGInternal(const float Value)
         auto* PlayerController = Cast<AQLPlayerController>(Beneficiary->GetController());
         if (PlayerController)
         {
-            auto* UMG = PlayerController->GetUMG();
-            if (UMG)
+            auto* HUDViewModel = PlayerController->GetHUDViewModel();
+            if (HUDViewModel)
             {
-                UMG->UpdateProtectionDamageProgress(Value);
+                HUDViewModel->SetProtectionProgress(Value);
             }
         }
     }
@@ -86,10 +86,10 @@ void AQLPowerupProtection::SetUMGVisibility(const bool bFlag)
         auto* PlayerController = Cast<AQLPlayerController>(Beneficiary->GetController());
         if (PlayerController)
         {
-            auto* UMG = PlayerController->GetUMG();
-            if (UMG)
+            auto* HUDViewModel = PlayerController->GetHUDViewModel();
+            if (HUDViewModel)
             {
-                UMG->SetProtectionProgressVisibility(bFlag);
+                HUDViewModel->SetProtectionProgressVisible(bFlag);
             }
         }
     }
@@ -15,7 +15,7 @@
 #include "QLUtility.h"
 #include "QLCharacter.h"
 #include "TimerManager.h"
-#include "QLUmgFirstPerson.h"
+#include "QLHUDViewModel.h"
 #include "QLPlayerController.h"
 
 //------------------------------------------------------------
@@ -59,10 +59,10 @@ void AQLPowerupQuadDamage::UpdateProgressOnUMGInternal(const float Value)
         auto* PlayerController = Cast<AQLPlayerController>(Beneficiary->GetController());
         if (PlayerController)
         {
-            auto* UMG = PlayerController->GetUMG();
-            if (UMG)
+            auto* HUDViewModel = PlayerController->GetHUDViewModel();
+            if (HUDViewModel)
             {
-                UMG->UpdateQuadDamageProgress(Value);
+                HUDViewModel->SetQuadDamageProgress(Value);
             }
         }
     }
@@ -86,10 +86,10 @@ void AQLPowerupQuadDamage::SetUMGVisibility(const bool bFlag)
         auto* PlayerController = Cast<AQLPlayerController>(Beneficiary->GetController());
         if (PlayerController)
         {
-            auto* UMG = PlayerController->GetUMG();
-            if (UMG)
+            auto* HUDViewModel = PlayerController->GetHUDViewModel();
+            if (HUDViewModel)
             {
-                UMG->SetQuadDamageProgressVisibility(bFlag);
+                HUDViewModel->SetQuadDamageProgressVisible(bFlag);
             }
         }
     }
@@ -21,6 +21,20 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/DamageType.h"
 #include "QLPlayerController.h"
+#include "QLActorPoolManager.h"
+#include "QLSpatialQueryManager.h"
+#include "QLEffectManager.h"
+#include "QLGameModeBase.h"
+#include "TimerManager.h"
+#include "Particles/ParticleSystem.h"
+#include "Sound/SoundBase.h"
+
+namespace
+{
+    // sound names built once rather than on every hit
+    const FName HitSoundName(TEXT("Hit"));
+    const FName ExplodeSoundName(TEXT("Explode"));
+}
 
 //------------------------------------------------------------
 // Sets default values
@@ -55,6 +69,7 @@ AQLProjectile::AQLProjectile()
     BasicDamageAdjusted = BasicDamage;
     BlastSpeedChangeSelfDamageScale = 1.25f;
     ExplosionParticleSystemScale = 1.0f;
+    bIsInPool = false;
 }
 
 //------------------------------------------------------------
@@ -65,6 +80,13 @@ void AQLProjectile::BeginPlay()
     Super::BeginPlay();
 
     SetLifeSpan(ProjectileLifeSpan);
+
+    // a fire-and-forget sound needs an attenuation
+    UQLAudioManager* AudioManager = AQLGameModeBase::GetWorldService<UQLAudioManager>(this);
+    if (AudioManager && SoundAttenuation)
+    {
+        AudioManager->ResolveSoundList(SoundList, SoundAttenuation, SoundHandleList);
+    }
 }
 
 //------------------------------------------------------------
@@ -86,20 +108,32 @@ void AQLProjectile::OnBeginOverlapForComponent(UPrimitiveComponent* OverlappedCo
     // When such case does not happen, this function is guaranteed to be called only once,
     // because even though the projectile may overlap several components,
     // it is destroyed instantly upon the first overlap event.
-    if (OtherActor)
+    if (bIsInPool)
     {
-        bool bSelfDirectHit = false;
-        bool bDirectHit = false;
-        HandleDirectHit(OtherActor, bSelfDirectHit, bDirectHit);
-        if (bSelfDirectHit)
-        {
-            return;
-        }
+        return;
+    }
 
-        HandleSplashHit(OtherActor, bDirectHit);
+    if (OtherActor && ResolveHit(OtherActor, SweepResult))
+    {
+        Recycle();
+    }
+}
 
-        Destroy();
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLProjectile::ResolveHit(AActor* OtherActor, const FHitResult& HitResult)
+{
+    bool bSelfDirectHit = false;
+    bool bDirectHit = false;
+    HandleDirectHit(OtherActor, bSelfDirectHit, bDirectHit);
+    if (bSelfDirectHit)
+    {
+        return false;
     }
+
+    HandleSplashHit(OtherActor, bDirectHit);
+
+    return true;
 }
 
 //------------------------------------------------------------
@@ -126,8 +160,8 @@ void AQLProjectile::HandleDirectHit(AActor* OtherActor, bool& bSelfDirectHit, bo
         // display damage
         if (DamageAmount > 0.0f && PlayerController.IsValid())
         {
-            PlaySoundFireAndForget("Hit");
-            PlayerController->ShowDamageOnScreen(DamageAmount, Character->GetActorLocation());
+            PlaySoundFireAndForget(HitSoundName, EQLSoundCategory::HitConfirm);
+            PlayerController->ShowDamageOnScreen(DamageAmount, Character->GetActorLocation(), Character);
         }
 
         bDirectHit = true;
@@ -139,7 +173,84 @@ void AQLProjectile::HandleDirectHit(AActor* OtherActor, bool& bSelfDirectHit, bo
 void AQLProjectile::HandleSplashHit(AActor* OtherActor, bool bDirectHit)
 {
     // get victims within the blast radius
+    TArray<AQLCharacter*> VictimList;
+    FindCharactersWithinBlastRadius(VictimList);
+
+    // iterate victims
+    for (AQLCharacter* Character : VictimList)
+    {
+        SplashDamageVictimList.push_back(TWeakObjectPtr<AQLCharacter>(Character));
+
+        // change victim velocity
+        UCharacterMovementComponent*  CharacterMovementComponent = Character->GetCharacterMovement();
+        if (CharacterMovementComponent)
+        {
+            // a less good approach is LaunchCharacter()
+            // Character->LaunchCharacter(FVector(0.0f, 0.0f, 100.0f), true, true);
+
+            float ActualBlastSpeedChange = BlastSpeedChange;
+            if (PlayerController.IsValid() && Character == PlayerController->GetCharacter())
+            {
+                ActualBlastSpeedChange *= BlastSpeedChangeSelfDamageScale;
+            }
+
+            CharacterMovementComponent->AddRadialImpulse(
+                GetActorLocation(),
+                BlastRadius,
+                ActualBlastSpeedChange,
+                ERadialImpulseFalloff::RIF_Linear,
+                true); // velocity change (true) or impulse (false)
+        }
+
+        // inflict damage
+        // if direct hit damage has already been applied, skip to the next victim
+        if (bDirectHit && OtherActor == Character)
+        {
+            continue;
+        }
+
+        // reduce self splash damage (e.g. rocket jump, nailgun jump)
+        float DamageAmount = BasicDamageAdjusted;
+
+        if (PlayerController.IsValid() && Character == PlayerController->GetCharacter())
+        {
+            DamageAmount = ReduceSelfDamage(DamageAmount);
+        }
+
+        FRadialDamageEvent DamageEvent;
+        DamageEvent.Params.BaseDamage = DamageAmount;
+        DamageEvent.Params.OuterRadius = BlastRadius;
+        DamageEvent.Params.MinimumDamage = 0.0;
+
+        DamageAmount = Character->TakeDamage(DamageAmount, DamageEvent, PlayerController.Get(), this);
+
+        // display positive damage
+        if (DamageAmount > 0.0f && PlayerController.IsValid())
+        {
+            if (Character != PlayerController->GetCharacter())
+            {
+                PlaySoundFireAndForget(HitSoundName, EQLSoundCategory::HitConfirm);
+            }
+
+            PlayerController->ShowDamageOnScreen(DamageAmount, Character->GetActorLocation(), Character);
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLProjectile::FindCharactersWithinBlastRadius(TArray<AQLCharacter*>& OutCharacterList)
+{
     FVector Epicenter = GetActorLocation();
+
+    UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(this);
+    if (SpatialQueryManager)
+    {
+        SpatialQueryManager->FindCharactersInRadius(Epicenter, BlastRadius, OutCharacterList);
+        return;
+    }
+
+    // no spatial query manager in this world, ask the physics scene
     TArray<FOverlapResult> OutOverlaps;
     FCollisionObjectQueryParams CollisionObjectQueryParams(ECollisionChannel::ECC_Pawn);
     FCollisionQueryParams CollisionQueryParams;
@@ -151,80 +262,21 @@ void AQLProjectile::HandleSplashHit(AActor* OtherActor, bool bDirectHit)
         FCollisionShape::MakeSphere(BlastRadius),
         CollisionQueryParams);
 
-    // iterate victims
     for (auto&& Result : OutOverlaps)
     {
         TWeakObjectPtr<UPrimitiveComponent> Comp = Result.Component;
 
         // two components of the character can be registered: the capsule and the third person mesh
-        // to avoid splash damage being applied to a character twice, we single out the third person component
+        // to avoid a character being reported twice, we single out the third person component
         if (!Comp.IsValid() || !Cast<USkeletalMeshComponent>(Comp))
         {
             continue;
         }
 
-        AActor* Actor = Comp->GetOwner();
-        if (Actor)
+        AQLCharacter* Character = Cast<AQLCharacter>(Comp->GetOwner());
+        if (Character)
         {
-            AQLCharacter* Character = Cast<AQLCharacter>(Actor);
-            if (Character)
-            {
-                SplashDamageVictimList.push_back(TWeakObjectPtr<AQLCharacter>(Character));
-
-                // change victim velocity
-                UCharacterMovementComponent*  CharacterMovementComponent = Character->GetCharacterMovement();
-                if (CharacterMovementComponent)
-                {
-                    // a less good approach is LaunchCharacter()
-                    // Character->LaunchCharacter(FVector(0.0f, 0.0f, 100.0f), true, true);
-
-                    float ActualBlastSpeedChange = BlastSpeedChange;
-                    if (PlayerController.IsValid() && Character == PlayerController->GetCharacter())
-                    {
-                        ActualBlastSpeedChange *= BlastSpeedChangeSelfDamageScale;
-                    }
-
-                    CharacterMovementComponent->AddRadialImpulse(
-                        GetActorLocation(),
-                        BlastRadius,
-                        ActualBlastSpeedChange,
-                        ERadialImpulseFalloff::RIF_Linear,
-                        true); // velocity change (true) or impulse (false)
-                }
-
-                // inflict damage
-                // if direct hit damage has already been applied, skip to the next victim
-                if (bDirectHit && OtherActor == Actor)
-                {
-                    continue;
-                }
-
-                // reduce self splash damage (e.g. rocket jump, nailgun jump)
-                float DamageAmount = BasicDamageAdjusted;
-
-                if (PlayerController.IsValid() && Character == PlayerController->GetCharacter())
-                {
-                    DamageAmount = ReduceSelfDamage(DamageAmount);
-                }
-
-                FRadialDamageEvent DamageEvent;
-                DamageEvent.Params.BaseDamage = DamageAmount;
-                DamageEvent.Params.OuterRadius = BlastRadius;
-                DamageEvent.Params.MinimumDamage = 0.0;
-
-                DamageAmount = Character->TakeDamage(DamageAmount, DamageEvent, PlayerController.Get(), this);
-
-                // display positive damage
-                if (DamageAmount > 0.0f && PlayerController.IsValid())
-                {
-                    if (Character != PlayerController->GetCharacter())
-                    {
-                        PlaySoundFireAndForget("Hit");
-                    }
-
-                    PlayerController->ShowDamageOnScreen(DamageAmount, Character->GetActorLocation());
-                }
-            }
+            OutCharacterList.Add(Character);
         }
     }
 }
@@ -244,22 +296,114 @@ void AQLProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
     if (EndPlayReason == EEndPlayReason::Destroyed)
     {
-        // play explosion particle system
-        if (ExplosionParticleSystem)
-        {
-            FTransform Transform(FRotator::ZeroRotator,
-                GetActorLocation(),
-                FVector(ExplosionParticleSystemScale)); // scale
+        PlayExplosionEffect();
+    }
+}
 
-            UGameplayStatics::SpawnEmitterAtLocation(GetWorld(),
-                ExplosionParticleSystem,
-                Transform,
-                true, // auto destroy
-                EPSCPoolMethod::AutoRelease);
-        }
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLProjectile::PlayExplosionEffect()
+{
+    // let the effect queue merge and budget the explosions of the frame
+    UQLEffectManager* EffectManager = AQLGameModeBase::GetWorldService<UQLEffectManager>(this);
+    if (EffectManager)
+    {
+        EffectManager->QueueEmitter(ExplosionParticleSystem, GetActorLocation(), ExplosionParticleSystemScale);
+        PlaySoundFireAndForget(ExplodeSoundName, EQLSoundCategory::Explosion);
+        return;
+    }
+
+    // play explosion particle system
+    if (ExplosionParticleSystem)
+    {
+        FTransform Transform(FRotator::ZeroRotator,
+            GetActorLocation(),
+            FVector(ExplosionParticleSystemScale)); // scale
+
+        UGameplayStatics::SpawnEmitterAtLocation(GetWorld(),
+            ExplosionParticleSystem,
+            Transform,
+            true, // auto destroy
+            EPSCPoolMethod::AutoRelease);
+    }
+
+    PlaySoundFireAndForget(ExplodeSoundName, EQLSoundCategory::Explosion);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLProjectile::Recycle()
+{
+    if (bIsInPool)
+    {
+        return;
+    }
+
+    UQLActorPoolManager* ActorPoolManager = AQLGameModeBase::GetWorldService<UQLActorPoolManager>(this);
+    if (ActorPoolManager && ActorPoolManager->ReleaseActor(this))
+    {
+        // a pooled projectile is not destroyed, so EndPlay() does not play the effect
+        PlayExplosionEffect();
+        return;
+    }
 
-        PlaySoundFireAndForget(FName(TEXT("Explode")));
+    Destroy();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLProjectile::LifeSpanExpired()
+{
+    Recycle();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLProjectile::OnAcquiredFromPool()
+{
+    bIsInPool = false;
+
+    SetActorHiddenInGame(false);
+    SetActorTickEnabled(true);
+
+    if (ProjectileMovementComponent)
+    {
+        // the movement component detaches from the root when it stops simulating
+        ProjectileMovementComponent->SetUpdatedComponent(RootSphereComponent);
+        ProjectileMovementComponent->SetComponentTickEnabled(true);
     }
+
+    // enable collision last: the overlap events are generated at once,
+    // so the instigator must have been set by the caller
+    SetActorEnableCollision(true);
+
+    SetLifeSpan(ProjectileLifeSpan);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLProjectile::OnReleasedToPool()
+{
+    bIsInPool = true;
+
+    SetLifeSpan(0.0f);
+    GetWorldTimerManager().ClearAllTimersForObject(this);
+
+    SetActorEnableCollision(false);
+    SetActorHiddenInGame(true);
+    SetActorTickEnabled(false);
+
+    if (ProjectileMovementComponent)
+    {
+        ProjectileMovementComponent->StopMovementImmediately();
+        ProjectileMovementComponent->SetComponentTickEnabled(false);
+    }
+
+    // forget the last user
+    PlayerController = nullptr;
+    Instigator = nullptr;
+    SetDamageMultiplier(1.0f);
+    SplashDamageVictimList.clear();
 }
 
 //------------------------------------------------------------
@@ -287,8 +431,26 @@ void AQLProjectile::SetDamageMultiplier(const float Value)
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void AQLProjectile::PlaySoundFireAndForget(const FName& SoundName)
+float AQLProjectile::GetProjectileLifeSpan() const
+{
+    return ProjectileLifeSpan;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLProjectile::PlaySoundFireAndForget(const FName& SoundName, EQLSoundCategory SoundCategory)
 {
+    UQLEffectManager* EffectManager = AQLGameModeBase::GetWorldService<UQLEffectManager>(this);
+    if (EffectManager)
+    {
+        const FQLSoundHandle* SoundHandle = SoundHandleList.Find(SoundName);
+        if (SoundHandle)
+        {
+            EffectManager->QueueSound(*SoundHandle, GetActorLocation(), SoundCategory);
+        }
+        return;
+    }
+
     USoundBase** Result = SoundList.Find(SoundName);
     if (Result)
     {
@@ -306,3 +468,21 @@ void AQLProjectile::PlaySoundFireAndForget(const FName& SoundName)
         }
     }
 }
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLProjectile::GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const
+{
+    if (ExplosionParticleSystem)
+    {
+        OutAssetList.AddUnique(ExplosionParticleSystem);
+    }
+
+    for (const auto& Item : SoundList)
+    {
+        if (Item.Value)
+        {
+            OutAssetList.AddUnique(Item.Value);
+        }
+    }
+}
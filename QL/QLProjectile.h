@@ -12,13 +12,16 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "QLPoolableActor.h"
+#include "QLAudioManager.h"
 #include <vector>
 #include "QLProjectile.generated.h"
 
 //------------------------------------------------------------
+// Projectiles are recycled by UQLActorPoolManager when the world has one
 //------------------------------------------------------------
 UCLASS()
-class QL_API AQLProjectile : public AActor
+class QL_API AQLProjectile : public AActor, public IQLPoolableActor
 {
 	GENERATED_BODY()
 
@@ -45,7 +48,34 @@ public:
     void SetDamageMultiplier(const float Value);
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
-    void PlaySoundFireAndForget(const FName& SoundName);
+    float GetProjectileLifeSpan() const;
+
+    //------------------------------------------------------------
+    // Queued to the effect manager of the world, if any
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    void PlaySoundFireAndForget(const FName& SoundName, EQLSoundCategory SoundCategory = EQLSoundCategory::Default);
+
+    virtual void OnAcquiredFromPool() override;
+
+    virtual void OnReleasedToPool() override;
+
+    virtual void LifeSpanExpired() override;
+
+    //------------------------------------------------------------
+    // Apply the direct and splash damage of the projectile hitting OtherActor.
+    // Return false if the hit is ignored (self direct hit), in which case
+    // the projectile keeps flying.
+    //------------------------------------------------------------
+    virtual bool ResolveHit(AActor* OtherActor, const FHitResult& HitResult);
+
+    void PlayExplosionEffect();
+
+    //------------------------------------------------------------
+    // Warmed up along with the weapon firing the projectile,
+    // see AQLPickup::GetWarmUpAssetList()
+    //------------------------------------------------------------
+    void GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const;
 
 protected:
     //------------------------------------------------------------
@@ -62,12 +92,24 @@ protected:
     UFUNCTION()
     virtual void HandleSplashHit(AActor* OtherActor, bool bDirectHit);
 
+    //------------------------------------------------------------
+    // Characters whose capsule overlaps the blast sphere
+    //------------------------------------------------------------
+    void FindCharactersWithinBlastRadius(TArray<AQLCharacter*>& OutCharacterList);
+
     //------------------------------------------------------------
     // Given input damage, reduce it and return the result
     //------------------------------------------------------------
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     float ReduceSelfDamage(const float InDamage);
 
+    //------------------------------------------------------------
+    // Return the projectile to the actor pool, or destroy it if
+    // it is not pooled. Use it in place of Destroy().
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    void Recycle();
+
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "C++Property")
     UProjectileMovementComponent* ProjectileMovementComponent;
 
@@ -107,6 +149,9 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     TMap<FName, USoundBase*> SoundList;
 
+    // SoundList resolved by the audio manager, kept while the projectile is pooled
+    TMap<FName, FQLSoundHandle> SoundHandleList;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     USoundAttenuation* SoundAttenuation;
 
@@ -115,4 +160,7 @@ protected:
 
     // temporary container to hold victims of splash damage
     std::vector<TWeakObjectPtr<AQLCharacter>> SplashDamageVictimList;
+
+    // the projectile is waiting in the actor pool and must ignore overlap events
+    bool bIsInPool;
 };
@@ -11,8 +11,10 @@
 
 #include "QLRailBeam.h"
 #include "Particles/ParticleSystemComponent.h"
+#include "Particles/ParticleSystem.h"
 #include "QLUtility.h"
 #include "Components/SphereComponent.h"
+#include "QLActorPoolManager.h"
 
 //------------------------------------------------------------
 // Sets default values
@@ -29,6 +31,8 @@ AQLRailBeam::AQLRailBeam()
     BeamComponent = CreateDefaultSubobject<UParticleSystemComponent>(TEXT("BeamComponent"));
     BeamComponent->SetupAttachment(RootComponent);
     BeamComponent->SetCollisionProfileName("NoCollision");
+
+    BeamLifeSpan = 1.0f;
 }
 
 //------------------------------------------------------------
@@ -38,7 +42,7 @@ void AQLRailBeam::BeginPlay()
 {
 	Super::BeginPlay();
 
-    SetLifeSpan(1.0f);
+    SetLifeSpan(BeamLifeSpan);
 }
 
 //------------------------------------------------------------
@@ -62,4 +66,55 @@ UParticleSystemComponent* AQLRailBeam::GetBeamComponent()
 void AQLRailBeam::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
     Super::EndPlay(EndPlayReason);
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRailBeam::LifeSpanExpired()
+{
+    UQLActorPoolManager* ActorPoolManager = AQLGameModeBase::GetWorldService<UQLActorPoolManager>(this);
+    if (ActorPoolManager && ActorPoolManager->ReleaseActor(this))
+    {
+        return;
+    }
+
+    Destroy();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRailBeam::OnAcquiredFromPool()
+{
+    SetActorHiddenInGame(false);
+
+    if (BeamComponent)
+    {
+        BeamComponent->ActivateSystem(true); // reset
+    }
+
+    SetLifeSpan(BeamLifeSpan);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRailBeam::OnReleasedToPool()
+{
+    SetLifeSpan(0.0f);
+
+    if (BeamComponent)
+    {
+        BeamComponent->DeactivateSystem();
+    }
+
+    SetActorHiddenInGame(true);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRailBeam::GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const
+{
+    if (BeamComponent && BeamComponent->Template)
+    {
+        OutAssetList.AddUnique(BeamComponent->Template);
+    }
+}
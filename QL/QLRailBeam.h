@@ -12,6 +12,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "QLPoolableActor.h"
 #include "QLRailBeam.generated.h"
 
 class UParticleSystemComponent;
@@ -19,9 +20,11 @@ class UParticleSystemComponent;
 //------------------------------------------------------------
 // In Blueprint, set these properties
 // - beam component
+//
+// Rail beams are recycled by UQLActorPoolManager when the world has one
 //------------------------------------------------------------
 UCLASS()
-class QL_API AQLRailBeam : public AActor
+class QL_API AQLRailBeam : public AActor, public IQLPoolableActor
 {
 	GENERATED_BODY()
 
@@ -37,10 +40,24 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     UParticleSystemComponent* GetBeamComponent();
+
+    virtual void OnAcquiredFromPool() override;
+
+    virtual void OnReleasedToPool() override;
+
+    virtual void LifeSpanExpired() override;
+
+    //------------------------------------------------------------
+    // Warmed up along with the rail gun, see AQLPickup::GetWarmUpAssetList()
+    //------------------------------------------------------------
+    void GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const;
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "C++Property")
     UParticleSystemComponent* BeamComponent;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    float BeamLifeSpan;
 };
@@ -24,6 +24,8 @@
 #include "QLCharacter.h"
 #include "QLHealth.h"
 #include "QLArmor.h"
+#include "QLForceFieldManager.h"
+#include "QLGameModeBase.h"
 
 //------------------------------------------------------------
 // Sets default values
@@ -54,6 +56,7 @@ AQLRecyclerGrenadeProjectile::AQLRecyclerGrenadeProjectile()
     RecoverDuration = 2.0f;
     BlastRadius = 400.0f;
     BlastSpeedChange = 600.0f;
+    AttractForceFieldId = INDEX_NONE;
 
     bCalculateMaterialParameter = false;
 
@@ -73,6 +76,13 @@ void AQLRecyclerGrenadeProjectile::BeginPlay()
 {
 	Super::BeginPlay();
 
+    StartIdleTimer();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRecyclerGrenadeProjectile::StartIdleTimer()
+{
     GetWorldTimerManager().SetTimer(IdleTimerHandle,
         this,
         &AQLRecyclerGrenadeProjectile::Implode,
@@ -81,6 +91,38 @@ void AQLRecyclerGrenadeProjectile::BeginPlay()
         IdleDuration); // delay in second
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRecyclerGrenadeProjectile::OnAcquiredFromPool()
+{
+    Super::OnAcquiredFromPool();
+
+    StaticMeshComponent->SetVisibility(true);
+
+    StartIdleTimer();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRecyclerGrenadeProjectile::OnReleasedToPool()
+{
+    // the base class clears the stage timers
+    Super::OnReleasedToPool();
+
+    StopAttracting();
+
+    PostProcessComponent->bEnabled = false;
+    bCalculateMaterialParameter = false;
+
+    if (SpaceWarpTimeline)
+    {
+        SpaceWarpTimeline->Stop();
+        SpaceWarpTimeline->SetPlaybackPosition(0.0f, false);
+    }
+
+    RevertPickupPhysics();
+}
+
 //------------------------------------------------------------
 // Called every frame
 //------------------------------------------------------------
@@ -100,6 +142,15 @@ void AQLRecyclerGrenadeProjectile::EndPlay(const EEndPlayReason::Type EndPlayRea
 {
     Super::EndPlay(EndPlayReason);
 
+    StopAttracting();
+
+    RevertPickupPhysics();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRecyclerGrenadeProjectile::RevertPickupPhysics()
+{
     if (PickupList.size() > 0)
     {
         for (auto&& Item : PickupList)
@@ -148,7 +199,7 @@ void AQLRecyclerGrenadeProjectile::PostInitializeComponents()
 //------------------------------------------------------------
 void AQLRecyclerGrenadeProjectile::OnProjectileBounceImpl(const FHitResult& ImpactResult, const FVector& ImpactVelocity)
 {
-    PlaySoundFireAndForget("Bounce");
+    PlaySoundFireAndForget("Bounce", EQLSoundCategory::Impact);
 }
 
 //------------------------------------------------------------
@@ -164,12 +215,7 @@ void AQLRecyclerGrenadeProjectile::Implode()
         SpaceWarpTimeline->PlayFromStart();
     }
 
-    GetWorldTimerManager().SetTimer(AttractTimerHandle,
-        this,
-        &AQLRecyclerGrenadeProjectile::Attract,
-        AttractInterval, // time interval in second
-        true, // loop
-        0.0f); // delay in second
+    StartAttracting();
 
     GetWorldTimerManager().SetTimer(ImplodeTimerHandle,
         this,
@@ -179,51 +225,84 @@ void AQLRecyclerGrenadeProjectile::Implode()
         AttractDuration); // delay in second
 }
 
+//------------------------------------------------------------
+// The force field manager pulls the characters once per frame.
+// Without it, the grenade pulls them on its own timer.
+//------------------------------------------------------------
+void AQLRecyclerGrenadeProjectile::StartAttracting()
+{
+    UQLForceFieldManager* ForceFieldManager = AQLGameModeBase::GetWorldService<UQLForceFieldManager>(this);
+    if (ForceFieldManager)
+    {
+        FQLForceField ForceField;
+        ForceField.Radius = BlastRadius;
+        // the timer applied BlastSpeedChange every AttractInterval
+        ForceField.Strength = AttractInterval > 0.0f ? -BlastSpeedChange / AttractInterval : -BlastSpeedChange;
+        ForceField.Falloff = ERadialImpulseFalloff::RIF_Linear;
+        ForceField.SourceActor = this;
+        if (PlayerController.IsValid())
+        {
+            ForceField.ScaledCharacter = Cast<AQLCharacter>(PlayerController->GetCharacter());
+        }
+        ForceField.ScaledCharacterMultiplier = BlastSpeedChangeSelfDamageScale;
+
+        AttractForceFieldId = ForceFieldManager->AddForceField(ForceField);
+        return;
+    }
+
+    GetWorldTimerManager().SetTimer(AttractTimerHandle,
+        this,
+        &AQLRecyclerGrenadeProjectile::Attract,
+        AttractInterval, // time interval in second
+        true, // loop
+        0.0f); // delay in second
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLRecyclerGrenadeProjectile::StopAttracting()
+{
+    GetWorldTimerManager().ClearTimer(AttractTimerHandle);
+
+    if (AttractForceFieldId != INDEX_NONE)
+    {
+        UQLForceFieldManager* ForceFieldManager = AQLGameModeBase::GetWorldService<UQLForceFieldManager>(this);
+        if (ForceFieldManager)
+        {
+            ForceFieldManager->RemoveForceField(AttractForceFieldId);
+        }
+
+        AttractForceFieldId = INDEX_NONE;
+    }
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLRecyclerGrenadeProjectile::Attract()
 {
     // get victims within the blast radius
-    FVector Epicenter = GetActorLocation();
-    TArray<FOverlapResult> OutOverlaps;
-    FCollisionObjectQueryParams CollisionObjectQueryParams(ECollisionChannel::ECC_Pawn);
-    FCollisionQueryParams CollisionQueryParams;
-
-    GetWorld()->OverlapMultiByObjectType(OutOverlaps,
-        Epicenter,
-        FQuat(GetActorRotation()),
-        CollisionObjectQueryParams,
-        FCollisionShape::MakeSphere(BlastRadius),
-        CollisionQueryParams);
+    TArray<AQLCharacter*> VictimList;
+    FindCharactersWithinBlastRadius(VictimList);
 
     // iterate victims
-    for (auto&& Result : OutOverlaps)
+    for (AQLCharacter* Character : VictimList)
     {
-        TWeakObjectPtr<UPrimitiveComponent> Comp = Result.Component;
-        AActor* Actor = Comp->GetOwner();
-        if (Actor)
+        // change victim velocity
+        UCharacterMovementComponent*  CharacterMovementComponent = Character->GetCharacterMovement();
+        if (CharacterMovementComponent)
         {
-            AQLCharacter* Character = Cast<AQLCharacter>(Actor);
-            if (Character)
+            float ActualBlastSpeedChange = BlastSpeedChange;
+            if (PlayerController.IsValid() && Character == PlayerController->GetCharacter())
             {
-                // change victim velocity
-                UCharacterMovementComponent*  CharacterMovementComponent = Character->GetCharacterMovement();
-                if (CharacterMovementComponent)
-                {
-                    float ActualBlastSpeedChange = BlastSpeedChange;
-                    if (PlayerController.IsValid() && Character == PlayerController->GetCharacter())
-                    {
-                        ActualBlastSpeedChange *= BlastSpeedChangeSelfDamageScale;
-                    }
-
-                    CharacterMovementComponent->AddRadialImpulse(
-                        GetActorLocation(),
-                        BlastRadius,
-                        -ActualBlastSpeedChange,
-                        ERadialImpulseFalloff::RIF_Linear,
-                        true); // velocity change (true) or impulse (false)
-                }
+                ActualBlastSpeedChange *= BlastSpeedChangeSelfDamageScale;
             }
+
+            CharacterMovementComponent->AddRadialImpulse(
+                GetActorLocation(),
+                BlastRadius,
+                -ActualBlastSpeedChange,
+                ERadialImpulseFalloff::RIF_Linear,
+                true); // velocity change (true) or impulse (false)
         }
     }
 }
@@ -232,11 +311,11 @@ void AQLRecyclerGrenadeProjectile::Attract()
 //------------------------------------------------------------
 void AQLRecyclerGrenadeProjectile::Annihilate()
 {
-    PlaySoundFireAndForget("Annihilate");
+    PlaySoundFireAndForget("Annihilate", EQLSoundCategory::Explosion);
 
     StaticMeshComponent->SetVisibility(false);
 
-    GetWorldTimerManager().ClearTimer(AttractTimerHandle);
+    StopAttracting();
 
     SetLifeSpan(RecoverDuration);
 
@@ -249,15 +328,16 @@ void AQLRecyclerGrenadeProjectile::Annihilate()
     {
         if (Victim.IsValid())
         {
-            if (!Victim->IsAlive())
+            // the blast damage is only queued, see UQLDamageManager
+            if (Victim->IsDoomed())
             {
                 // dead victims are converted into health and armor pickups
                 // health
                 for (int32 i = 0; i < 2; ++i)
                 {
-                    float XPosition = FMath::RandRange(-50.0f, 50.0f);
-                    float YPosition = FMath::RandRange(-50.0f, 50.0f);
-                    float ZPosition = FMath::RandRange(100.0f, 150.0f);
+                    float XPosition = QLUtility::RandRange(-50.0f, 50.0f);
+                    float YPosition = QLUtility::RandRange(-50.0f, 50.0f);
+                    float ZPosition = QLUtility::RandRange(100.0f, 150.0f);
 
                     FVector SpawnLocation = GetActorLocation() + FVector(XPosition, YPosition, ZPosition);
                     auto* Pickup = GetWorld()->SpawnActor<AQLHealth>(HealthClass, SpawnLocation, FRotator::ZeroRotator, SpawnParameters);
@@ -267,9 +347,9 @@ void AQLRecyclerGrenadeProjectile::Annihilate()
                 // armor
                 for (int32 i = 0; i < 2; ++i)
                 {
-                    float XPosition = FMath::RandRange(-50.0f, 50.0f);
-                    float YPosition = FMath::RandRange(-50.0f, 50.0f);
-                    float ZPosition = FMath::RandRange(100.0f, 150.0f);
+                    float XPosition = QLUtility::RandRange(-50.0f, 50.0f);
+                    float YPosition = QLUtility::RandRange(-50.0f, 50.0f);
+                    float ZPosition = QLUtility::RandRange(100.0f, 150.0f);
 
                     FVector SpawnLocation = GetActorLocation() + FVector(XPosition, YPosition, ZPosition);
                     auto* Pickup = GetWorld()->SpawnActor<AQLArmor>(ArmorClass, SpawnLocation, FRotator::ZeroRotator, SpawnParameters);
@@ -280,8 +360,8 @@ void AQLRecyclerGrenadeProjectile::Annihilate()
                 {
                     if (Item.IsValid())
                     {
-                        float XVelocity = FMath::RandRange(-100.0f, 100.0f);
-                        float YVelocity = FMath::RandRange(-100.0f, 100.0f);
+                        float XVelocity = QLUtility::RandRange(-100.0f, 100.0f);
+                        float YVelocity = QLUtility::RandRange(-100.0f, 100.0f);
                         float ZVelocity = 600.0f;
 
                         Item->ChangePhysicsSetup();
@@ -40,6 +40,10 @@ public:
 	// Sets default values for this actor's properties
 	AQLRecyclerGrenadeProjectile();
 
+    virtual void OnAcquiredFromPool() override;
+
+    virtual void OnReleasedToPool() override;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -69,6 +73,17 @@ protected:
     UFUNCTION()
     void SpaceWarpCallback(float Value);
 
+    //------------------------------------------------------------
+    // Give the generated pickups their usual physics back
+    //------------------------------------------------------------
+    void RevertPickupPhysics();
+
+    void StartIdleTimer();
+
+    void StartAttracting();
+
+    void StopAttracting();
+
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "C++Property")
     UPostProcessComponent* PostProcessComponent;
 
@@ -94,6 +109,9 @@ protected:
     FTimerHandle ImplodeTimerHandle;
     FTimerHandle AttractTimerHandle;
 
+    // id of the attractor registered to the force field manager
+    int32 AttractForceFieldId;
+
     UPROPERTY()
     UTimelineComponent* SpaceWarpTimeline;
 
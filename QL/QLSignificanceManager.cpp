@@ -0,0 +1,292 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLSignificanceManager.h"
+#include "QLCharacter.h"
+#include "QLAIController.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLSignificanceEnabled(
+    TEXT("ql.SignificanceEnabled"),
+    1,
+    TEXT("0: every bot stays at the high significance tier.\n")
+    TEXT("1: the bots are scored against the local players."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarQLSignificanceUpdateInterval(
+    TEXT("ql.SignificanceUpdateInterval"),
+    0.25f,
+    TEXT("Time between two scorings of the bots (second)."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarQLSignificanceMaxDistance(
+    TEXT("ql.SignificanceMaxDistance"),
+    8000.0f,
+    TEXT("Distance to the nearest local player at which the distance part of the score reaches 0."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarQLSignificanceDebug(
+    TEXT("ql.SignificanceDebug"),
+    0,
+    TEXT("1: list the significance tier and score of each bot on screen."),
+    ECVF_Default);
+
+namespace
+{
+    // score = distance part in [0, 1] + rendered + fighting a local player
+    const float RenderedScore = 1.0f;
+    const float CombatScore = 2.0f;
+
+    const float HighTierMinScore = 1.5f;
+    const float MediumTierMinScore = 0.75f;
+    const float LowTierMinScore = 0.25f;
+
+    // indexed by EQLSignificanceTier
+    const FQLSignificanceSettings SignificanceSettingsList[] = {
+        { EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones, 0.0f, true, true },
+        { EVisibilityBasedAnimTickOption::AlwaysTickPose, 0.0f, true, true },
+        { EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered, 1.0f / 15.0f, true, false },
+        { EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered, 0.25f, false, false },
+    };
+
+    const int32 DebugMessageKeyBase = 0x51470000;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLSignificanceManager::UQLSignificanceManager() :
+TimeUntilUpdate(0.0f),
+bIsCustomDepthForced(false)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSignificanceManager::Deinitialize()
+{
+    CharacterList.Empty();
+    ViewerList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+const FQLSignificanceSettings& UQLSignificanceManager::GetTierSettings(EQLSignificanceTier Tier)
+{
+    return SignificanceSettingsList[static_cast<int32>(Tier)];
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+const TCHAR* UQLSignificanceManager::GetTierName(EQLSignificanceTier Tier)
+{
+    switch (Tier)
+    {
+    case EQLSignificanceTier::High:
+        return TEXT("High");
+    case EQLSignificanceTier::Medium:
+        return TEXT("Medium");
+    case EQLSignificanceTier::Low:
+        return TEXT("Low");
+    default:
+        return TEXT("Dormant");
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSignificanceManager::RegisterCharacter(AQLCharacter* Character)
+{
+    if (Character)
+    {
+        CharacterList.AddUnique(Character);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSignificanceManager::UnregisterCharacter(AQLCharacter* Character)
+{
+    CharacterList.RemoveSwap(Character);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSignificanceManager::SetCustomDepthForced(bool bFlag)
+{
+    if (bIsCustomDepthForced == bFlag)
+    {
+        return;
+    }
+
+    bIsCustomDepthForced = bFlag;
+
+    // do not wait for the next update, the post process is already on screen
+    UpdateSignificance();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLSignificanceManager::IsCustomDepthForced() const
+{
+    return bIsCustomDepthForced;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSignificanceManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    TimeUntilUpdate -= DeltaTime;
+    if (TimeUntilUpdate > 0.0f)
+    {
+        return;
+    }
+
+    TimeUntilUpdate = CVarQLSignificanceUpdateInterval.GetValueOnGameThread();
+    UpdateSignificance();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSignificanceManager::UpdateViewerList()
+{
+    ViewerList.Reset();
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        APlayerController* PlayerController = It->Get();
+        if (PlayerController && PlayerController->IsLocalController())
+        {
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            ViewerList.Emplace(ViewLocation, PlayerController->GetPawn());
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float UQLSignificanceManager::ScoreCharacter(AQLCharacter* Character) const
+{
+    // nobody to score against, e.g. the headless simulation, whose results
+    // must not depend on whether a player watches
+    if (ViewerList.Num() == 0)
+    {
+        return HighTierMinScore;
+    }
+
+    const float MaxDistance = FMath::Max(CVarQLSignificanceMaxDistance.GetValueOnGameThread(), 1.0f);
+
+    USkeletalMeshComponent* ThirdPersonMesh = Character->GetThirdPersonMesh();
+    const bool bIsRendered = ThirdPersonMesh && ThirdPersonMesh->WasRecentlyRendered(0.2f);
+
+    AQLAIController* QLAIController = Cast<AQLAIController>(Character->GetController());
+    APawn* Target = QLAIController ? QLAIController->GetTarget() : nullptr;
+
+    float BestScore = 0.0f;
+    for (const auto& Viewer : ViewerList)
+    {
+        const float Distance = FVector::Dist(Viewer.Key, Character->GetActorLocation());
+        float Score = 1.0f - FMath::Clamp(Distance / MaxDistance, 0.0f, 1.0f);
+
+        if (bIsRendered)
+        {
+            Score += RenderedScore;
+        }
+
+        if (Target && Target == Viewer.Value.Get())
+        {
+            Score += CombatScore;
+        }
+
+        BestScore = FMath::Max(BestScore, Score);
+    }
+
+    return BestScore;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+EQLSignificanceTier UQLSignificanceManager::GetTier(float Score)
+{
+    if (Score >= HighTierMinScore)
+    {
+        return EQLSignificanceTier::High;
+    }
+
+    if (Score >= MediumTierMinScore)
+    {
+        return EQLSignificanceTier::Medium;
+    }
+
+    if (Score >= LowTierMinScore)
+    {
+        return EQLSignificanceTier::Low;
+    }
+
+    return EQLSignificanceTier::Dormant;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSignificanceManager::UpdateSignificance()
+{
+    UpdateViewerList();
+
+    const bool bIsEnabled = CVarQLSignificanceEnabled.GetValueOnGameThread() != 0;
+    const bool bShowDebug = CVarQLSignificanceDebug.GetValueOnGameThread() != 0 && GEngine;
+
+    for (int32 Index = CharacterList.Num() - 1; Index >= 0; --Index)
+    {
+        AQLCharacter* Character = CharacterList[Index].Get();
+        if (!Character || Character->IsPendingKill())
+        {
+            CharacterList.RemoveAtSwap(Index);
+            continue;
+        }
+
+        // the local players are always fully animated
+        if (!Character->GetIsBot())
+        {
+            continue;
+        }
+
+        const float Score = bIsEnabled ? ScoreCharacter(Character) : HighTierMinScore;
+        const EQLSignificanceTier Tier = GetTier(Score);
+        Character->SetSignificanceTier(Tier, bIsCustomDepthForced);
+
+        if (bShowDebug)
+        {
+            const FColor Color = Tier == EQLSignificanceTier::High ? FColor::Red
+                : Tier == EQLSignificanceTier::Medium ? FColor::Yellow
+                : Tier == EQLSignificanceTier::Low ? FColor::Green
+                : FColor::Silver;
+
+            GEngine->AddOnScreenDebugMessage(DebugMessageKeyBase + Index,
+                CVarQLSignificanceUpdateInterval.GetValueOnGameThread() + 0.1f,
+                Color,
+                FString::Printf(TEXT("%s: %s (%.2f)"), *Character->GetName(), GetTierName(Tier), Score));
+        }
+    }
+}
@@ -0,0 +1,108 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "QLWorldService.h"
+#include "QLSignificanceManager.generated.h"
+
+class AQLCharacter;
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+enum class EQLSignificanceTier : uint8
+{
+    // fighting a local player, or seen up close
+    High,
+    // seen from afar, or hidden nearby
+    Medium,
+    Low,
+    // far from every local player and not seen
+    Dormant,
+};
+
+//------------------------------------------------------------
+// What a bot character costs at a given tier
+//------------------------------------------------------------
+struct FQLSignificanceSettings
+{
+    EVisibilityBasedAnimTickOption AnimTickOption;
+
+    // second, 0 to tick every frame
+    float AnimTickInterval;
+
+    bool bRenderCustomDepth;
+
+    bool bShowHealthArmorBar;
+};
+
+//------------------------------------------------------------
+// Score each bot character a few times a second by its distance
+// to the local players, whether it was rendered recently and
+// whether it is fighting a local player, then map the score to
+// a tier. A bot whose tier changes updates its animation tick,
+// custom depth and health and armor bar, see
+// AQLCharacter::SetSignificanceTier(). The cost of its AI is set
+// by UQLAILODManager instead.
+//
+// Without any local player (headless simulation, dedicated server)
+// every bot stays at the high tier, as if the manager were
+// disabled. ql.SignificanceEnabled 0 keeps every bot
+// at the high tier. ql.SignificanceDebug 1 lists the tier of each
+// bot on screen.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLSignificanceManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLSignificanceManager();
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    void RegisterCharacter(AQLCharacter* Character);
+
+    void UnregisterCharacter(AQLCharacter* Character);
+
+    //------------------------------------------------------------
+    // Keep the custom depth of every bot on, e.g. while the x-ray
+    // post process of the piercing sight ability is enabled
+    //------------------------------------------------------------
+    void SetCustomDepthForced(bool bFlag);
+
+    bool IsCustomDepthForced() const;
+
+    static const FQLSignificanceSettings& GetTierSettings(EQLSignificanceTier Tier);
+
+    static const TCHAR* GetTierName(EQLSignificanceTier Tier);
+
+protected:
+    void UpdateViewerList();
+
+    float ScoreCharacter(AQLCharacter* Character) const;
+
+    static EQLSignificanceTier GetTier(float Score);
+
+    void UpdateSignificance();
+
+    TArray<TWeakObjectPtr<AQLCharacter>> CharacterList;
+
+    // camera location and pawn of each local player
+    TArray<TPair<FVector, TWeakObjectPtr<APawn>>> ViewerList;
+
+    float TimeUntilUpdate;
+
+    bool bIsCustomDepthForced;
+};
@@ -0,0 +1,376 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLSimulationGameMode.h"
+#include "QLAIHelper.h"
+#include "QLCharacter.h"
+#include "QLPickup.h"
+#include "QLSpawnPointManager.h"
+#include "QLAssetPreloadManager.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "TimerManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/DateTime.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+AQLSimulationGameMode::AQLSimulationGameMode() :
+Super(),
+NumBots(8),
+RandomSeed(1),
+FixedTimeStep(1.0f / 60.0f),
+MatchDuration(300.0f),
+bQuitWhenMatchEnds(true),
+bMatchStarted(false),
+bMatchEnded(false),
+MatchStartRealTime(0.0),
+LastFrameRealTime(0.0),
+KillCount(0),
+SuicideCount(0)
+{
+    // bots only, the local player watches as a spectator
+    DefaultPawnClass = nullptr;
+    bStartPlayersAsSpectators = true;
+
+    BotClass = AQLCharacter::StaticClass();
+
+    bTimeWorldServices = true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+    Super::InitGame(MapName, Options, ErrorMessage);
+
+    ParseCommandLine();
+
+    UQLAssetPreloadManager* AssetPreloadManager = GetWorldService<UQLAssetPreloadManager>(this);
+    if (AssetPreloadManager)
+    {
+        AssetPreloadManager->PreloadCharacterEquipment(BotClass);
+    }
+
+    // seed before anything is spawned
+    QLUtility::SetRandomSeed(RandomSeed);
+
+    // every frame advances the simulation by the same amount, without waiting for the wall clock
+    FApp::SetUseFixedTimeStep(true);
+    FApp::SetFixedDeltaTime(FixedTimeStep);
+
+    QLUtility::Log(FString::Printf(TEXT("simulation: %s, %d bots, seed %d, time step %f s, duration %.0f s"),
+        *MapName,
+        NumBots,
+        RandomSeed,
+        FixedTimeStep,
+        MatchDuration));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::ParseCommandLine()
+{
+    const TCHAR* CommandLine = FCommandLine::Get();
+
+    FParse::Value(CommandLine, TEXT("QLSimBots="), NumBots);
+    FParse::Value(CommandLine, TEXT("QLSimSeed="), RandomSeed);
+    FParse::Value(CommandLine, TEXT("QLSimTimeStep="), FixedTimeStep);
+    FParse::Value(CommandLine, TEXT("QLSimDuration="), MatchDuration);
+    FParse::Value(CommandLine, TEXT("QLSimOutput="), OutputDirectory);
+
+    NumBots = FMath::Max(NumBots, 0);
+    FixedTimeStep = FMath::Max(FixedTimeStep, 1e-3f);
+    MatchDuration = FMath::Max(MatchDuration, FixedTimeStep);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // the spawn point ranking must not depend on the worker threads
+    UQLSpawnPointManager* SpawnPointManager = GetWorldService<UQLSpawnPointManager>(this);
+    if (SpawnPointManager)
+    {
+        SpawnPointManager->SetDeterministic(true);
+    }
+
+    // AQLAIHelper spawns the bots over the next frames, the match starts once they are all in
+    AQLAIHelper* AIHelper = GetWorld()->SpawnActorDeferred<AQLAIHelper>(AQLAIHelper::StaticClass(),
+        FTransform::Identity,
+        nullptr, // owner
+        nullptr, // instigator
+        ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    if (AIHelper)
+    {
+        AIHelper->SetNumBotsToSpawn(NumBots);
+        AIHelper->SetCharacterClass(BotClass);
+        AIHelper->OnBotsSpawned().AddUObject(this, &AQLSimulationGameMode::StartMatch);
+        UGameplayStatics::FinishSpawningActor(AIHelper, FTransform::Identity);
+    }
+    else
+    {
+        StartMatch();
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::StartMatch()
+{
+    if (bMatchStarted)
+    {
+        return;
+    }
+
+    bMatchStarted = true;
+
+    const int32 FrameCount = FMath::CeilToInt(MatchDuration / FixedTimeStep);
+    FrameTimeList.Reserve(FrameCount);
+
+    MatchStartRealTime = FPlatformTime::Seconds();
+    LastFrameRealTime = MatchStartRealTime;
+
+    GetWorldTimerManager().SetTimer(MatchTimerHandle,
+        this,
+        &AQLSimulationGameMode::EndMatch,
+        1.0f, // time interval in second
+        false, // loop
+        MatchDuration); // delay in second
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    GetWorldTimerManager().ClearTimer(MatchTimerHandle);
+
+    // do not leave the editor running at a fixed time step after a simulation in PIE
+    FApp::SetUseFixedTimeStep(false);
+
+    Super::EndPlay(EndPlayReason);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::Tick(float DeltaSeconds)
+{
+    // whole frame, measured from one game mode tick to the next
+    const double CurrentRealTime = FPlatformTime::Seconds();
+    if (bMatchStarted && !bMatchEnded)
+    {
+        FrameTimeList.Add(static_cast<float>((CurrentRealTime - LastFrameRealTime) * 1000.0));
+    }
+    LastFrameRealTime = CurrentRealTime;
+
+    Super::Tick(DeltaSeconds);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::RecordWorldServiceTime(UQLWorldService* Service, double Seconds)
+{
+    if (Service && bMatchStarted && !bMatchEnded)
+    {
+        WorldServiceTimeMap.FindOrAdd(Service->GetClass()->GetFName()).Add(static_cast<float>(Seconds * 1000.0));
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::NotifyCharacterDamaged(AQLCharacter* Victim, float DamageAmount, AController* EventInstigator, AActor* DamageCauser)
+{
+    if (!bMatchStarted || bMatchEnded)
+    {
+        return;
+    }
+
+    DamagePerWeaponMap.FindOrAdd(GetWeaponName(DamageCauser)) += DamageAmount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::NotifyCharacterKilled(AQLCharacter* Victim, AController* EventInstigator, AActor* DamageCauser)
+{
+    if (!bMatchStarted || bMatchEnded)
+    {
+        return;
+    }
+
+    ++KillCount;
+    ++KillsPerWeaponMap.FindOrAdd(GetWeaponName(DamageCauser));
+
+    // the projectiles of the bots carry no controller, fall back to the instigator of the damage causer
+    APawn* Killer = EventInstigator ? EventInstigator->GetPawn() : nullptr;
+    if (!Killer && DamageCauser)
+    {
+        Killer = DamageCauser->GetInstigator();
+    }
+
+    if (Killer == Victim)
+    {
+        ++SuicideCount;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FString AQLSimulationGameMode::GetWeaponName(AActor* DamageCauser)
+{
+    if (!DamageCauser)
+    {
+        return FString(TEXT("World"));
+    }
+
+    // hitscan weapons cause the damage themselves
+    AQLPickup* Pickup = Cast<AQLPickup>(DamageCauser);
+    if (Pickup && Pickup->GetQLName() != NAME_None)
+    {
+        return Pickup->GetQLName().ToString();
+    }
+
+    // projectiles and abilities are named after their class
+    FString ClassName = DamageCauser->GetClass()->GetName();
+    ClassName.RemoveFromEnd(TEXT("_C"));
+    return ClassName;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::EndMatch()
+{
+    if (bMatchEnded)
+    {
+        return;
+    }
+
+    bMatchEnded = true;
+
+    WriteReport();
+
+    if (bQuitWhenMatchEnds)
+    {
+        FGenericPlatformMisc::RequestExit(false);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+TSharedRef<FJsonObject> AQLSimulationGameMode::MakePercentileObject(const TArray<float>& SampleList)
+{
+    TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+
+    TArray<float> SortedList = SampleList;
+    SortedList.Sort();
+
+    auto GetPercentile = [&SortedList](float Percentile)
+    {
+        if (SortedList.Num() == 0)
+        {
+            return 0.0f;
+        }
+
+        const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedList.Num()) - 1, 0, SortedList.Num() - 1);
+        return SortedList[Index];
+    };
+
+    float Sum = 0.0f;
+    for (float Sample : SortedList)
+    {
+        Sum += Sample;
+    }
+
+    Object->SetNumberField(TEXT("p50"), GetPercentile(0.5f));
+    Object->SetNumberField(TEXT("p90"), GetPercentile(0.9f));
+    Object->SetNumberField(TEXT("p99"), GetPercentile(0.99f));
+    Object->SetNumberField(TEXT("max"), SortedList.Num() > 0 ? SortedList.Last() : 0.0f);
+    Object->SetNumberField(TEXT("mean"), SortedList.Num() > 0 ? Sum / SortedList.Num() : 0.0f);
+
+    return Object;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLSimulationGameMode::WriteReport() const
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    const double RealDuration = FPlatformTime::Seconds() - MatchStartRealTime;
+
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField(TEXT("map"), World->GetMapName());
+    Report->SetNumberField(TEXT("seed"), RandomSeed);
+    Report->SetNumberField(TEXT("bots"), NumBots);
+    Report->SetNumberField(TEXT("timeStep"), FixedTimeStep);
+    Report->SetNumberField(TEXT("gameDuration"), World->GetTimeSeconds());
+    Report->SetNumberField(TEXT("realDuration"), RealDuration);
+    Report->SetNumberField(TEXT("frames"), FrameTimeList.Num());
+    Report->SetNumberField(TEXT("kills"), KillCount);
+    Report->SetNumberField(TEXT("suicides"), SuicideCount);
+
+    TSharedRef<FJsonObject> KillsPerWeapon = MakeShared<FJsonObject>();
+    for (const auto& Item : KillsPerWeaponMap)
+    {
+        KillsPerWeapon->SetNumberField(Item.Key, Item.Value);
+    }
+    Report->SetObjectField(TEXT("killsPerWeapon"), KillsPerWeapon);
+
+    TSharedRef<FJsonObject> DamagePerWeapon = MakeShared<FJsonObject>();
+    for (const auto& Item : DamagePerWeaponMap)
+    {
+        DamagePerWeapon->SetNumberField(Item.Key, Item.Value);
+    }
+    Report->SetObjectField(TEXT("damagePerWeapon"), DamagePerWeapon);
+
+    // milliseconds
+    TSharedRef<FJsonObject> FrameTime = MakeShared<FJsonObject>();
+    FrameTime->SetObjectField(TEXT("Frame"), MakePercentileObject(FrameTimeList));
+    for (const auto& Item : WorldServiceTimeMap)
+    {
+        FrameTime->SetObjectField(Item.Key.ToString(), MakePercentileObject(Item.Value));
+    }
+    Report->SetObjectField(TEXT("frameTimeMs"), FrameTime);
+
+    FString Json;
+    TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&Json);
+    FJsonSerializer::Serialize(Report, JsonWriter);
+
+    const FString Directory = OutputDirectory.IsEmpty() ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Simulation")) : OutputDirectory;
+    const FString FileName = FString::Printf(TEXT("Match_%s_Seed%d_%s.json"),
+        *World->GetMapName(),
+        RandomSeed,
+        *FDateTime::Now().ToString());
+    const FString FilePath = FPaths::Combine(Directory, FileName);
+
+    if (FFileHelper::SaveStringToFile(Json, *FilePath))
+    {
+        QLUtility::Log(FString::Printf(TEXT("simulation: report written to %s"), *FilePath));
+    }
+    else
+    {
+        QLUtility::Log(FString::Printf(TEXT("simulation: failed to write %s"), *FilePath));
+    }
+}
@@ -0,0 +1,126 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLGameModeBase.h"
+#include "QLSimulationGameMode.generated.h"
+
+class AQLCharacter;
+class AQLAIHelper;
+class FJsonObject;
+
+//------------------------------------------------------------
+// Bot-versus-bot match run without a player, meant for headless
+// batch runs used to tune weapons and catch performance regressions:
+//
+//     QL ArenaMap?game=/Script/QL.QLSimulationGameMode -game -nullrhi -nosound -unattended
+//         -QLSimBots=8 -QLSimSeed=42 -QLSimDuration=300 -QLSimTimeStep=0.016667 -QLSimOutput=/path/to/dir
+//
+// The match starts once every bot has been spawned, see AQLAIHelper,
+// and runs at a fixed timestep, as fast as the CPU allows,
+// with the gameplay random stream seeded from -QLSimSeed. When it
+// ends, the kills, the damage per weapon and the frame time
+// percentiles (whole frame and each world service) are written to
+// a JSON file, and the game quits. Run one process per match.
+//------------------------------------------------------------
+UCLASS()
+class QL_API AQLSimulationGameMode : public AQLGameModeBase
+{
+    GENERATED_BODY()
+
+public:
+    AQLSimulationGameMode();
+
+    virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+    virtual void Tick(float DeltaSeconds) override;
+
+    virtual void NotifyCharacterDamaged(AQLCharacter* Victim, float DamageAmount, AController* EventInstigator, AActor* DamageCauser) override;
+
+    virtual void NotifyCharacterKilled(AQLCharacter* Victim, AController* EventInstigator, AActor* DamageCauser) override;
+
+protected:
+    virtual void BeginPlay() override;
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    virtual void RecordWorldServiceTime(UQLWorldService* Service, double Seconds) override;
+
+    //------------------------------------------------------------
+    // Override the properties with the -QLSim* command line switches
+    //------------------------------------------------------------
+    void ParseCommandLine();
+
+    //------------------------------------------------------------
+    // Start the match timer and the measurements once every bot is in
+    //------------------------------------------------------------
+    void StartMatch();
+
+    UFUNCTION()
+    void EndMatch();
+
+    void WriteReport() const;
+
+    //------------------------------------------------------------
+    // p50, p90, p99, max and mean of the samples, in milliseconds
+    //------------------------------------------------------------
+    static TSharedRef<FJsonObject> MakePercentileObject(const TArray<float>& SampleList);
+
+    static FString GetWeaponName(AActor* DamageCauser);
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    int32 NumBots;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    int32 RandomSeed;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    float FixedTimeStep;
+
+    // match length in game time (second)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    float MatchDuration;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    TSubclassOf<AQLCharacter> BotClass;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    bool bQuitWhenMatchEnds;
+
+    // empty: Saved/Simulation under the project directory
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    FString OutputDirectory;
+
+    FTimerHandle MatchTimerHandle;
+
+    bool bMatchStarted;
+
+    bool bMatchEnded;
+
+    double MatchStartRealTime;
+
+    double LastFrameRealTime;
+
+    int32 KillCount;
+
+    int32 SuicideCount;
+
+    TMap<FString, float> DamagePerWeaponMap;
+
+    TMap<FString, int32> KillsPerWeaponMap;
+
+    // wall-clock frame times (millisecond)
+    TArray<float> FrameTimeList;
+
+    // wall-clock tick times of each world service class (millisecond)
+    TMap<FName, TArray<float>> WorldServiceTimeMap;
+};
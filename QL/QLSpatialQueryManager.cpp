@@ -0,0 +1,524 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLSpatialQueryManager.h"
+#include "QLCharacter.h"
+#include "QLGameModeBase.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static TAutoConsoleVariable<float> CVarQLSpatialHashCellSize(
+    TEXT("ql.SpatialHashCellSize"),
+    1000.0f,
+    TEXT("Cell size of the spatial hash of the characters, applied at the next rebuild."),
+    ECVF_Default);
+
+namespace
+{
+    // distance a character may have moved since the hash was rebuilt
+    const float QueryMargin = 256.0f;
+
+    // layout of the characters spawned by ql.SpatialQueryBenchmarkFixture
+    const float FixtureSpacing = 150.0f;
+
+    const float FixtureHeight = 100000.0f;
+
+    //------------------------------------------------------------
+    // Whether two upright capsules overlap
+    //------------------------------------------------------------
+    bool DoUprightCapsulesOverlap(const FVector& CenterA, float RadiusA, float HalfHeightA,
+        const FVector& CenterB, float RadiusB, float HalfHeightB)
+    {
+        // distance between the two vertical segments
+        const float SegmentHalfLengthA = FMath::Max(HalfHeightA - RadiusA, 0.0f);
+        const float SegmentHalfLengthB = FMath::Max(HalfHeightB - RadiusB, 0.0f);
+        const float VerticalGap = FMath::Max(FMath::Abs(CenterA.Z - CenterB.Z) - SegmentHalfLengthA - SegmentHalfLengthB, 0.0f);
+        const float HorizontalDistanceSquared = FVector::DistSquared2D(CenterA, CenterB);
+        const float RadiusSum = RadiusA + RadiusB;
+
+        return HorizontalDistanceSquared + VerticalGap * VerticalGap < RadiusSum * RadiusSum;
+    }
+
+    //------------------------------------------------------------
+    // Splash victim search through the physics scene, as
+    // AQLProjectile::HandleSplashHit() used to do
+    //------------------------------------------------------------
+    int32 FindCharactersInRadiusByOverlap(UWorld* World, const FVector& Center, float Radius)
+    {
+        TArray<FOverlapResult> OutOverlaps;
+        World->OverlapMultiByObjectType(OutOverlaps,
+            Center,
+            FQuat::Identity,
+            FCollisionObjectQueryParams(ECollisionChannel::ECC_Pawn),
+            FCollisionShape::MakeSphere(Radius),
+            FCollisionQueryParams());
+
+        int32 Count = 0;
+        for (auto&& Result : OutOverlaps)
+        {
+            UPrimitiveComponent* Comp = Result.Component.Get();
+            if (Comp && Cast<USkeletalMeshComponent>(Comp) && Cast<AQLCharacter>(Comp->GetOwner()))
+            {
+                ++Count;
+            }
+        }
+
+        return Count;
+    }
+}
+
+//------------------------------------------------------------
+// Time the radius queries of the hash against the physics overlap
+// path, centered around the characters of CharacterList
+//------------------------------------------------------------
+static void MeasureSpatialQueries(UWorld* World,
+    UQLSpatialQueryManager* SpatialQueryManager,
+    const TArray<AQLCharacter*>& CharacterList,
+    int32 QueryCount,
+    float Radius)
+{
+    // same query centers for both paths
+    FRandomStream RandomStream(12345);
+    TArray<FVector> CenterList;
+    CenterList.Reserve(QueryCount);
+    for (int32 Index = 0; Index < QueryCount; ++Index)
+    {
+        AQLCharacter* Character = CharacterList[RandomStream.RandHelper(CharacterList.Num())];
+        CenterList.Add(Character->GetActorLocation() + RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, Radius));
+    }
+
+    int32 HashFoundCount = 0;
+    TArray<AQLCharacter*> ResultList;
+    double StartTime = FPlatformTime::Seconds();
+    for (const FVector& Center : CenterList)
+    {
+        ResultList.Reset();
+        SpatialQueryManager->FindCharactersInRadius(Center, Radius, ResultList);
+        HashFoundCount += ResultList.Num();
+    }
+    const double HashTime = FPlatformTime::Seconds() - StartTime;
+
+    int32 OverlapFoundCount = 0;
+    StartTime = FPlatformTime::Seconds();
+    for (const FVector& Center : CenterList)
+    {
+        OverlapFoundCount += FindCharactersInRadiusByOverlap(World, Center, Radius);
+    }
+    const double OverlapTime = FPlatformTime::Seconds() - StartTime;
+
+    QLUtility::Log(FString::Printf(TEXT("spatial query benchmark: %d characters, %d queries of radius %.0f"),
+        CharacterList.Num(),
+        QueryCount,
+        Radius));
+    QLUtility::Log(FString::Printf(TEXT("    spatial hash: %.3f us per query, %d hits"), HashTime * 1e6 / QueryCount, HashFoundCount));
+    QLUtility::Log(FString::Printf(TEXT("    physics overlap: %.3f us per query, %d hits"), OverlapTime * 1e6 / QueryCount, OverlapFoundCount));
+}
+
+//------------------------------------------------------------
+// Compare the two paths on the characters of the current world
+//------------------------------------------------------------
+static void RunSpatialQueryBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(World);
+    if (!SpatialQueryManager)
+    {
+        return;
+    }
+
+    const int32 QueryCount = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+    const float Radius = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), 1.0f) : 300.0f;
+
+    TArray<AQLCharacter*> CharacterList;
+    SpatialQueryManager->FindNearestCharacters(FVector::ZeroVector, MAX_int32, 0.0f, CharacterList);
+    if (CharacterList.Num() == 0)
+    {
+        QLUtility::Log(TEXT("spatial query benchmark: no character in the world"));
+        return;
+    }
+
+    MeasureSpatialQueries(World, SpatialQueryManager, CharacterList, QueryCount, Radius);
+}
+
+//------------------------------------------------------------
+// Compare the two paths on 8, 32 and 128 characters spawned for
+// the occasion on a grid high above the level, then destroyed.
+// The characters are of the same class as the ones already in
+// the world, so that they collide the same way.
+//------------------------------------------------------------
+static void RunSpatialQueryBenchmarkFixture(const TArray<FString>& Args, UWorld* World)
+{
+    UQLSpatialQueryManager* SpatialQueryManager = AQLGameModeBase::GetWorldService<UQLSpatialQueryManager>(World);
+    if (!SpatialQueryManager)
+    {
+        return;
+    }
+
+    const int32 QueryCount = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+    const float Radius = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), 1.0f) : 300.0f;
+
+    TSubclassOf<AQLCharacter> CharacterClass = AQLCharacter::StaticClass();
+    TArray<AQLCharacter*> ExistingCharacterList;
+    SpatialQueryManager->FindNearestCharacters(FVector::ZeroVector, 1, 0.0f, ExistingCharacterList);
+    if (ExistingCharacterList.Num() > 0)
+    {
+        CharacterClass = ExistingCharacterList[0]->GetClass();
+    }
+
+    const int32 CharacterCountList[] = { 8, 32, 128 };
+
+    for (const int32 CharacterCount : CharacterCountList)
+    {
+        // a few characters within the radius of each query
+        const int32 RowLength = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(CharacterCount)));
+
+        TArray<AQLCharacter*> CharacterList;
+        for (int32 Index = 0; Index < CharacterCount; ++Index)
+        {
+            const FTransform SpawnTransform(FVector(FixtureSpacing * (Index % RowLength), FixtureSpacing * (Index / RowLength), FixtureHeight));
+            AQLCharacter* Character = World->SpawnActorDeferred<AQLCharacter>(CharacterClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+            if (!Character)
+            {
+                continue;
+            }
+
+            // no bot brain for a character that lives for a single frame
+            Character->AutoPossessAI = EAutoPossessAI::Disabled;
+            Character->FinishSpawning(SpawnTransform);
+
+            CharacterList.Add(Character);
+        }
+
+        if (CharacterList.Num() > 0)
+        {
+            // the characters register in BeginPlay(), and the hash is only rebuilt on tick
+            SpatialQueryManager->Tick(0.0f);
+
+            MeasureSpatialQueries(World, SpatialQueryManager, CharacterList, QueryCount, Radius);
+        }
+
+        for (AQLCharacter* Character : CharacterList)
+        {
+            Character->Destroy();
+        }
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs QLSpatialQueryBenchmarkCommand(
+    TEXT("ql.SpatialQueryBenchmark"),
+    TEXT("Compare the radius queries of the character spatial hash with physics overlaps on the characters of the world. Arguments: [QueryCount=1000] [Radius=300]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunSpatialQueryBenchmark));
+
+static FAutoConsoleCommandWithWorldAndArgs QLSpatialQueryBenchmarkFixtureCommand(
+    TEXT("ql.SpatialQueryBenchmarkFixture"),
+    TEXT("Compare the radius queries of the character spatial hash with physics overlaps on 8, 32 and 128 spawned characters. Arguments: [QueryCount=1000] [Radius=300]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunSpatialQueryBenchmarkFixture));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLSpatialQueryManager::UQLSpatialQueryManager() :
+CellSize(1000.0f),
+bIsHashDirty(false)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::Deinitialize()
+{
+    CharacterList.Empty();
+    EntryList.Empty();
+    CellMap.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    // the characters move every frame, so a populated hash is always rebuilt,
+    // and an emptied one once, to drop the last entries
+    if (bIsHashDirty || CharacterList.Num() > 0)
+    {
+        RebuildHash();
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::RegisterCharacter(AQLCharacter* Character)
+{
+    if (!Character)
+    {
+        return;
+    }
+
+    // a rebuild per registration would make spawning N characters O(N^2),
+    // the character is visible to queries from the next tick on
+    CharacterList.AddUnique(Character);
+    bIsHashDirty = true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::UnregisterCharacter(AQLCharacter* Character)
+{
+    // until the next tick, the queries skip the entry once the character is pending kill
+    if (CharacterList.RemoveSwap(Character) > 0)
+    {
+        bIsHashDirty = true;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::RebuildHash()
+{
+    bIsHashDirty = false;
+    CellSize = FMath::Max(CVarQLSpatialHashCellSize.GetValueOnGameThread(), 100.0f);
+
+    EntryList.Reset();
+
+    // keep the cell arrays allocated, the characters rarely leave the populated cells
+    for (auto& Item : CellMap)
+    {
+        Item.Value.Reset();
+    }
+
+    for (int32 Index = CharacterList.Num() - 1; Index >= 0; --Index)
+    {
+        AQLCharacter* Character = CharacterList[Index].Get();
+        if (!Character || Character->IsPendingKill())
+        {
+            CharacterList.RemoveAtSwap(Index);
+            continue;
+        }
+
+        FQLSpatialCharacterEntry Entry;
+        Entry.Character = Character;
+        Entry.Location = Character->GetActorLocation();
+        Entry.CapsuleRadius = 0.0f;
+        Entry.CapsuleHalfHeight = 0.0f;
+
+        UCapsuleComponent* CapsuleComponent = Character->GetCapsuleComponent();
+        if (CapsuleComponent)
+        {
+            CapsuleComponent->GetScaledCapsuleSize(Entry.CapsuleRadius, Entry.CapsuleHalfHeight);
+        }
+
+        const int32 EntryIndex = EntryList.Add(Entry);
+        CellMap.FindOrAdd(GetCellCoordinate(Entry.Location)).Add(EntryIndex);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+FIntVector UQLSpatialQueryManager::GetCellCoordinate(const FVector& Location) const
+{
+    return FIntVector(FMath::FloorToInt(Location.X / CellSize),
+        FMath::FloorToInt(Location.Y / CellSize),
+        FMath::FloorToInt(Location.Z / CellSize));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::ForEachCandidate(const FBox& Box, TFunctionRef<void(const FQLSpatialCharacterEntry&)> Visitor) const
+{
+    const FBox ExpandedBox = Box.ExpandBy(QueryMargin);
+    const FIntVector MinCell = GetCellCoordinate(ExpandedBox.Min);
+    const FIntVector MaxCell = GetCellCoordinate(ExpandedBox.Max);
+
+    const int64 CellCount = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1) * int64(MaxCell.Z - MinCell.Z + 1);
+
+    // a box covering more cells than there are populated cells is cheaper to test entry by entry
+    if (CellCount > CellMap.Num())
+    {
+        for (const FQLSpatialCharacterEntry& Entry : EntryList)
+        {
+            if (ExpandedBox.IsInsideOrOn(Entry.Location))
+            {
+                Visitor(Entry);
+            }
+        }
+        return;
+    }
+
+    for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+        {
+            for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+            {
+                const TArray<int32>* Cell = CellMap.Find(FIntVector(X, Y, Z));
+                if (!Cell)
+                {
+                    continue;
+                }
+
+                for (int32 EntryIndex : *Cell)
+                {
+                    Visitor(EntryList[EntryIndex]);
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::FindCharactersInRadius(const FVector& Center, float Radius, TArray<AQLCharacter*>& OutCharacterList) const
+{
+    FindCharactersOverlappingCapsule(Center, Radius, Radius, OutCharacterList);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::FindCharactersOverlappingCapsule(const FVector& Center, float Radius, float HalfHeight, TArray<AQLCharacter*>& OutCharacterList) const
+{
+    const FVector Extent(Radius, Radius, FMath::Max(HalfHeight, Radius));
+    const FBox Box(Center - Extent, Center + Extent);
+
+    ForEachCandidate(Box, [&](const FQLSpatialCharacterEntry& Entry)
+    {
+        AQLCharacter* Character = Entry.Character.Get();
+        if (!Character || Character->IsPendingKill())
+        {
+            return;
+        }
+
+        // test against the current location rather than the one of the last rebuild
+        if (DoUprightCapsulesOverlap(Center, Radius, HalfHeight,
+            Character->GetActorLocation(), Entry.CapsuleRadius, Entry.CapsuleHalfHeight))
+        {
+            OutCharacterList.Add(Character);
+        }
+    });
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::FindCharactersInBox(const FBox& Box, TArray<AQLCharacter*>& OutCharacterList) const
+{
+    ForEachCandidate(Box, [&](const FQLSpatialCharacterEntry& Entry)
+    {
+        AQLCharacter* Character = Entry.Character.Get();
+        if (Character && !Character->IsPendingKill() && Box.IsInsideOrOn(Character->GetActorLocation()))
+        {
+            OutCharacterList.Add(Character);
+        }
+    });
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::FindCharactersInCone(const FVector& Origin, const FVector& Direction, float HalfAngleInDegree, float Range, TArray<AQLCharacter*>& OutCharacterList) const
+{
+    const FBox Box(Origin - FVector(Range), Origin + FVector(Range));
+    const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(HalfAngleInDegree));
+    const float RangeSquared = Range * Range;
+
+    ForEachCandidate(Box, [&](const FQLSpatialCharacterEntry& Entry)
+    {
+        AQLCharacter* Character = Entry.Character.Get();
+        if (!Character || Character->IsPendingKill())
+        {
+            return;
+        }
+
+        const FVector ToCharacter = Character->GetActorLocation() - Origin;
+        const float DistanceSquared = ToCharacter.SizeSquared();
+        if (DistanceSquared > RangeSquared)
+        {
+            return;
+        }
+
+        // a character at the apex is inside the cone
+        if (DistanceSquared < KINDA_SMALL_NUMBER || FVector::DotProduct(ToCharacter, Direction) >= CosHalfAngle * FMath::Sqrt(DistanceSquared))
+        {
+            OutCharacterList.Add(Character);
+        }
+    });
+}
+
+//------------------------------------------------------------
+// MaxRadius <= 0 means no limit
+//------------------------------------------------------------
+void UQLSpatialQueryManager::FindNearestCharacters(const FVector& Location,
+    int32 MaxCount,
+    float MaxRadius,
+    TArray<AQLCharacter*>& OutCharacterList,
+    TFunctionRef<bool(AQLCharacter*)> Filter) const
+{
+    if (MaxCount <= 0)
+    {
+        return;
+    }
+
+    TArray<TPair<float, AQLCharacter*>> CandidateList;
+
+    auto AddCandidate = [&](const FQLSpatialCharacterEntry& Entry)
+    {
+        AQLCharacter* Character = Entry.Character.Get();
+        if (!Character || Character->IsPendingKill() || !Filter(Character))
+        {
+            return;
+        }
+
+        const float DistanceSquared = FVector::DistSquared(Location, Character->GetActorLocation());
+        if (MaxRadius <= 0.0f || DistanceSquared <= MaxRadius * MaxRadius)
+        {
+            CandidateList.Emplace(DistanceSquared, Character);
+        }
+    };
+
+    if (MaxRadius > 0.0f)
+    {
+        ForEachCandidate(FBox(Location - FVector(MaxRadius), Location + FVector(MaxRadius)), AddCandidate);
+    }
+    else
+    {
+        for (const FQLSpatialCharacterEntry& Entry : EntryList)
+        {
+            AddCandidate(Entry);
+        }
+    }
+
+    CandidateList.Sort([](const TPair<float, AQLCharacter*>& A, const TPair<float, AQLCharacter*>& B)
+    {
+        return A.Key < B.Key;
+    });
+
+    const int32 Count = FMath::Min(MaxCount, CandidateList.Num());
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        OutCharacterList.Add(CandidateList[Index].Value);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpatialQueryManager::FindNearestCharacters(const FVector& Location, int32 MaxCount, float MaxRadius, TArray<AQLCharacter*>& OutCharacterList) const
+{
+    FindNearestCharacters(Location, MaxCount, MaxRadius, OutCharacterList, [](AQLCharacter*) { return true; });
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLSpatialQueryManager::GetCharacterCount() const
+{
+    return CharacterList.Num();
+}
@@ -0,0 +1,126 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLSpatialQueryManager.generated.h"
+
+class AQLCharacter;
+
+//------------------------------------------------------------
+// Snapshot of a registered character taken when the hash is rebuilt
+//------------------------------------------------------------
+struct FQLSpatialCharacterEntry
+{
+    TWeakObjectPtr<AQLCharacter> Character;
+
+    FVector Location;
+
+    float CapsuleRadius;
+
+    float CapsuleHalfHeight;
+};
+
+//------------------------------------------------------------
+// Registry of the live characters of the world, bucketed once per
+// frame into a uniform spatial hash. Radius, capsule, cone and
+// nearest-N queries are answered from the hash without touching
+// the physics scene: the cells give the candidates, which are then
+// tested against the current capsule of each character.
+//
+// AQLCharacter registers itself in BeginPlay() and unregisters in
+// EndPlay(); either only marks the hash dirty, and a character
+// spawned mid-frame is found from the next tick on.
+// ql.SpatialHashCellSize sets the cell size.
+// ql.SpatialQueryBenchmark compares the hash with the physics
+// overlap path on the characters of the current world, and
+// ql.SpatialQueryBenchmarkFixture on 8, 32 and 128 characters
+// spawned for the occasion.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLSpatialQueryManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLSpatialQueryManager();
+
+    virtual void Deinitialize() override;
+
+    //------------------------------------------------------------
+    // Rebuild the spatial hash from the registered characters
+    //------------------------------------------------------------
+    virtual void Tick(float DeltaTime) override;
+
+    void RegisterCharacter(AQLCharacter* Character);
+
+    void UnregisterCharacter(AQLCharacter* Character);
+
+    //------------------------------------------------------------
+    // Characters whose capsule overlaps the sphere, dead ones included
+    //------------------------------------------------------------
+    void FindCharactersInRadius(const FVector& Center, float Radius, TArray<AQLCharacter*>& OutCharacterList) const;
+
+    //------------------------------------------------------------
+    // Characters whose capsule overlaps the upright capsule
+    //------------------------------------------------------------
+    void FindCharactersOverlappingCapsule(const FVector& Center, float Radius, float HalfHeight, TArray<AQLCharacter*>& OutCharacterList) const;
+
+    //------------------------------------------------------------
+    // Characters located inside the box
+    //------------------------------------------------------------
+    void FindCharactersInBox(const FBox& Box, TArray<AQLCharacter*>& OutCharacterList) const;
+
+    //------------------------------------------------------------
+    // Characters located within Range of Origin and within
+    // HalfAngleInDegree of Direction (a unit vector)
+    //------------------------------------------------------------
+    void FindCharactersInCone(const FVector& Origin, const FVector& Direction, float HalfAngleInDegree, float Range, TArray<AQLCharacter*>& OutCharacterList) const;
+
+    //------------------------------------------------------------
+    // Up to MaxCount characters within MaxRadius of Location accepted
+    // by Filter, sorted from the nearest to the farthest
+    //------------------------------------------------------------
+    void FindNearestCharacters(const FVector& Location,
+        int32 MaxCount,
+        float MaxRadius,
+        TArray<AQLCharacter*>& OutCharacterList,
+        TFunctionRef<bool(AQLCharacter*)> Filter) const;
+
+    void FindNearestCharacters(const FVector& Location, int32 MaxCount, float MaxRadius, TArray<AQLCharacter*>& OutCharacterList) const;
+
+    int32 GetCharacterCount() const;
+
+protected:
+    //------------------------------------------------------------
+    // Call Visitor on each entry of the cells overlapping the box.
+    // The box is expanded to account for the movement of the
+    // characters since the hash was rebuilt.
+    //------------------------------------------------------------
+    void ForEachCandidate(const FBox& Box, TFunctionRef<void(const FQLSpatialCharacterEntry&)> Visitor) const;
+
+    FIntVector GetCellCoordinate(const FVector& Location) const;
+
+    void RebuildHash();
+
+    TArray<TWeakObjectPtr<AQLCharacter>> CharacterList;
+
+    TArray<FQLSpatialCharacterEntry> EntryList;
+
+    // cell coordinate to the indices into EntryList
+    TMap<FIntVector, TArray<int32>> CellMap;
+
+    float CellSize;
+
+    // set when the registry changes, the hash is only rebuilt on tick
+    bool bIsHashDirty;
+};
@@ -0,0 +1,454 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLSpawnPointManager.h"
+#include "QLCharacter.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "NavigationSystem.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLSpawnPointCandidateCount(
+    TEXT("ql.SpawnPointCandidateCount"),
+    64,
+    TEXT("Number of spawn point candidates sampled from the navmesh."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarQLSpawnPointScoreInterval(
+    TEXT("ql.SpawnPointScoreInterval"),
+    0.5f,
+    TEXT("Time between two scoring passes of the spawn point candidates (second)."),
+    ECVF_Default);
+
+namespace
+{
+    // capsule of a character standing on the candidate
+    const float CandidateCapsuleRadius = 30.0f;
+    const float CandidateCapsuleHalfHeight = 85.0f;
+    const float CandidateHeightAboveNavmesh = 100.0f;
+    const float CandidateMinSpacing = 300.0f;
+    const float EyeHeight = 60.0f;
+
+    // candidates farther than this from every character are equally safe
+    const float SafeDistance = 2500.0f;
+
+    // the line of sight is traced from the nearest characters only
+    const int32 LineOfSightCharacterCount = 2;
+    const float LineOfSightRange = 6000.0f;
+
+    const float RecentEventDuration = 10.0f;
+    const float RecentEventRadius = 800.0f;
+
+    const float DistanceWeight = 1.0f;
+    const float VisibleWeight = 1.0f;
+    const float RecentEventWeight = 0.5f;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLSpawnPointManager::UQLSpawnPointManager() :
+NextRank(0),
+PendingTraceCount(0),
+bIsScoring(false),
+bIsDeterministic(false),
+NextScoringTime(0.0f)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::Initialize()
+{
+    Super::Initialize();
+
+    LineOfSightTraceDelegate.BindUObject(this, &UQLSpawnPointManager::OnLineOfSightTraceCompleted);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::Deinitialize()
+{
+    // the task only touches its own copy of the input
+    if (ScoringFuture.IsValid())
+    {
+        ScoringFuture.Wait();
+        ScoringFuture = TFuture<TArray<int32>>();
+    }
+
+    bIsScoring = false;
+    LineOfSightTraceDelegate.Unbind();
+
+    CandidateLocationList.Empty();
+    RankedCandidateList.Empty();
+    RecentEventList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::SetDeterministic(bool bFlag)
+{
+    bIsDeterministic = bFlag;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    if (bIsScoring && ScoringFuture.IsValid() && ScoringFuture.IsReady())
+    {
+        PublishRanking(ScoringFuture.Get());
+        ScoringFuture = TFuture<TArray<int32>>();
+        bIsScoring = false;
+    }
+
+    if (!bIsScoring && World->GetTimeSeconds() >= NextScoringTime && EnsureCandidates())
+    {
+        StartScoringPass();
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLSpawnPointManager::EnsureCandidates()
+{
+    if (CandidateLocationList.Num() > 0)
+    {
+        return true;
+    }
+
+    UWorld* World = GetWorld();
+    UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(World);
+    if (!World || !NavSys)
+    {
+        return false;
+    }
+
+    const int32 CandidateCount = FMath::Max(CVarQLSpawnPointCandidateCount.GetValueOnGameThread(), 1);
+    const FCollisionShape CandidateShape = FCollisionShape::MakeCapsule(CandidateCapsuleRadius, CandidateCapsuleHalfHeight);
+
+    for (int32 Attempt = 0; Attempt < 4 * CandidateCount && CandidateLocationList.Num() < CandidateCount; ++Attempt)
+    {
+        // the navmesh may not be built yet, try again later
+        FNavLocation NavLocation;
+        if (!NavSys->GetRandomPoint(NavLocation))
+        {
+            break;
+        }
+
+        const FVector Location = NavLocation.Location + FVector(0.0f, 0.0f, CandidateHeightAboveNavmesh);
+
+        // inside the geometry
+        if (World->OverlapBlockingTestByChannel(Location, FQuat::Identity, ECollisionChannel::ECC_Pawn, CandidateShape))
+        {
+            continue;
+        }
+
+        // spread the candidates over the map
+        bool bIsTooClose = false;
+        for (const FVector& CandidateLocation : CandidateLocationList)
+        {
+            if (FVector::DistSquared(CandidateLocation, Location) < CandidateMinSpacing * CandidateMinSpacing)
+            {
+                bIsTooClose = true;
+                break;
+            }
+        }
+
+        if (!bIsTooClose)
+        {
+            CandidateLocationList.Add(Location);
+        }
+    }
+
+    return CandidateLocationList.Num() > 0;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLSpawnPointManager::GetSpawnTransform(FTransform& OutTransform)
+{
+    if (!EnsureCandidates())
+    {
+        return false;
+    }
+
+    if (RankedCandidateList.Num() == 0)
+    {
+        RankNow();
+    }
+
+    const int32 CandidateIndex = RankedCandidateList[NextRank];
+
+    // the following spawns of the same ranking take the next best candidates
+    NextRank = (NextRank + 1) % RankedCandidateList.Num();
+
+    const FVector& Location = CandidateLocationList[CandidateIndex];
+    AddEvent(Location);
+
+    FRotator RandomYawRotation = FRotator(0.0f, QLUtility::RandRange(0.0f, 360.0f), 0.0f);
+    OutTransform = FTransform(RandomYawRotation, Location, FVector(1.0f));
+    return true;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::AddDeathLocation(const FVector& Location)
+{
+    AddEvent(Location);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::AddEvent(const FVector& Location)
+{
+    UWorld* World = GetWorld();
+    if (World)
+    {
+        RecentEventList.Add({ Location, World->GetTimeSeconds() });
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::UpdateScoringInput()
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    const float CurrentTime = World->GetTimeSeconds();
+    RecentEventList.RemoveAll([CurrentTime](const FQLSpawnPointEvent& Event)
+    {
+        return CurrentTime - Event.Time > RecentEventDuration;
+    });
+
+    ScoringInput.CandidateLocationList = CandidateLocationList;
+    ScoringInput.EventList = RecentEventList;
+    ScoringInput.CurrentTime = CurrentTime;
+    ScoringInput.VisibleList.Init(false, CandidateLocationList.Num());
+
+    ScoringInput.CharacterLocationList.Reset();
+    for (TActorIterator<AQLCharacter> It(World); It; ++It)
+    {
+        if (It->IsAlive() && !It->IsPendingKill())
+        {
+            ScoringInput.CharacterLocationList.Add(It->GetActorLocation());
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::RankNow()
+{
+    UpdateScoringInput();
+    PublishRanking(RankCandidates(ScoringInput));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::StartScoringPass()
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+
+    bIsScoring = true;
+    NextScoringTime = World->GetTimeSeconds() + CVarQLSpawnPointScoreInterval.GetValueOnGameThread();
+
+    UpdateScoringInput();
+
+    // line of sight from the nearest characters, against the static geometry
+    FCollisionQueryParams Params(FName(TEXT("SpawnPointLineOfSight")));
+    FCollisionObjectQueryParams ObjectParams(ECollisionChannel::ECC_WorldStatic);
+    const FVector EyeOffset(0.0f, 0.0f, EyeHeight);
+
+    PendingTraceCount = 0;
+    TArray<int32, TInlineAllocator<LineOfSightCharacterCount>> NearestList;
+
+    for (int32 CandidateIndex = 0; CandidateIndex < ScoringInput.CandidateLocationList.Num(); ++CandidateIndex)
+    {
+        const FVector& CandidateLocation = ScoringInput.CandidateLocationList[CandidateIndex];
+
+        // partial selection of the nearest characters
+        NearestList.Reset();
+        for (int32 CharacterIndex = 0; CharacterIndex < ScoringInput.CharacterLocationList.Num(); ++CharacterIndex)
+        {
+            const float DistanceSquared = FVector::DistSquared(CandidateLocation, ScoringInput.CharacterLocationList[CharacterIndex]);
+            if (DistanceSquared > LineOfSightRange * LineOfSightRange)
+            {
+                continue;
+            }
+
+            int32 InsertIndex = NearestList.Num();
+            while (InsertIndex > 0
+                && FVector::DistSquared(CandidateLocation, ScoringInput.CharacterLocationList[NearestList[InsertIndex - 1]]) > DistanceSquared)
+            {
+                --InsertIndex;
+            }
+
+            if (InsertIndex < LineOfSightCharacterCount)
+            {
+                NearestList.Insert(CharacterIndex, InsertIndex);
+                if (NearestList.Num() > LineOfSightCharacterCount)
+                {
+                    NearestList.Pop(false);
+                }
+            }
+        }
+
+        for (int32 CharacterIndex : NearestList)
+        {
+            World->AsyncLineTraceByObjectType(EAsyncTraceType::Single,
+                CandidateLocation + EyeOffset,
+                ScoringInput.CharacterLocationList[CharacterIndex] + EyeOffset,
+                ObjectParams,
+                Params,
+                &LineOfSightTraceDelegate,
+                CandidateIndex);
+
+            ++PendingTraceCount;
+        }
+    }
+
+    if (PendingTraceCount == 0)
+    {
+        LaunchScoringTask();
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::OnLineOfSightTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+    if (!bIsScoring || PendingTraceCount <= 0)
+    {
+        return;
+    }
+
+    const bool bIsBlocked = TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit;
+    const int32 CandidateIndex = static_cast<int32>(TraceDatum.UserData);
+    if (!bIsBlocked && ScoringInput.VisibleList.IsValidIndex(CandidateIndex))
+    {
+        ScoringInput.VisibleList[CandidateIndex] = true;
+    }
+
+    --PendingTraceCount;
+    if (PendingTraceCount == 0)
+    {
+        LaunchScoringTask();
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::LaunchScoringTask()
+{
+    const FQLSpawnPointScoringInput Input = ScoringInput;
+    ScoringFuture = Async<TArray<int32>>(EAsyncExecution::ThreadPool, [Input]()
+    {
+        return RankCandidates(Input);
+    });
+
+    if (bIsDeterministic)
+    {
+        ScoringFuture.Wait();
+        PublishRanking(ScoringFuture.Get());
+        ScoringFuture = TFuture<TArray<int32>>();
+        bIsScoring = false;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLSpawnPointManager::PublishRanking(const TArray<int32>& RankedList)
+{
+    RankedCandidateList = RankedList;
+    NextRank = 0;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+TArray<int32> UQLSpawnPointManager::RankCandidates(const FQLSpawnPointScoringInput& Input)
+{
+    const int32 CandidateCount = Input.CandidateLocationList.Num();
+
+    TArray<float> ScoreList;
+    ScoreList.SetNumZeroed(CandidateCount);
+
+    for (int32 CandidateIndex = 0; CandidateIndex < CandidateCount; ++CandidateIndex)
+    {
+        const FVector& CandidateLocation = Input.CandidateLocationList[CandidateIndex];
+
+        // far from the characters
+        float NearestDistanceSquared = SafeDistance * SafeDistance;
+        for (const FVector& CharacterLocation : Input.CharacterLocationList)
+        {
+            NearestDistanceSquared = FMath::Min(NearestDistanceSquared, FVector::DistSquared(CandidateLocation, CharacterLocation));
+        }
+        float Score = DistanceWeight * FMath::Sqrt(NearestDistanceSquared) / SafeDistance;
+
+        // out of sight
+        if (Input.VisibleList.IsValidIndex(CandidateIndex) && Input.VisibleList[CandidateIndex])
+        {
+            Score -= VisibleWeight;
+        }
+
+        // away from the recent deaths and spawns
+        for (const FQLSpawnPointEvent& Event : Input.EventList)
+        {
+            const float Distance = FVector::Dist(CandidateLocation, Event.Location);
+            const float Age = Input.CurrentTime - Event.Time;
+            if (Distance < RecentEventRadius && Age < RecentEventDuration)
+            {
+                Score -= RecentEventWeight * (1.0f - Distance / RecentEventRadius) * (1.0f - Age / RecentEventDuration);
+            }
+        }
+
+        ScoreList[CandidateIndex] = Score;
+    }
+
+    TArray<int32> RankedList;
+    RankedList.Reserve(CandidateCount);
+    for (int32 CandidateIndex = 0; CandidateIndex < CandidateCount; ++CandidateIndex)
+    {
+        RankedList.Add(CandidateIndex);
+    }
+
+    // the index breaks the ties, for a deterministic ranking
+    RankedList.Sort([&ScoreList](int32 A, int32 B)
+    {
+        if (ScoreList[A] != ScoreList[B])
+        {
+            return ScoreList[A] > ScoreList[B];
+        }
+
+        return A < B;
+    });
+
+    return RankedList;
+}
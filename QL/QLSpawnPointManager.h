@@ -0,0 +1,140 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "Async/Future.h"
+#include "QLSpawnPointManager.generated.h"
+
+//------------------------------------------------------------
+// A death or a spawn, which makes the nearby candidates less
+// attractive for a while
+//------------------------------------------------------------
+struct FQLSpawnPointEvent
+{
+    FVector Location;
+
+    float Time;
+};
+
+//------------------------------------------------------------
+// Everything the scoring task needs, copied on the game thread
+//------------------------------------------------------------
+struct FQLSpawnPointScoringInput
+{
+    TArray<FVector> CandidateLocationList;
+
+    TArray<FVector> CharacterLocationList;
+
+    TArray<FQLSpawnPointEvent> EventList;
+
+    // per candidate, true if a character sees it
+    TArray<bool> VisibleList;
+
+    float CurrentTime;
+};
+
+//------------------------------------------------------------
+// Spawn locations of the characters and the bots.
+// A set of candidates is sampled from the navmesh once, dropping
+// the points whose capsule would overlap the geometry. A few times
+// a second, the candidates are checked for line of sight from the
+// nearest characters with async traces, then scored on a worker
+// thread: far from the characters, out of sight and away from the
+// recent deaths and spawns is better. GetSpawnTransform() returns
+// the next best candidate of the last ranking in O(1).
+//
+// In deterministic mode (simulation harness) the scoring task is
+// waited for in the frame it is launched, so that the ranking only
+// depends on the random seed and the frame number.
+//
+// ql.SpawnPointCandidateCount and ql.SpawnPointScoreInterval tune
+// the service.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLSpawnPointManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLSpawnPointManager();
+
+    virtual void Initialize() override;
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    //------------------------------------------------------------
+    // Return false if the navmesh has no valid candidate
+    //------------------------------------------------------------
+    bool GetSpawnTransform(FTransform& OutTransform);
+
+    void AddDeathLocation(const FVector& Location);
+
+    void SetDeterministic(bool bFlag);
+
+protected:
+    //------------------------------------------------------------
+    // Sample the candidates from the navmesh if not done yet
+    //------------------------------------------------------------
+    bool EnsureCandidates();
+
+    void StartScoringPass();
+
+    void OnLineOfSightTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+    void LaunchScoringTask();
+
+    void PublishRanking(const TArray<int32>& RankedList);
+
+    //------------------------------------------------------------
+    // Rank on the game thread without line of sight, used until
+    // the first scoring pass completes
+    //------------------------------------------------------------
+    void RankNow();
+
+    void UpdateScoringInput();
+
+    void AddEvent(const FVector& Location);
+
+    //------------------------------------------------------------
+    // Candidate indices sorted from the best to the worst.
+    // Runs on a worker thread, only touches its input.
+    //------------------------------------------------------------
+    static TArray<int32> RankCandidates(const FQLSpawnPointScoringInput& Input);
+
+    TArray<FVector> CandidateLocationList;
+
+    // best first, as of the last scoring pass
+    TArray<int32> RankedCandidateList;
+
+    int32 NextRank;
+
+    TArray<FQLSpawnPointEvent> RecentEventList;
+
+    FQLSpawnPointScoringInput ScoringInput;
+
+    TFuture<TArray<int32>> ScoringFuture;
+
+    FTraceDelegate LineOfSightTraceDelegate;
+
+    int32 PendingTraceCount;
+
+    bool bIsScoring;
+
+    bool bIsDeterministic;
+
+    float NextScoringTime;
+};
@@ -0,0 +1,222 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLTraceManager.h"
+#include "QLCharacter.h"
+#include "Camera/CameraComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLAsyncWeaponTrace(
+    TEXT("ql.AsyncWeaponTrace"),
+    1,
+    TEXT("1: weapon hitscan traces are batched per frame and dispatched through the async trace API.\n")
+    TEXT("0: weapon hitscan traces are performed synchronously on the game thread."),
+    ECVF_Default);
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLTraceManager::UQLTraceManager() :
+NextRequestId(0),
+CoalescedRequestCount(0)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLTraceManager::Initialize()
+{
+    Super::Initialize();
+
+    AsyncTraceDelegate.BindUObject(this, &UQLTraceManager::OnAsyncTraceCompleted);
+
+    // the async trace API executes the requests made in a frame after the actors have ticked,
+    // so the pending requests are dispatched as late as possible to catch all weapons
+    PostActorTickDelegateHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UQLTraceManager::OnWorldPostActorTick);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLTraceManager::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickDelegateHandle);
+
+    PendingRequestList.Empty();
+    InFlightRequestMap.Empty();
+    AsyncTraceDelegate.Unbind();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLTraceManager::IsAsyncTraceEnabled()
+{
+    return CVarQLAsyncWeaponTrace.GetValueOnGameThread() != 0;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+int32 UQLTraceManager::GetCoalescedRequestCount() const
+{
+    return CoalescedRequestCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLTraceManager::RequestTraceFromCharacterPOV(AQLCharacter* Character, float TraceRange, const FQLTraceDelegate& Callback)
+{
+    if (!Character)
+    {
+        return;
+    }
+
+    // synchronous path, identical to the original behavior
+    if (!IsAsyncTraceEnabled())
+    {
+        FHitResult HitResult = Character->RayTraceFromCharacterPOV(TraceRange);
+        Callback.ExecuteIfBound(HitResult);
+        return;
+    }
+
+    UCameraComponent* Camera = Character->GetFirstPersonCameraComponent();
+    if (!Camera)
+    {
+        return;
+    }
+
+    // the ray is determined by the camera at the moment of the request
+    const FVector Start = Camera->GetComponentLocation();
+    const FVector End = Camera->GetForwardVector() * TraceRange + Start;
+    const ECollisionChannel TraceChannel = ECollisionChannel::ECC_Camera;
+
+    // the same ray has already been requested in this frame
+    for (auto&& PendingRequest : PendingRequestList)
+    {
+        if (PendingRequest.Character.Get() == Character &&
+            PendingRequest.Start == Start &&
+            PendingRequest.End == End &&
+            PendingRequest.TraceChannel == TraceChannel)
+        {
+            PendingRequest.CallbackList.Add(Callback);
+            ++CoalescedRequestCount;
+            Character->CountViewTraceCacheHit();
+            return;
+        }
+    }
+
+    // the same ray has already been traced in this frame, or in an earlier
+    // frame from a camera that has not moved since
+    FHitResult CachedHitResult(ForceInit);
+    if (Character->FindCachedViewTrace(TraceRange, TraceChannel, CachedHitResult))
+    {
+        Callback.ExecuteIfBound(CachedHitResult);
+        return;
+    }
+
+    FQLTraceRequest Request;
+    Request.Character = Character;
+    Request.Start = Start;
+    Request.End = End;
+    Request.TraceChannel = TraceChannel;
+    Request.TraceRange = TraceRange;
+    Request.CameraRotation = Camera->GetComponentQuat();
+    Request.CallbackList.Add(Callback);
+
+    PendingRequestList.Add(Request);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLTraceManager::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    if (World != GetWorld())
+    {
+        return;
+    }
+
+    DispatchPendingRequests();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLTraceManager::DispatchPendingRequests()
+{
+    UWorld* World = GetWorld();
+    if (!World || PendingRequestList.Num() == 0)
+    {
+        return;
+    }
+
+    for (auto&& Request : PendingRequestList)
+    {
+        if (!Request.Character.IsValid())
+        {
+            continue;
+        }
+
+        // same query parameters as AQLCharacter::RayTraceFromCharacterPOV()
+        FCollisionQueryParams Params(FName(TEXT("lineTrace")),
+                                     true, // bTraceComplex
+                                     Request.Character.Get()); // ignore actor
+        Params.bReturnPhysicalMaterial = false;
+
+        const uint32 RequestId = NextRequestId++;
+
+        World->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+            Request.Start,
+            Request.End,
+            Request.TraceChannel,
+            Params,
+            FCollisionResponseParams::DefaultResponseParam,
+            &AsyncTraceDelegate,
+            RequestId);
+
+        InFlightRequestMap.Add(RequestId, MoveTemp(Request));
+    }
+
+    PendingRequestList.Reset();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLTraceManager::OnAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+    FQLTraceRequest Request;
+    if (!InFlightRequestMap.RemoveAndCopyValue(TraceDatum.UserData, Request))
+    {
+        return;
+    }
+
+    // the weapon or its user may be gone in the meantime
+    if (!Request.Character.IsValid())
+    {
+        return;
+    }
+
+    FHitResult HitResult(ForceInit);
+    if (TraceDatum.OutHits.Num() > 0)
+    {
+        HitResult = TraceDatum.OutHits[0];
+    }
+    else
+    {
+        HitResult.TraceStart = TraceDatum.Start;
+        HitResult.TraceEnd = TraceDatum.End;
+    }
+
+    Request.Character->AddAsyncViewTraceToCache(Request.Start, Request.CameraRotation, Request.TraceRange, Request.TraceChannel, HitResult);
+
+    for (const auto& Callback : Request.CallbackList)
+    {
+        Callback.ExecuteIfBound(HitResult);
+    }
+}
@@ -0,0 +1,102 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "QLTraceManager.generated.h"
+
+class AQLCharacter;
+
+DECLARE_DELEGATE_OneParam(FQLTraceDelegate, const FHitResult&);
+
+//------------------------------------------------------------
+// A ray trace requested by a weapon, waiting to be dispatched
+//------------------------------------------------------------
+struct FQLTraceRequest
+{
+    TWeakObjectPtr<AQLCharacter> Character;
+
+    FVector Start;
+
+    FVector End;
+
+    ECollisionChannel TraceChannel;
+
+    // to cache the result in the character, see AQLCharacter::AddAsyncViewTraceToCache()
+    float TraceRange;
+
+    FQuat CameraRotation;
+
+    // identical requests made in the same frame share one trace
+    TArray<FQLTraceDelegate> CallbackList;
+};
+
+//------------------------------------------------------------
+// Collect the hitscan traces of all weapons during a frame and
+// dispatch them as one batch through the async trace API at the
+// end of the frame. The results are delivered to the weapons
+// via callbacks at the beginning of the next frame.
+//
+// ql.AsyncWeaponTrace 0 keeps the original synchronous behavior,
+// in which case the callback is executed immediately.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLTraceManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLTraceManager();
+
+    virtual void Initialize() override;
+
+    virtual void Deinitialize() override;
+
+    //------------------------------------------------------------
+    // Ray trace from the point of view of Character, see
+    // AQLCharacter::RayTraceFromCharacterPOV()
+    //------------------------------------------------------------
+    void RequestTraceFromCharacterPOV(AQLCharacter* Character, float TraceRange, const FQLTraceDelegate& Callback);
+
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    static bool IsAsyncTraceEnabled();
+
+    //------------------------------------------------------------
+    // Number of requests merged into an identical request of the same
+    // frame, also counted as hits by the view trace cache of the character
+    //------------------------------------------------------------
+    int32 GetCoalescedRequestCount() const;
+
+protected:
+    void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+    void DispatchPendingRequests();
+
+    void OnAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+    // requests collected during the current frame
+    TArray<FQLTraceRequest> PendingRequestList;
+
+    // requests dispatched to the async trace API, keyed by user data
+    TMap<uint32, FQLTraceRequest> InFlightRequestMap;
+
+    uint32 NextRequestId;
+
+    int32 CoalescedRequestCount;
+
+    FTraceDelegate AsyncTraceDelegate;
+
+    FDelegateHandle PostActorTickDelegateHandle;
+};
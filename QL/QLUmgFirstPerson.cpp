@@ -15,24 +15,30 @@
 #include "QLPlayerController.h"
 #include "QLUtility.h"
 #include "Engine/World.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "Blueprint/WidgetTree.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "SceneView.h"
 
 //------------------------------------------------------------
 //------------------------------------------------------------
 UQLUmgFirstPerson::UQLUmgFirstPerson(const FObjectInitializer& ObjectInitializer) :
 Super(ObjectInitializer),
-DamageText0(nullptr),
-DamageText1(nullptr),
-DamageText2(nullptr),
-DamageText3(nullptr),
-DamageText4(nullptr),
-DamageText5(nullptr),
-FadeAnimationCPP0(nullptr),
-FadeAnimationCPP1(nullptr),
-FadeAnimationCPP2(nullptr),
-FadeAnimationCPP3(nullptr),
-FadeAnimationCPP4(nullptr),
-FadeAnimationCPP5(nullptr),
-Counter(0)
+HUDInvalidationBox(nullptr),
+TextHealthValue(nullptr),
+TextArmorValue(nullptr),
+TextSpeedValue(nullptr),
+TextFPSValue(nullptr),
+DamageNumberCanvas(nullptr),
+DamageNumberTemplate(nullptr),
+DamageNumberPoolSize(12),
+DamageNumberAggregationTime(0.4f),
+DamageNumberDuration(1.0f),
+DamageNumberRiseSpeed(40.0f),
+ActiveDamageNumberCount(0),
+DisplayedFPS(0.0f),
+DisplayedSpeed(0.0f)
 {
 
 }
@@ -46,29 +52,7 @@ void UQLUmgFirstPerson::NativeConstruct()
     // Call the Blueprint "Event Construct" node
     Super::NativeConstruct();
 
-    if (DamageText0 && DamageText1 && DamageText2 && DamageText3 && DamageText4 && DamageText5)
-    {
-        DamageTextList.Add(DamageText0);
-        DamageTextList.Add(DamageText1);
-        DamageTextList.Add(DamageText2);
-        DamageTextList.Add(DamageText3);
-        DamageTextList.Add(DamageText4);
-        DamageTextList.Add(DamageText5);
-
-        CurrentDamageText = DamageTextList[0];
-    }
-
-    if (FadeAnimationCPP0 && FadeAnimationCPP1 && FadeAnimationCPP2 && FadeAnimationCPP3 && FadeAnimationCPP4 && FadeAnimationCPP5)
-    {
-        FadeAnimationCPPList.Add(FadeAnimationCPP0);
-        FadeAnimationCPPList.Add(FadeAnimationCPP1);
-        FadeAnimationCPPList.Add(FadeAnimationCPP2);
-        FadeAnimationCPPList.Add(FadeAnimationCPP3);
-        FadeAnimationCPPList.Add(FadeAnimationCPP4);
-        FadeAnimationCPPList.Add(FadeAnimationCPP5);
-
-        CurrentFadeAnimationCPP = FadeAnimationCPPList[0];
-    }
+    CreateDamageNumberPool();
 
     if (QuadDamageProgress)
     {
@@ -108,57 +92,224 @@ void UQLUmgFirstPerson::NativeTick(const FGeometry& MyGeometry, float InDeltaTim
     // Make sure to call the base class's NativeTick function
     Super::NativeTick(MyGeometry, InDeltaTime);
 
-    // Do your custom tick stuff here
+    UpdateDamageNumbers();
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void UQLUmgFirstPerson::ShowDamageOnScreen(const FString& msg, const FVector& Location)
+void UQLUmgFirstPerson::CreateDamageNumberPool()
 {
-    // update pointer
-    CurrentDamageText = DamageTextList[Counter];
-    CurrentFadeAnimationCPP = FadeAnimationCPPList[Counter];
-
-    // set perturbation
-    float temp = Counter * 10.0f;
-    float PerturbationX = Counter % 2 == 0 ? temp : -temp;
-    float PerturbationY = -temp;
-
-    // convert coordinates
-    FVector2D ScreenLocation;
-    // todo: it appears that ProjectWorldLocationToScreen() only works well in full screen mode
-    // not in PIE. need to investigate.
-    bool bIsConversionSuccessful = QLPlayerController->ProjectWorldLocationToScreen(Location, ScreenLocation);
-    if (!bIsConversionSuccessful)
+    // NativeConstruct() runs again when the widget is added back to the viewport
+    if (DamageTextList.Num() > 0)
     {
         return;
     }
 
-    if (!CurrentDamageText.IsValid() || !CurrentFadeAnimationCPP.IsValid())
+    UCanvasPanel* Canvas = DamageNumberCanvas ? DamageNumberCanvas : Cast<UCanvasPanel>(GetRootWidget());
+    if (!Canvas || !WidgetTree)
     {
         return;
     }
 
-    CurrentDamageText->SetText(FText::FromString(msg));
+    if (DamageNumberTemplate)
+    {
+        DamageNumberTemplate->SetVisibility(ESlateVisibility::Collapsed);
+    }
 
-    UCanvasPanelSlot* CanvasSlot = Cast<UCanvasPanelSlot>(CurrentDamageText->Slot);
-    ScreenLocation.X += PerturbationX;
-    ScreenLocation.Y += PerturbationY;
-    CanvasSlot->SetPosition(ScreenLocation);
+    for (int32 Index = 0; Index < DamageNumberPoolSize; ++Index)
+    {
+        UTextBlock* DamageText = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass());
+        if (!DamageText)
+        {
+            continue;
+        }
 
-    // display animation
-    if (!CurrentFadeAnimationCPP.IsValid())
+        if (DamageNumberTemplate)
+        {
+            DamageText->SetFont(DamageNumberTemplate->Font);
+            DamageText->SetColorAndOpacity(DamageNumberTemplate->ColorAndOpacity);
+            DamageText->SetShadowOffset(DamageNumberTemplate->ShadowOffset);
+            DamageText->SetShadowColorAndOpacity(DamageNumberTemplate->ShadowColorAndOpacity);
+        }
+
+        DamageText->SetVisibility(ESlateVisibility::Collapsed);
+
+        UCanvasPanelSlot* CanvasSlot = Canvas->AddChildToCanvas(DamageText);
+        if (CanvasSlot)
+        {
+            CanvasSlot->SetAutoSize(true);
+            CanvasSlot->SetAlignment(FVector2D(0.5f, 0.5f));
+        }
+
+        FQLDamageNumber DamageNumber;
+        DamageNumber.Offset = FVector::ZeroVector;
+        DamageNumber.Total = 0.0f;
+        DamageNumber.DisplayedTotal = INDEX_NONE;
+        DamageNumber.LastHitTime = 0.0f;
+        DamageNumber.TextIndex = DamageTextList.Add(DamageText);
+        DamageNumber.bIsActive = false;
+        DamageNumberList.Add(DamageNumber);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLUmgFirstPerson::ShowDamageOnScreen(float DamageAmount, const FVector& Location, AActor* Victim)
+{
+    UWorld* World = GetWorld();
+    if (!World || DamageNumberList.Num() == 0)
     {
         return;
     }
 
-    PlayAnimation(CurrentFadeAnimationCPP.Get());
+    const float CurrentTime = World->GetTimeSeconds();
+    FQLDamageNumber* DamageNumber = nullptr;
 
-    // update counter
-    ++Counter;
-    if (Counter >= DamageTextList.Num())
+    // add to the running total of the victim
+    if (Victim)
     {
-        Counter = 0;
+        for (FQLDamageNumber& Item : DamageNumberList)
+        {
+            if (Item.bIsActive && Item.Victim.Get() == Victim && CurrentTime - Item.LastHitTime <= DamageNumberAggregationTime)
+            {
+                DamageNumber = &Item;
+                break;
+            }
+        }
+    }
+
+    // otherwise take a free number, or the oldest one
+    if (!DamageNumber)
+    {
+        for (FQLDamageNumber& Item : DamageNumberList)
+        {
+            if (!Item.bIsActive)
+            {
+                DamageNumber = &Item;
+                break;
+            }
+
+            if (!DamageNumber || Item.LastHitTime < DamageNumber->LastHitTime)
+            {
+                DamageNumber = &Item;
+            }
+        }
+
+        if (!DamageNumber->bIsActive)
+        {
+            ++ActiveDamageNumberCount;
+        }
+
+        DamageNumber->Victim = Victim;
+        DamageNumber->Offset = Victim ? Location - Victim->GetActorLocation() : Location;
+        DamageNumber->Total = 0.0f;
+        DamageNumber->DisplayedTotal = INDEX_NONE;
+        DamageNumber->bIsActive = true;
+    }
+
+    DamageNumber->Total += DamageAmount;
+    DamageNumber->LastHitTime = CurrentTime;
+
+    // the text only changes with the rounded total
+    const int32 Total = FMath::RoundToInt(DamageNumber->Total);
+    UTextBlock* DamageText = DamageTextList[DamageNumber->TextIndex];
+    if (DamageText && Total != DamageNumber->DisplayedTotal)
+    {
+        DamageText->SetText(FText::AsNumber(Total));
+        DamageNumber->DisplayedTotal = Total;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLUmgFirstPerson::DeactivateDamageNumber(FQLDamageNumber& DamageNumber)
+{
+    UTextBlock* DamageText = DamageTextList[DamageNumber.TextIndex];
+    if (DamageText)
+    {
+        DamageText->SetVisibility(ESlateVisibility::Collapsed);
+    }
+
+    DamageNumber.Victim = nullptr;
+    DamageNumber.bIsActive = false;
+    --ActiveDamageNumberCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLUmgFirstPerson::UpdateDamageNumbers()
+{
+    if (ActiveDamageNumberCount <= 0 || !QLPlayerController.IsValid())
+    {
+        return;
+    }
+
+    UWorld* World = GetWorld();
+    ULocalPlayer* LocalPlayer = QLPlayerController->GetLocalPlayer();
+    if (!World || !LocalPlayer || !LocalPlayer->ViewportClient)
+    {
+        return;
+    }
+
+    // the view is the same for every number of the frame
+    FSceneViewProjectionData ProjectionData;
+    if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, eSSP_FULL, ProjectionData))
+    {
+        return;
+    }
+
+    const FMatrix ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+    const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+
+    // the canvas is laid out in DPI scaled units
+    const float ViewportScale = FMath::Max(UWidgetLayoutLibrary::GetViewportScale(this), KINDA_SMALL_NUMBER);
+    const float CurrentTime = World->GetTimeSeconds();
+
+    for (FQLDamageNumber& DamageNumber : DamageNumberList)
+    {
+        if (!DamageNumber.bIsActive)
+        {
+            continue;
+        }
+
+        const float Age = CurrentTime - DamageNumber.LastHitTime;
+        if (Age > DamageNumberDuration)
+        {
+            DeactivateDamageNumber(DamageNumber);
+            continue;
+        }
+
+        UTextBlock* DamageText = DamageTextList[DamageNumber.TextIndex];
+        if (!DamageText)
+        {
+            continue;
+        }
+
+        FVector WorldLocation = DamageNumber.Offset;
+        if (DamageNumber.Victim.IsValid())
+        {
+            WorldLocation += DamageNumber.Victim->GetActorLocation();
+        }
+
+        // behind the camera
+        FVector2D ScreenLocation;
+        if (!FSceneView::ProjectWorldToScreen(WorldLocation, ViewRect, ViewProjectionMatrix, ScreenLocation))
+        {
+            DamageText->SetVisibility(ESlateVisibility::Hidden);
+            continue;
+        }
+
+        ScreenLocation /= ViewportScale;
+        ScreenLocation.Y -= DamageNumberRiseSpeed * Age;
+
+        UCanvasPanelSlot* CanvasSlot = Cast<UCanvasPanelSlot>(DamageText->Slot);
+        if (CanvasSlot)
+        {
+            CanvasSlot->SetPosition(ScreenLocation);
+        }
+
+        DamageText->SetRenderOpacity(1.0f - Age / DamageNumberDuration);
+        DamageText->SetVisibility(ESlateVisibility::HitTestInvisible);
     }
 }
 
@@ -180,6 +331,8 @@ AQLPlayerController* UQLUmgFirstPerson::GetQLPlayerController()
 //------------------------------------------------------------
 float UQLUmgFirstPerson::UpdateTextHealthValue_Implementation(float Health)
 {
+    SetTextValue(TextHealthValue, Health);
+
     return Health;
 }
 
@@ -187,6 +340,8 @@ float UQLUmgFirstPerson::UpdateTextHealthValue_Implementation(float Health)
 //------------------------------------------------------------
 float UQLUmgFirstPerson::UpdateTextArmorValue_Implementation(float Armor)
 {
+    SetTextValue(TextArmorValue, Armor);
+
     return Armor;
 }
 
@@ -194,28 +349,40 @@ float UQLUmgFirstPerson::UpdateTextArmorValue_Implementation(float Armor)
 //------------------------------------------------------------
 float UQLUmgFirstPerson::UpdateTextFPSValue_Implementation()
 {
-    float FPS = 0.0f;
+    return DisplayedFPS;
+}
 
-    if (QLPlayerController.IsValid())
-    {
-        FPS = QLPlayerController->GetFrameRate();
-    }
+//------------------------------------------------------------
+//------------------------------------------------------------
+float UQLUmgFirstPerson::UpdateTextSpeedValue_Implementation()
+{
+    return DisplayedSpeed;
+}
 
-    return FPS;
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLUmgFirstPerson::SetTextFPSValue(float FPS)
+{
+    DisplayedFPS = FPS;
+    SetTextValue(TextFPSValue, FPS);
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-float UQLUmgFirstPerson::UpdateTextSpeedValue_Implementation()
+void UQLUmgFirstPerson::SetTextSpeedValue(float Speed)
 {
-    float Speed = 0.0f;
+    DisplayedSpeed = Speed;
+    SetTextValue(TextSpeedValue, Speed);
+}
 
-    if (QLPlayerController.IsValid())
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLUmgFirstPerson::SetTextValue(UTextBlock* TextBlock, float Value)
+{
+    if (TextBlock)
     {
-        Speed = QLPlayerController->GetControlledPawnSpeed();
+        TextBlock->SetText(FText::AsNumber(FMath::RoundToInt(Value)));
     }
-
-    return Speed;
 }
 
 //------------------------------------------------------------
@@ -306,4 +473,14 @@ void UQLUmgFirstPerson::SetProtectionProgressVisibility_Implementation(const boo
 
         ProtectionProgress->SetVisibility(Temp);
     }
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLUmgFirstPerson::InvalidateHUD()
+{
+    if (HUDInvalidationBox)
+    {
+        HUDInvalidationBox->InvalidateCache();
+    }
+}
@@ -14,15 +14,51 @@
 #include "Blueprint/UserWidget.h"
 #include "Components/TextBlock.h"
 #include "Components/Image.h"
+#include "Components/InvalidationBox.h"
+#include "Components/CanvasPanel.h"
 #include "QLUmgFirstPerson.generated.h"
 
 class AQLPlayerController;
 
+//------------------------------------------------------------
+// A floating damage number. The hits on the same victim within
+// DamageNumberAggregationTime add up to a running total.
+//------------------------------------------------------------
+struct FQLDamageNumber
+{
+    TWeakObjectPtr<AActor> Victim;
+
+    // relative to the victim, or in the world if there is no victim
+    FVector Offset;
+
+    float Total;
+
+    int32 DisplayedTotal;
+
+    float LastHitTime;
+
+    // index into DamageTextList
+    int32 TextIndex;
+
+    bool bIsActive;
+};
+
 //------------------------------------------------------------
 // In Blueprint
-// - Add the identically named text blocks DamageText0 ...
-// - Add animation FadeAnimationBP0 ...
-// - Set FadeAnimationCPPP0 = FadeAnimationBP0 ...
+// - Optionally add a canvas panel named DamageNumberCanvas to hold
+//   the damage numbers, otherwise the root canvas panel is used.
+//   The pool of DamageNumberPoolSize text blocks is created at
+//   construction.
+// - Optionally add a text block named DamageNumberTemplate, whose
+//   font and color are copied to the damage numbers.
+// - Optionally add the text blocks TextHealthValue, TextArmorValue,
+//   TextSpeedValue and TextFPSValue, or override the UpdateText*
+//   events. The values are pushed by UQLHUDViewModel. Texts bound
+//   to UpdateTextFPSValue and UpdateTextSpeedValue still work, the
+//   functions return the last pushed value.
+// - Optionally wrap the HUD, except the damage texts, in an
+//   invalidation box named HUDInvalidationBox. It is only redrawn
+//   when a pushed value changes.
 //------------------------------------------------------------
 UCLASS(Abstract)
 class QL_API UQLUmgFirstPerson : public UUserWidget
@@ -41,7 +77,7 @@ public:
     //------------------------------------------------------------
     //------------------------------------------------------------
     UFUNCTION(BlueprintCallable, Category = "C++Function")
-    void ShowDamageOnScreen(const FString& msg, const FVector& Location);
+    void ShowDamageOnScreen(float DamageAmount, const FVector& Location, AActor* Victim);
 
     //------------------------------------------------------------
     //------------------------------------------------------------
@@ -59,12 +95,23 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "C++Function")
     float UpdateTextArmorValue(float Armor);
 
+    //------------------------------------------------------------
+    // Return the last FPS and speed pushed by UQLHUDViewModel, so
+    // that the existing property bindings keep working
+    //------------------------------------------------------------
     UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "C++Function")
     float UpdateTextFPSValue();
 
     UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "C++Function")
     float UpdateTextSpeedValue();
 
+    //------------------------------------------------------------
+    // Called by UQLHUDViewModel when the displayed value changes
+    //------------------------------------------------------------
+    void SetTextFPSValue(float FPS);
+
+    void SetTextSpeedValue(float Speed);
+
     UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "C++Function")
     float UpdateQuadDamageProgress(float ProgressPercent);
 
@@ -79,66 +126,87 @@ public:
 
     UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "C++Function")
     void SetProtectionProgressVisibility(const bool bFlag);
+
+    //------------------------------------------------------------
+    // Redraw the cached HUD after the values have changed
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    void InvalidateHUD();
 protected:
-    UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UImage* QuadDamageProgress;
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    static void SetTextValue(UTextBlock* TextBlock, float Value);
 
-    UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UImage* ProtectionProgress;
+    void CreateDamageNumberPool();
 
-    UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UImage* AbilityCooldownProgress;
+    //------------------------------------------------------------
+    // Project every active damage number with the view of this frame
+    //------------------------------------------------------------
+    void UpdateDamageNumbers();
 
-    UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UTextBlock* DamageText0;
+    void DeactivateDamageNumber(FQLDamageNumber& DamageNumber);
 
-    UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UTextBlock* DamageText1;
+    UPROPERTY(BlueprintReadWrite, meta = (BindWidgetOptional))
+    UInvalidationBox* HUDInvalidationBox;
 
-    UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UTextBlock* DamageText2;
+    UPROPERTY(BlueprintReadWrite, meta = (BindWidgetOptional))
+    UTextBlock* TextHealthValue;
+
+    UPROPERTY(BlueprintReadWrite, meta = (BindWidgetOptional))
+    UTextBlock* TextArmorValue;
+
+    UPROPERTY(BlueprintReadWrite, meta = (BindWidgetOptional))
+    UTextBlock* TextSpeedValue;
+
+    UPROPERTY(BlueprintReadWrite, meta = (BindWidgetOptional))
+    UTextBlock* TextFPSValue;
 
     UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UTextBlock* DamageText3;
+    UImage* QuadDamageProgress;
 
     UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UTextBlock* DamageText4;
+    UImage* ProtectionProgress;
 
     UPROPERTY(BlueprintReadWrite, meta = (BindWidget))
-    UTextBlock* DamageText5;
+    UImage* AbilityCooldownProgress;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animations)
-    UWidgetAnimation* FadeAnimationCPP0;
+    UPROPERTY(BlueprintReadWrite, meta = (BindWidgetOptional))
+    UCanvasPanel* DamageNumberCanvas;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animations)
-    UWidgetAnimation* FadeAnimationCPP1;
+    UPROPERTY(BlueprintReadWrite, meta = (BindWidgetOptional))
+    UTextBlock* DamageNumberTemplate;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animations)
-    UWidgetAnimation* FadeAnimationCPP2;
+    //------------------------------------------------------------
+    // Maximum number of damage numbers on screen, the oldest one is
+    // reused when the pool is exhausted
+    //------------------------------------------------------------
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    int32 DamageNumberPoolSize;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animations)
-    UWidgetAnimation* FadeAnimationCPP3;
+    // second
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    float DamageNumberAggregationTime;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animations)
-    UWidgetAnimation* FadeAnimationCPP4;
+    // second, after the last hit
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    float DamageNumberDuration;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animations)
-    UWidgetAnimation* FadeAnimationCPP5;
+    // pixel per second
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    float DamageNumberRiseSpeed;
 
     UPROPERTY()
     TArray<UTextBlock*> DamageTextList;
 
-    UPROPERTY()
-    TArray<UWidgetAnimation*> FadeAnimationCPPList;
+    TArray<FQLDamageNumber> DamageNumberList;
 
-    UPROPERTY()
-    TWeakObjectPtr<UTextBlock> CurrentDamageText;
+    int32 ActiveDamageNumberCount;
 
-    UPROPERTY()
-    TWeakObjectPtr<UWidgetAnimation> CurrentFadeAnimationCPP;
+    // last values pushed by UQLHUDViewModel
+    float DisplayedFPS;
+
+    float DisplayedSpeed;
 
     UPROPERTY()
     TWeakObjectPtr<AQLPlayerController> QLPlayerController;
-
-    int32 Counter;
 };
@@ -111,8 +111,8 @@ namespace QLUtility
         // reference:
         // - http://mathworld.wolfram.com/DiskPointPicking.html
         // - https://www.arl.army.mil/arlreports/2015/ARL-TR-7333.pdf
-        float RandomTheta = FMath::RandRange(0.0f, QLTwoPi);
-        float RandomU = FMath::RandRange(0.0f, Radius * Radius);
+        float RandomTheta = RandRange(0.0f, QLTwoPi);
+        float RandomU = RandRange(0.0f, Radius * Radius);
 
         float RandomRadius = FMath::Sqrt(RandomU);
         float x = Center.X + RandomRadius * FMath::Cos(RandomTheta);
@@ -125,9 +125,41 @@ namespace QLUtility
     //------------------------------------------------------------
     FVector SamplePointFromSquareOnXYPlane(const float XHalfSide, const float YHalfSide, const FVector& Center)
     {
-        float x = Center.X + FMath::RandRange(-XHalfSide, XHalfSide);
-        float y = Center.Y + FMath::RandRange(-YHalfSide, YHalfSide);
+        float x = Center.X + RandRange(-XHalfSide, XHalfSide);
+        float y = Center.Y + RandRange(-YHalfSide, YHalfSide);
         return FVector(x, y, Center.Z);
     }
+
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    void SetRandomSeed(int32 Seed)
+    {
+        GetRandomStream().Initialize(Seed);
+        FMath::RandInit(Seed);
+        FMath::SRandInit(Seed);
+    }
+
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    FRandomStream& GetRandomStream()
+    {
+        // unseeded games get a different stream every run
+        static FRandomStream RandomStream(static_cast<int32>(FPlatformTime::Cycles()));
+        return RandomStream;
+    }
+
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    int32 RandRange(int32 Min, int32 Max)
+    {
+        return GetRandomStream().RandRange(Min, Max);
+    }
+
+    //------------------------------------------------------------
+    //------------------------------------------------------------
+    float RandRange(float Min, float Max)
+    {
+        return GetRandomStream().FRandRange(Min, Max);
+    }
 }
 
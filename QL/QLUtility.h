@@ -54,4 +54,23 @@ namespace QLUtility
     //------------------------------------------------------------
     //------------------------------------------------------------
     FVector SamplePointFromSquareOnXYPlane(const float XHalfSide, const float YHalfSide, const FVector& Center);
+
+    //------------------------------------------------------------
+    // Seed the gameplay random stream below, as well as FMath::Rand()
+    // and FMath::FRand() used by the engine (e.g. random navmesh points),
+    // so that a match can be replayed identically
+    //------------------------------------------------------------
+    void SetRandomSeed(int32 Seed);
+
+    //------------------------------------------------------------
+    // Random stream of the gameplay code (spawn, sampling, etc.)
+    //------------------------------------------------------------
+    FRandomStream& GetRandomStream();
+
+    //------------------------------------------------------------
+    // Seeded counterparts of FMath::RandRange(), inclusive
+    //------------------------------------------------------------
+    int32 RandRange(int32 Min, int32 Max);
+
+    float RandRange(float Min, float Max);
 }
@@ -0,0 +1,343 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLVisibilityManager.h"
+#include "QLCharacter.h"
+#include "QLAIController.h"
+#include "QLAIPerceptionComponent.h"
+#include "QLGameModeBase.h"
+#include "QLUtility.h"
+#include "Engine/World.h"
+#include "CollisionQueryParams.h"
+#include "Classes/Perception/AISenseConfig_Sight.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarQLVisibilityTraceBudget(
+    TEXT("ql.VisibilityTraceBudget"),
+    8,
+    TEXT("Maximum number of line of sight traces spent on the visibility matrix per frame."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarQLVisibilityCellBudget(
+    TEXT("ql.VisibilityCellBudget"),
+    512,
+    TEXT("Maximum number of cells of the visibility matrix visited per frame, traced or not."),
+    ECVF_Default);
+
+//------------------------------------------------------------
+// Print the counters of the visibility manager of the world
+//------------------------------------------------------------
+static void LogVisibilityStats(UWorld* World)
+{
+    UQLVisibilityManager* VisibilityManager = AQLGameModeBase::GetWorldService<UQLVisibilityManager>(World);
+    if (VisibilityManager)
+    {
+        VisibilityManager->LogStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorld QLVisibilityStatsCommand(
+    TEXT("ql.VisibilityStats"),
+    TEXT("Print the traces per frame and the staleness of the visibility matrix."),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&LogVisibilityStats));
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLVisibilityManager::UQLVisibilityManager() :
+Cursor(0),
+LastFrameTraceCount(0),
+TotalTraceCount(0),
+FrameCount(0),
+TotalStaleness(0.0),
+MaxStaleness(0.0f),
+StalenessSampleCount(0),
+SweepStartTime(0.0f),
+LastSweepDuration(0.0f)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLVisibilityManager::Deinitialize()
+{
+    CharacterList.Empty();
+    CellList.Empty();
+
+    Super::Deinitialize();
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLVisibilityManager::RegisterCharacter(AQLCharacter* Character)
+{
+    if (!Character)
+    {
+        return;
+    }
+
+    int32 FreeSlotIndex = INDEX_NONE;
+    for (int32 Index = 0; Index < CharacterList.Num(); ++Index)
+    {
+        AQLCharacter* Item = CharacterList[Index].Get();
+        if (Item == Character)
+        {
+            return;
+        }
+
+        if (!Item && FreeSlotIndex == INDEX_NONE)
+        {
+            FreeSlotIndex = Index;
+        }
+    }
+
+    if (FreeSlotIndex == INDEX_NONE)
+    {
+        FreeSlotIndex = CharacterList.Num();
+        CharacterList.AddDefaulted();
+        ResizeMatrix(CharacterList.Num());
+    }
+
+    CharacterList[FreeSlotIndex] = Character;
+    ResetSlot(FreeSlotIndex);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLVisibilityManager::UnregisterCharacter(AQLCharacter* Character)
+{
+    const int32 SlotIndex = CharacterList.IndexOfByKey(Character);
+    if (SlotIndex != INDEX_NONE)
+    {
+        CharacterList[SlotIndex].Reset();
+        ResetSlot(SlotIndex);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLVisibilityManager::ResizeMatrix(int32 SlotCount)
+{
+    const int32 OldSlotCount = FMath::RoundToInt(FMath::Sqrt(static_cast<float>(CellList.Num())));
+
+    TArray<FQLVisibilityCell> NewCellList;
+    NewCellList.Init({ false, -1.0f }, SlotCount * SlotCount);
+
+    for (int32 Row = 0; Row < OldSlotCount; ++Row)
+    {
+        for (int32 Column = 0; Column < OldSlotCount; ++Column)
+        {
+            NewCellList[Row * SlotCount + Column] = CellList[Row * OldSlotCount + Column];
+        }
+    }
+
+    CellList = MoveTemp(NewCellList);
+    Cursor = 0;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLVisibilityManager::ResetSlot(int32 SlotIndex)
+{
+    const int32 SlotCount = CharacterList.Num();
+
+    for (int32 Index = 0; Index < SlotCount; ++Index)
+    {
+        CellList[SlotIndex * SlotCount + Index] = { false, -1.0f };
+        CellList[Index * SlotCount + SlotIndex] = { false, -1.0f };
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLVisibilityManager::IsVisible(const AQLCharacter* Observer, const AQLCharacter* Target) const
+{
+    const int32 ObserverIndex = CharacterList.IndexOfByKey(Observer);
+    const int32 TargetIndex = CharacterList.IndexOfByKey(Target);
+    if (ObserverIndex == INDEX_NONE || TargetIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    return CellList[ObserverIndex * CharacterList.Num() + TargetIndex].bIsVisible;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLVisibilityManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UWorld* World = GetWorld();
+    const int32 SlotCount = CharacterList.Num();
+    const int32 CellCount = SlotCount * SlotCount;
+    if (!World || CellCount == 0)
+    {
+        return;
+    }
+
+    const int32 TraceBudget = FMath::Max(CVarQLVisibilityTraceBudget.GetValueOnGameThread(), 1);
+    const int32 CellBudget = FMath::Clamp(CVarQLVisibilityCellBudget.GetValueOnGameThread(), 1, CellCount);
+    const float CurrentTime = World->GetTimeSeconds();
+    int32 TraceCount = 0;
+
+    // visit each cell at most once per frame, and bound the cheap checks as well as the traces
+    for (int32 Step = 0; Step < CellBudget && TraceCount < TraceBudget; ++Step)
+    {
+        const int32 CellIndex = Cursor;
+
+        Cursor = (Cursor + 1) % CellCount;
+        if (Cursor == 0)
+        {
+            LastSweepDuration = CurrentTime - SweepStartTime;
+            SweepStartTime = CurrentTime;
+        }
+
+        const int32 ObserverIndex = CellIndex / SlotCount;
+        const int32 TargetIndex = CellIndex % SlotCount;
+        if (ObserverIndex == TargetIndex)
+        {
+            continue;
+        }
+
+        AQLCharacter* Observer = CharacterList[ObserverIndex].Get();
+        AQLCharacter* Target = CharacterList[TargetIndex].Get();
+        if (!Observer || !Target)
+        {
+            continue;
+        }
+
+        // only the bots look, and only for their enemies
+        AQLAIController* Controller = Cast<AQLAIController>(Observer->GetController());
+        if (!Controller || Controller->GetTeamAttitudeTowards(*Target) != ETeamAttitude::Hostile)
+        {
+            continue;
+        }
+
+        // the bots far from any fight look less often, see UQLAILODManager
+        FQLVisibilityCell& Cell = CellList[CellIndex];
+        if (Cell.LastCheckTime >= 0.0f && CurrentTime - Cell.LastCheckTime < Controller->GetSightCheckInterval())
+        {
+            continue;
+        }
+
+        if (Cell.LastCheckTime >= 0.0f)
+        {
+            const float Staleness = CurrentTime - Cell.LastCheckTime;
+            TotalStaleness += Staleness;
+            MaxStaleness = FMath::Max(MaxStaleness, Staleness);
+            ++StalenessSampleCount;
+        }
+
+        FVector EyeLocation;
+        bool bTraced = false;
+        const bool bIsVisible = CheckVisibility(Controller, Target, Cell.bIsVisible, EyeLocation, bTraced);
+        Cell.LastCheckTime = CurrentTime;
+
+        if (bTraced)
+        {
+            ++TraceCount;
+        }
+
+        // a visible target is reported on every check, as the engine sight sense does,
+        // so that its stimulus does not expire and its location stays current
+        if (bIsVisible == Cell.bIsVisible && !bIsVisible)
+        {
+            continue;
+        }
+
+        Cell.bIsVisible = bIsVisible;
+
+        UQLAIPerceptionComponent* PerceptionComponent = Cast<UQLAIPerceptionComponent>(Controller->GetPerceptionComponent());
+        if (PerceptionComponent)
+        {
+            PerceptionComponent->ReportSight(Target, bIsVisible, Target->GetActorLocation(), EyeLocation);
+        }
+    }
+
+    LastFrameTraceCount = TraceCount;
+    TotalTraceCount += TraceCount;
+    ++FrameCount;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool UQLVisibilityManager::CheckVisibility(AQLAIController* Controller, AQLCharacter* Target, bool bWasVisible, FVector& OutEyeLocation, bool& bOutTraced) const
+{
+    bOutTraced = false;
+
+    FRotator EyeRotation;
+    Controller->GetActorEyesViewPoint(OutEyeLocation, EyeRotation);
+
+    const UAISenseConfig_Sight* SightConfig = Controller->GetSightConfig();
+    if (!SightConfig)
+    {
+        return false;
+    }
+
+    const float Radius = Controller->GetSightRadius(bWasVisible);
+    const FVector TargetLocation = Target->GetActorLocation();
+    const FVector Delta = TargetLocation - OutEyeLocation;
+    if (Delta.SizeSquared() > FMath::Square(Radius))
+    {
+        return false;
+    }
+
+    const float PeripheralVisionCos = FMath::Cos(FMath::DegreesToRadians(SightConfig->PeripheralVisionAngleDegrees));
+    if ((Delta.GetSafeNormal() | EyeRotation.Vector()) < PeripheralVisionCos)
+    {
+        return false;
+    }
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return false;
+    }
+
+    bOutTraced = true;
+
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(QLVisibilityTrace), true, Controller->GetPawn());
+    FHitResult HitResult;
+    const bool bHit = World->LineTraceSingleByChannel(HitResult, OutEyeLocation, TargetLocation, ECollisionChannel::ECC_Visibility, Params);
+
+    return !bHit || HitResult.GetActor() == Target;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLVisibilityManager::LogStats()
+{
+    int32 CharacterCount = 0;
+    for (const auto& Item : CharacterList)
+    {
+        if (Item.IsValid())
+        {
+            ++CharacterCount;
+        }
+    }
+
+    QLUtility::Log(FString::Printf(TEXT("visibility: %d characters, %d cells, %d traces last frame, %.2f traces per frame on average, budget %d traces %d cells"),
+        CharacterCount,
+        CellList.Num(),
+        LastFrameTraceCount,
+        FrameCount > 0 ? static_cast<double>(TotalTraceCount) / FrameCount : 0.0,
+        CVarQLVisibilityTraceBudget.GetValueOnGameThread(),
+        CVarQLVisibilityCellBudget.GetValueOnGameThread()));
+
+    QLUtility::Log(FString::Printf(TEXT("    staleness: average %.3f s, max %.3f s, last sweep %.3f s"),
+        StalenessSampleCount > 0 ? TotalStaleness / StalenessSampleCount : 0.0,
+        MaxStaleness,
+        LastSweepDuration));
+
+    TotalStaleness = 0.0;
+    MaxStaleness = 0.0f;
+    StalenessSampleCount = 0;
+}
@@ -0,0 +1,112 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QLWorldService.h"
+#include "QLVisibilityManager.generated.h"
+
+class AQLCharacter;
+class AQLAIController;
+
+//------------------------------------------------------------
+// What an observer knows about a target
+//------------------------------------------------------------
+struct FQLVisibilityCell
+{
+    // in range, in the field of view and in line of sight
+    bool bIsVisible;
+
+    // game time of the last check, negative if never checked
+    float LastCheckTime;
+};
+
+//------------------------------------------------------------
+// Line of sight of the bots to their enemies, kept in a matrix
+// shared by every bot instead of one sight query per bot per target.
+// Each frame the cells are visited round-robin: the range and the
+// field of view are checked for free, and a line trace is only
+// spent on the cells passing both, up to ql.VisibilityTraceBudget
+// traces and ql.VisibilityCellBudget cells per frame. The sight radius and how often a bot looks
+// follow its AI level of detail. When a cell changes, and on every
+// check that finds the target visible, the sight stimulus is
+// reported to the bot's perception component, which then runs
+// AQLAIController::OnPerceptionUpdatedImpl() as the engine sight
+// sense would.
+//
+// AQLCharacter registers itself in BeginPlay() and unregisters in
+// EndPlay(). AQLAIController turns its own sight sense off when this
+// service is available. ql.VisibilityStats prints the traces per
+// frame and how stale the matrix is.
+//------------------------------------------------------------
+UCLASS()
+class QL_API UQLVisibilityManager : public UQLWorldService
+{
+    GENERATED_BODY()
+
+public:
+    UQLVisibilityManager();
+
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+
+    void RegisterCharacter(AQLCharacter* Character);
+
+    void UnregisterCharacter(AQLCharacter* Character);
+
+    //------------------------------------------------------------
+    // Result of the last check, false if never checked
+    //------------------------------------------------------------
+    bool IsVisible(const AQLCharacter* Observer, const AQLCharacter* Target) const;
+
+    void LogStats();
+
+protected:
+    //------------------------------------------------------------
+    // Grow the matrix to SlotCount x SlotCount, keeping the cells
+    //------------------------------------------------------------
+    void ResizeMatrix(int32 SlotCount);
+
+    void ResetSlot(int32 SlotIndex);
+
+    //------------------------------------------------------------
+    // bOutTraced is set if a line trace has been spent on the check
+    //------------------------------------------------------------
+    bool CheckVisibility(AQLAIController* Controller, AQLCharacter* Target, bool bWasVisible, FVector& OutEyeLocation, bool& bOutTraced) const;
+
+    // a slot is reused after its character unregisters
+    TArray<TWeakObjectPtr<AQLCharacter>> CharacterList;
+
+    // row: observer slot, column: target slot
+    TArray<FQLVisibilityCell> CellList;
+
+    // next cell to visit
+    int32 Cursor;
+
+    int32 LastFrameTraceCount;
+
+    int64 TotalTraceCount;
+
+    int32 FrameCount;
+
+    // age of the cells when they are checked, reset by LogStats()
+    double TotalStaleness;
+
+    float MaxStaleness;
+
+    int32 StalenessSampleCount;
+
+    // time to visit every cell once
+    float SweepStartTime;
+
+    float LastSweepDuration;
+};
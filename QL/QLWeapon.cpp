@@ -14,6 +14,7 @@
 #include "QLCharacter.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Particles/ParticleSystemComponent.h"
+#include "Particles/ParticleSystem.h"
 #include "Animation/AnimMontage.h"
 #include "Animation/AnimInstance.h"
 #include "Components/AudioComponent.h"
@@ -22,6 +23,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "QLUtility.h"
 #include "TimerManager.h"
+#include "QLGameModeBase.h"
 
 //------------------------------------------------------------
 // Sets default values
@@ -35,7 +37,8 @@ AQLWeapon::AQLWeapon()
     HitRange = 10000.0f;
     RateOfFire = 1.0f;
     bIsFireHeld = false;
-    bFireEnabled = true;
+    bIsAutomaticWeapon = false;
+    FireCooldown = 0.0f;
 
     GunSkeletalMeshComponent = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("GunSkeletalMeshComponent"));
     GunSkeletalMeshComponent->SetupAttachment(RootComponent);
@@ -224,11 +227,84 @@ void AQLWeapon::OnComponentBeginOverlapImpl(UPrimitiveComponent* OverlappedComp,
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void AQLWeapon::EnableFireCallBack()
+void AQLWeapon::RequestHitscanTrace(float TraceRange, const FQLTraceDelegate& Callback)
 {
-    bFireEnabled = true;
+    if (!WeaponManager.IsValid())
+    {
+        return;
+    }
+
+    AQLCharacter* User = WeaponManager->GetUser();
+    if (!User)
+    {
+        return;
+    }
+
+    UQLTraceManager* TraceManager = AQLGameModeBase::GetWorldService<UQLTraceManager>(this);
+    if (TraceManager)
+    {
+        TraceManager->RequestTraceFromCharacterPOV(User, TraceRange, Callback);
+    }
+    else
+    {
+        FHitResult HitResult = User->RayTraceFromCharacterPOV(TraceRange);
+        Callback.ExecuteIfBound(HitResult);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float AQLWeapon::GetRateOfFire() const
+{
+    return RateOfFire;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLWeapon::IsAutomaticWeapon() const
+{
+    return bIsAutomaticWeapon;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLWeapon::IsFireHeld() const
+{
+    return bIsFireHeld;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float AQLWeapon::GetFireCooldown() const
+{
+    return FireCooldown;
+}
 
-    GetWorldTimerManager().ClearTimer(DisableFireTimerHandle);
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeapon::SetFireCooldown(float Value)
+{
+    FireCooldown = Value;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+bool AQLWeapon::IsFireReady() const
+{
+    return FireCooldown <= 0.0f;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeapon::StartFireCooldown()
+{
+    FireCooldown = RateOfFire;
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeapon::OnScheduledShot(const FQLScheduledShot& Shot)
+{
 }
 
 //------------------------------------------------------------
@@ -306,3 +382,15 @@ float AQLWeapon::GetProjectileSpeed()
 {
     return ProjectileSpeed;
 }
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeapon::GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const
+{
+    Super::GetWarmUpAssetList(OutAssetList);
+
+    if (BeamComponent && BeamComponent->Template)
+    {
+        OutAssetList.AddUnique(BeamComponent->Template);
+    }
+}
@@ -12,12 +12,25 @@
 
 #include "CoreMinimal.h"
 #include "QLPickup.h"
+#include "QLTraceManager.h"
 #include "QLWeapon.generated.h"
 
 class AQLCharacter;
 class UAudioComponent;
 class USphereComponent;
 
+//------------------------------------------------------------
+// A shot of an automatic weapon scheduled by UQLWeaponManager
+//------------------------------------------------------------
+struct FQLScheduledShot
+{
+    // muzzle location interpolated to the time of the shot
+    FVector MuzzleLocation;
+
+    // time elapsed between the shot and the end of the current frame
+    float TimeSinceShot;
+};
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 UCLASS()
@@ -90,16 +103,58 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "C++Function")
     float GetProjectileSpeed();
+
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    float GetRateOfFire() const;
+
+    //------------------------------------------------------------
+    // Automatic weapons keep firing while the fire button is held.
+    // Their shots are scheduled by UQLWeaponManager::Tick()
+    //------------------------------------------------------------
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    bool IsAutomaticWeapon() const;
+
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    bool IsFireHeld() const;
+
+    //------------------------------------------------------------
+    // Time left before the weapon can fire again.
+    // It is counted down by UQLWeaponManager::Tick()
+    //------------------------------------------------------------
+    float GetFireCooldown() const;
+
+    void SetFireCooldown(float Value);
+
+    UFUNCTION(BlueprintCallable, Category = "C++Function")
+    bool IsFireReady() const;
+
+    //------------------------------------------------------------
+    // Called by UQLWeaponManager for each shot of an automatic weapon
+    // that is due within the current frame
+    //------------------------------------------------------------
+    virtual void OnScheduledShot(const FQLScheduledShot& Shot);
+
+    virtual void GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const override;
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
     virtual void PostInitializeComponents() override;
 
-    virtual void EnableFireCallBack();
+    //------------------------------------------------------------
+    // Prevent the weapon from firing again during RateOfFire
+    //------------------------------------------------------------
+    void StartFireCooldown();
 
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+    //------------------------------------------------------------
+    // Ray trace from the user's point of view within TraceRange.
+    // The hit result is passed to Callback, either immediately or at the
+    // beginning of the next frame if the traces are batched by UQLTraceManager
+    //------------------------------------------------------------
+    void RequestHitscanTrace(float TraceRange, const FQLTraceDelegate& Callback);
+
     void OnComponentBeginOverlapImpl(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult) override;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
@@ -118,8 +173,6 @@ protected:
     UPROPERTY()
     TWeakObjectPtr<UMaterialInstanceDynamic> DynamicMaterialGun;
 
-    FTimerHandle HoldFireTimerHandle;
-
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     float HitRange;
 
@@ -127,16 +180,16 @@ protected:
     float RateOfFire;
 
     UPROPERTY()
-    bool bFireEnabled;
+    float FireCooldown;
 
     UPROPERTY()
     bool bIsFireHeld;
 
+    bool bIsAutomaticWeapon;
+
     UPROPERTY()
     TWeakObjectPtr<UQLWeaponManager> WeaponManager;
 
-    FTimerHandle DisableFireTimerHandle;
-
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
     float BasicDamage;
 
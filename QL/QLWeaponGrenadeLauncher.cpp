@@ -18,6 +18,7 @@
 #include "Camera/CameraComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "QLPlayerController.h"
+#include "QLActorPoolManager.h"
 #include "Kismet/GameplayStatics.h"
 
 //------------------------------------------------------------
@@ -52,26 +53,32 @@ void AQLWeaponGrenadeLauncher::Tick(float DeltaTime)
 void AQLWeaponGrenadeLauncher::OnFire()
 {
     // if we are still in the fire disabled window, the weapon cannot be used
-    if (!bFireEnabled)
+    if (!IsFireReady())
     {
         return;
     }
 
     // enforce rate of fire
-    bFireEnabled = false;
-    GetWorldTimerManager().SetTimer(DisableFireTimerHandle,
-        this,
-        &AQLWeaponGrenadeLauncher::EnableFireCallBack,
-        1.0f, // time interval in second. since loop is not used,
-              // this parameter can be an arbitrary value except 0.0f.
-        false, // loop
-        RateOfFire); // delay in second
+    // the cooldown is counted down by the weapon manager
+    StartFireCooldown();
 
     PlayAnimationMontage(FName(TEXT("Fire")));
 
-    PlaySoundFireAndForget(FName(TEXT("Fire")));
+    PlaySoundFireAndForget(FName(TEXT("Fire")), EQLSoundCategory::WeaponFire);
 
     // ray tracing
+    RequestHitscanTrace(HitRange, FQLTraceDelegate::CreateUObject(this, &AQLWeaponGrenadeLauncher::LaunchRecyclerGrenade));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponGrenadeLauncher::LaunchRecyclerGrenade(const FHitResult& HitResult)
+{
+    if (!WeaponManager.IsValid())
+    {
+        return;
+    }
+
     AQLCharacter* User = GetWeaponManager()->GetUser();
 
     if (User == nullptr)
@@ -79,8 +86,6 @@ void AQLWeaponGrenadeLauncher::OnFire()
         return;
     }
 
-    FHitResult HitResult = User->RayTraceFromCharacterPOV(HitRange);
-
     // determine source and target
     UCameraComponent* CameraComponent = User->GetFirstPersonCameraComponent();
     if (CameraComponent == nullptr)
@@ -118,14 +123,18 @@ void AQLWeaponGrenadeLauncher::OnFire()
         }
 
         FTransform MyTransform(SourceRotation, SourceLocation, FVector(1.0f));
-        AQLRecyclerGrenadeProjectile* RecyclerGrenade = World->SpawnActorDeferred<AQLRecyclerGrenadeProjectile>(RecyclerGrenadeProjectileClass, MyTransform);
+        AQLRecyclerGrenadeProjectile* RecyclerGrenade = UQLActorPoolManager::AcquireActorDeferred<AQLRecyclerGrenadeProjectile>(this, RecyclerGrenadeProjectileClass, MyTransform);
+        if (!RecyclerGrenade)
+        {
+            return;
+        }
 
         // pass controller to RecyclerGrenade as damage instigator
         AController* Controller = User->GetController();
         AQLPlayerController* QLPlayerController = Cast<AQLPlayerController>(Controller);
         RecyclerGrenade->QLSetPlayerController(QLPlayerController);
         RecyclerGrenade->SetDamageMultiplier(DamageMultiplier);
-        UGameplayStatics::FinishSpawningActor(RecyclerGrenade, MyTransform);
+        UQLActorPoolManager::FinishAcquiringActor(RecyclerGrenade, MyTransform);
 
         // change velocity
         RecyclerGrenade->GetProjectileMovementComponent()->MaxSpeed = ProjectileSpeed;
@@ -134,3 +143,15 @@ void AQLWeaponGrenadeLauncher::OnFire()
         RecyclerGrenade->GetProjectileMovementComponent()->Velocity = FinalVelocity;
     }
 }
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponGrenadeLauncher::GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const
+{
+    Super::GetWarmUpAssetList(OutAssetList);
+
+    if (RecyclerGrenadeProjectileClass)
+    {
+        GetDefault<AQLProjectile>(RecyclerGrenadeProjectileClass)->GetWarmUpAssetList(OutAssetList);
+    }
+}
@@ -28,6 +28,8 @@ public:
 
     virtual void OnFire() override;
 
+    virtual void GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const override;
+
 protected:
     virtual void Tick(float DeltaTime) override;
 
@@ -35,4 +37,9 @@ protected:
 
     UPROPERTY(EditDefaultsOnly, Category = "C++Property")
     TSubclassOf<AQLRecyclerGrenadeProjectile> RecyclerGrenadeProjectileClass;
+
+    //------------------------------------------------------------
+    // Trace callback of OnFire(): spawn the grenade towards the hit point
+    //------------------------------------------------------------
+    void LaunchRecyclerGrenade(const FHitResult& HitResult);
 };
@@ -30,6 +30,7 @@ AQLWeaponLightningGun::AQLWeaponLightningGun()
     HitRange = 1200.0f;
     RateOfFire = 0.05f;
     bIsFireHeld = false;
+    bIsAutomaticWeapon = true;
 
     BasicDamage = 6.0f;
     KnockbackSpeedChange = 50.0f;
@@ -75,18 +76,16 @@ void AQLWeaponLightningGun::OnFire()
 
     bIsFireHeld = true;
 
+    // the beam follows the aim every frame while the fire is held
+    SetActorTickEnabled(true);
+
     // handle beam
     if (BeamComponent)
     {
         BeamComponent->Activate();
     }
 
-    GetWorldTimerManager().SetTimer(HoldFireTimerHandle,
-                                    this,
-                                    &AQLWeaponLightningGun::SpawnLightning,
-                                    RateOfFire, // time interval in second
-                                    true, // loop
-                                    0.0f); // delay in second
+    // from now on, the weapon manager calls OnScheduledShot() every RateOfFire
 }
 
 //------------------------------------------------------------
@@ -102,23 +101,36 @@ void AQLWeaponLightningGun::OnFireRelease()
 
     bIsFireHeld = false;
 
+    SetActorTickEnabled(false);
+
     if (BeamComponent)
     {
         BeamComponent->Deactivate();
     }
-
-    GetWorldTimerManager().ClearTimer(HoldFireTimerHandle);
 }
 
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLWeaponLightningGun::OnFireHold()
 {
-    AQLCharacter* User = GetWeaponManager()->GetUser();
+    RequestHitscanTrace(HitRange, FQLTraceDelegate::CreateUObject(this, &AQLWeaponLightningGun::UpdateBeam));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponLightningGun::UpdateBeam(const FHitResult& HitResult)
+{
+    // the fire may have been released before the batched trace returns
+    if (!bIsFireHeld || !WeaponManager.IsValid())
+    {
+        return;
+    }
 
-    // to do: in order to ensure correctness, for each tick, ray trace is performed twice, one in Tick(), the other in HasHitEnemy()
-    // need to understand the tick order and simplify the calculation
-    FHitResult HitResult = User->RayTraceFromCharacterPOV(HitRange);
+    AQLCharacter* User = GetWeaponManager()->GetUser();
+    if (User == nullptr)
+    {
+        return;
+    }
 
     if (BeamComponent)
     {
@@ -144,10 +156,31 @@ void AQLWeaponLightningGun::OnFireHold()
     }
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponLightningGun::OnScheduledShot(const FQLScheduledShot& Shot)
+{
+    // the beam is traced from the current view, so all shots due in a frame share
+    // the same trace thanks to the view trace cache of the character
+    SpawnLightning();
+}
+
 //------------------------------------------------------------
 //------------------------------------------------------------
 void AQLWeaponLightningGun::SpawnLightning()
 {
+    RequestHitscanTrace(HitRange, FQLTraceDelegate::CreateUObject(this, &AQLWeaponLightningGun::OnLightningHit));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponLightningGun::OnLightningHit(const FHitResult& HitResult)
+{
+    if (!WeaponManager.IsValid())
+    {
+        return;
+    }
+
     AQLCharacter* User = GetWeaponManager()->GetUser();
 
     if (User == nullptr)
@@ -155,8 +188,6 @@ void AQLWeaponLightningGun::SpawnLightning()
         return;
     }
 
-    FHitResult HitResult = User->RayTraceFromCharacterPOV(HitRange);
-
     // if hit does not occur
     if (!HitResult.bBlockingHit)
     {
@@ -201,8 +232,8 @@ void AQLWeaponLightningGun::SpawnLightning()
     AQLPlayerController* QLPlayerController = User->GetQLPlayerController();
     if (DamageAmount > 0.0f && QLPlayerController)
     {
-        PlaySoundFireAndForget("Hit");
-        QLPlayerController->ShowDamageOnScreen(DamageAmount, HitResult.ImpactPoint);
+        PlaySoundFireAndForget("Hit", EQLSoundCategory::HitConfirm);
+        QLPlayerController->ShowDamageOnScreen(DamageAmount, HitResult.ImpactPoint, HitResult.GetActor());
     }
 }
 
@@ -38,6 +38,8 @@ public:
 
     virtual void OnFireHold() override;
 
+    virtual void OnScheduledShot(const FQLScheduledShot& Shot) override;
+
     virtual void SpawnLightning();
 
     virtual void StopFire() override;
@@ -45,4 +47,14 @@ public:
     virtual void SetDamageMultiplier(const float Value) override;
 protected:
     virtual void PostInitializeComponents() override;
+
+    //------------------------------------------------------------
+    // Trace callback of OnFireHold(): move the beam end to the hit point
+    //------------------------------------------------------------
+    void UpdateBeam(const FHitResult& HitResult);
+
+    //------------------------------------------------------------
+    // Trace callback of SpawnLightning(): damage the hit character
+    //------------------------------------------------------------
+    void OnLightningHit(const FHitResult& HitResult);
 };
@@ -24,7 +24,10 @@
 UQLWeaponManager::UQLWeaponManager() :
 User(nullptr),
 DamageMultiplier(1.0f),
-bIsGlowing(false)
+bIsGlowing(false),
+PreviousMuzzleLocation(FVector::ZeroVector),
+bPreviousMuzzleLocationValid(false),
+MaxShotsPerFrame(16)
 {
 }
 
@@ -73,6 +76,7 @@ void UQLWeaponManager::SetCurrentWeapon(const FName& QLName)
 
     // change current weapon
     CurrentWeapon = WeaponWanted;
+    bPreviousMuzzleLocationValid = false;
     CurrentWeapon->GetGunSkeletalMeshComponent()->SetVisibility(true);
 
     // change cross-hair
@@ -114,6 +118,29 @@ AQLWeapon* UQLWeaponManager::GetCurrentWeapon()
     return CurrentWeapon.Get();
 }
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLWeaponManager::StowWeapon(AQLWeapon* Weapon)
+{
+    auto* RootSphereComponent = Weapon->GetRootSphereComponent();
+    if (RootSphereComponent)
+    {
+        RootSphereComponent->SetCollisionProfileName(TEXT("NoCollision"));
+    }
+
+    auto* gunMesh = Weapon->GetGunSkeletalMeshComponent();
+    if (gunMesh)
+    {
+        gunMesh->CastShadow = false;
+        gunMesh->bCastDynamicShadow = false;
+        gunMesh->SetVisibility(false);
+    }
+
+    Weapon->SetActorEnableCollision(false);
+    Weapon->DisableComponentsSimulatePhysics();
+    Weapon->SetConstantRotationEnabled(false);
+}
+
 //------------------------------------------------------------
 // todo: RemoveWeapon
 //------------------------------------------------------------
@@ -138,23 +165,7 @@ void UQLWeaponManager::AddWeapon(AQLWeapon* Weapon)
     Weapon->SetWeaponManager(this);
 
     // set up the weapon
-    auto* RootSphereComponent = Weapon->GetRootSphereComponent();
-    if (RootSphereComponent)
-    {
-        RootSphereComponent->SetCollisionProfileName(TEXT("NoCollision"));
-    }
-
-    auto* gunMesh = Weapon->GetGunSkeletalMeshComponent();
-    if (gunMesh)
-    {
-        gunMesh->CastShadow = false;
-        gunMesh->bCastDynamicShadow = false;
-    }
-
-    Weapon->GetGunSkeletalMeshComponent()->SetVisibility(false);
-    Weapon->SetActorEnableCollision(false);
-    Weapon->DisableComponentsSimulatePhysics();
-    Weapon->SetConstantRotationEnabled(false);
+    StowWeapon(Weapon);
     Weapon->SetDamageMultiplier(DamageMultiplier);
 
     if (User->GetIsBot())
@@ -182,8 +193,14 @@ void UQLWeaponManager::DestroyAllWeapon()
 {
     for (auto& Item : WeaponList)
     {
-        Item->Destroy();
+        if (Item)
+        {
+            Item->Destroy();
+        }
     }
+
+    // may be called again once the owner is destroyed
+    WeaponList.Empty();
 }
 
 //------------------------------------------------------------
@@ -226,17 +243,62 @@ void UQLWeaponManager::StopGlowWeapon()
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void UQLWeaponManager::CreateAndAddAllWeapons(const TArray<TSubclassOf<AQLWeapon>>& WeaponClassList)
+void UQLWeaponManager::CreateAndAddAllWeapons(const TArray<TSoftClassPtr<AQLWeapon>>& WeaponClassList)
 {
     if (!User.IsValid())
     {
         return;
     }
 
+    TArray<AQLWeapon*> NewWeaponList;
+    CreateAllWeapons(GetWorld(), WeaponClassList, NewWeaponList);
+    AddAllWeapons(NewWeaponList);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLWeaponManager::CreateAllWeapons(UWorld* World, const TArray<TSoftClassPtr<AQLWeapon>>& WeaponClassList, TArray<AQLWeapon*>& OutWeaponList)
+{
+    if (!World)
+    {
+        return;
+    }
+
     for (const auto& Item : WeaponClassList)
     {
-        auto* Weapon = GetWorld()->SpawnActor<AQLWeapon>(Item, FVector::ZeroVector, FRotator::ZeroRotator);
-        AddWeapon(Weapon);
+        // returns at once if the class has been preloaded, see UQLAssetPreloadManager
+        UClass* WeaponClass = Item.LoadSynchronous();
+        if (!WeaponClass)
+        {
+            continue;
+        }
+
+        // no overlap with whoever stands at the origin, even while spawning
+        auto* Weapon = World->SpawnActorDeferred<AQLWeapon>(WeaponClass, FTransform::Identity);
+        if (!Weapon)
+        {
+            continue;
+        }
+
+        Weapon->SetActorEnableCollision(false);
+        UGameplayStatics::FinishSpawningActor(Weapon, FTransform::Identity);
+
+        // the weapon may wait for its user over several frames, see AQLAIHelper
+        StowWeapon(Weapon);
+        OutWeaponList.Add(Weapon);
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLWeaponManager::AddAllWeapons(const TArray<AQLWeapon*>& NewWeaponList)
+{
+    for (AQLWeapon* Weapon : NewWeaponList)
+    {
+        if (Weapon)
+        {
+            AddWeapon(Weapon);
+        }
     }
 }
 
@@ -265,3 +327,93 @@ bool UQLWeaponManager::HasWeapon(const FName& WeaponName)
     return false;
 }
 
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLWeaponManager::Tick(float DeltaTime)
+{
+    if (!User.IsValid())
+    {
+        return;
+    }
+
+    for (auto& Item : WeaponList)
+    {
+        if (!Item)
+        {
+            continue;
+        }
+
+        if (Item == CurrentWeapon.Get() && Item->IsAutomaticWeapon() && Item->IsFireHeld())
+        {
+            RunDueShots(Item, DeltaTime);
+        }
+        else
+        {
+            // the cooldown of an idle weapon does not accumulate into extra shots
+            Item->SetFireCooldown(FMath::Max(Item->GetFireCooldown() - DeltaTime, 0.0f));
+        }
+    }
+
+    if (CurrentWeapon.IsValid())
+    {
+        PreviousMuzzleLocation = CurrentWeapon->GetMuzzleLocation();
+        bPreviousMuzzleLocationValid = true;
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLWeaponManager::RunDueShots(AQLWeapon* Weapon, float DeltaTime)
+{
+    const float RateOfFire = Weapon->GetRateOfFire();
+    if (RateOfFire <= 0.0f)
+    {
+        return;
+    }
+
+    const FVector CurrentMuzzleLocation = Weapon->GetMuzzleLocation();
+    const FVector StartMuzzleLocation = bPreviousMuzzleLocationValid ? PreviousMuzzleLocation : CurrentMuzzleLocation;
+
+    const float Cooldown = AdvanceFireCooldown(Weapon->GetFireCooldown(),
+        RateOfFire,
+        DeltaTime,
+        MaxShotsPerFrame,
+        [Weapon, DeltaTime, &StartMuzzleLocation, &CurrentMuzzleLocation](float TimeSinceShot)
+        {
+            FQLScheduledShot Shot;
+            Shot.TimeSinceShot = TimeSinceShot;
+
+            const float Alpha = DeltaTime > 0.0f ? 1.0f - Shot.TimeSinceShot / DeltaTime : 1.0f;
+            Shot.MuzzleLocation = FMath::Lerp(StartMuzzleLocation, CurrentMuzzleLocation, Alpha);
+
+            Weapon->OnScheduledShot(Shot);
+
+            // the shot may have released the trigger, e.g. out of ammo
+            return Weapon->IsFireHeld();
+        });
+
+    Weapon->SetFireCooldown(Cooldown);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+float UQLWeaponManager::AdvanceFireCooldown(float Cooldown, float RateOfFire, float DeltaTime, int32 MaxShotCount, TFunctionRef<bool(float)> OnShot)
+{
+    // a non-positive cooldown means a shot is due, and its magnitude
+    // tells how long before the end of the frame the shot is due
+    Cooldown -= DeltaTime;
+    int32 ShotCount = 0;
+    bool bIsFireHeld = true;
+
+    while (Cooldown <= 0.0f && ShotCount < MaxShotCount && bIsFireHeld)
+    {
+        bIsFireHeld = OnShot(FMath::Min(-Cooldown, DeltaTime));
+
+        Cooldown += RateOfFire;
+        ++ShotCount;
+    }
+
+    // shots dropped by MaxShotCount are not carried over
+    return FMath::Max(Cooldown, 0.0f);
+}
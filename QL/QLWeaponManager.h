@@ -48,12 +48,45 @@ public:
 
     void StopGlowWeapon();
 
-    void CreateAndAddAllWeapons(const TArray<TSubclassOf<AQLWeapon>>& WeaponClassList);
+    void CreateAndAddAllWeapons(const TArray<TSoftClassPtr<AQLWeapon>>& WeaponClassList);
+
+    //------------------------------------------------------------
+    // Spawn the weapons without a user, e.g. ahead of the bots that
+    // will hold them, see AQLAIHelper. Hand them over with AddAllWeapons().
+    //------------------------------------------------------------
+    static void CreateAllWeapons(UWorld* World, const TArray<TSoftClassPtr<AQLWeapon>>& WeaponClassList, TArray<AQLWeapon*>& OutWeaponList);
+
+    void AddAllWeapons(const TArray<AQLWeapon*>& NewWeaponList);
+
+    //------------------------------------------------------------
+    // Hide the weapon, and turn off its collision and rotation as a pickup
+    //------------------------------------------------------------
+    static void StowWeapon(AQLWeapon* Weapon);
 
     void SetCurrentWeaponVisibility(const bool bFlag);
 
     bool HasWeapon(const FName& WeaponName);
+
+    //------------------------------------------------------------
+    // Fire scheduler: count down the weapon cooldowns, and run every
+    // shot of the held automatic weapon that is due within the frame
+    // at its sub-frame time. Called by the user every frame.
+    //------------------------------------------------------------
+    void Tick(float DeltaTime);
+
+    //------------------------------------------------------------
+    // Accumulator of the fire scheduler, free of any actor. Count the
+    // cooldown down by DeltaTime and call OnShot(TimeSinceShot) for
+    // each shot due within the frame, oldest first, until OnShot()
+    // returns false. Return the cooldown left for the next frame.
+    //------------------------------------------------------------
+    static float AdvanceFireCooldown(float Cooldown, float RateOfFire, float DeltaTime, int32 MaxShotCount, TFunctionRef<bool(float)> OnShot);
 protected:
+    //------------------------------------------------------------
+    // Fire the shots of Weapon that are due within the frame
+    //------------------------------------------------------------
+    void RunDueShots(AQLWeapon* Weapon, float DeltaTime);
+
     // do not use UPROPERTY() here
     // it breaks the character weapon system
     // to do: need to understand why
@@ -73,4 +106,13 @@ protected:
 
     UPROPERTY()
     FLinearColor GlowColor;
+
+    // muzzle location of the current weapon at the end of the previous frame
+    FVector PreviousMuzzleLocation;
+
+    bool bPreviousMuzzleLocationValid;
+
+    // upper bound of the shots fired in a frame, so that a long hitch
+    // does not result in a burst
+    int32 MaxShotsPerFrame;
 };
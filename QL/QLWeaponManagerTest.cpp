@@ -0,0 +1,101 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLWeaponManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQLFireSchedulerTest, "QL.WeaponManager.FireScheduler", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+//------------------------------------------------------------
+// Hold the trigger for about two seconds at a fixed frame rate
+// and check that the shots land on the rate of fire grid,
+// whatever the frame rate
+//------------------------------------------------------------
+bool FQLFireSchedulerTest::RunTest(const FString& Parameters)
+{
+    const float FrameRateList[] = { 15.0f, 30.0f, 144.0f };
+
+    // lightning gun and nailgun
+    const float RateOfFireList[] = { 0.05f, 0.1f };
+
+    const int32 MaxShotsPerFrame = 16;
+    const double Tolerance = 1e-3;
+
+    for (const float FrameRate : FrameRateList)
+    {
+        for (const float RateOfFire : RateOfFireList)
+        {
+            const float DeltaTime = 1.0f / FrameRate;
+
+            // stop away from a shot boundary, so that the expected count
+            // does not depend on the rounding of the accumulated time
+            int32 FrameCount = FMath::RoundToInt(2.0f * FrameRate);
+            while (true)
+            {
+                const double Fraction = FMath::Frac(FrameCount * static_cast<double>(DeltaTime) / RateOfFire);
+                if (Fraction > 0.1 && Fraction < 0.9)
+                {
+                    break;
+                }
+
+                ++FrameCount;
+            }
+
+            // the trigger is pulled at time 0 with no cooldown left
+            TArray<double> ShotTimeList;
+            float Cooldown = 0.0f;
+            double FrameEndTime = 0.0;
+
+            for (int32 Frame = 0; Frame < FrameCount; ++Frame)
+            {
+                FrameEndTime += DeltaTime;
+
+                Cooldown = UQLWeaponManager::AdvanceFireCooldown(Cooldown,
+                    RateOfFire,
+                    DeltaTime,
+                    MaxShotsPerFrame,
+                    [&ShotTimeList, FrameEndTime](float TimeSinceShot)
+                    {
+                        ShotTimeList.Add(FrameEndTime - TimeSinceShot);
+                        return true;
+                    });
+            }
+
+            const FString Context = FString::Printf(TEXT("%.0f fps, rate of fire %.2f s"), FrameRate, RateOfFire);
+            const int32 ExpectedShotCount = FMath::FloorToInt(FrameEndTime / RateOfFire) + 1;
+
+            TestEqual(*FString::Printf(TEXT("%s: shot count"), *Context), ShotTimeList.Num(), ExpectedShotCount);
+
+            if (ShotTimeList.Num() == 0)
+            {
+                continue;
+            }
+
+            TestTrue(*FString::Printf(TEXT("%s: first shot at the trigger pull"), *Context), FMath::IsNearlyZero(ShotTimeList[0], Tolerance));
+
+            for (int32 Index = 1; Index < ShotTimeList.Num(); ++Index)
+            {
+                const double Spacing = ShotTimeList[Index] - ShotTimeList[Index - 1];
+                if (!FMath::IsNearlyEqual(Spacing, static_cast<double>(RateOfFire), Tolerance))
+                {
+                    AddError(FString::Printf(TEXT("%s: shot %d is %.4f s after the previous one"), *Context, Index, Spacing));
+                    break;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif
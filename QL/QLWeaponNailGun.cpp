@@ -18,6 +18,8 @@
 #include "QLNailProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "QLPlayerController.h"
+#include "QLActorPoolManager.h"
+#include "QLNailSimulationManager.h"
 #include "Kismet/GameplayStatics.h"
 
 //------------------------------------------------------------
@@ -29,8 +31,10 @@ AQLWeaponNailGun::AQLWeaponNailGun()
     NailProjectileClass = AQLNailProjectile::StaticClass();
 
     bIsFireHeld = false;
+    bIsAutomaticWeapon = true;
     bIsProjectileWeapon = true;
     ProjectileSpeed = 1500.0f;
+    bSimulateNailsWithoutActor = true;
 }
 
 //------------------------------------------------------------
@@ -60,12 +64,7 @@ void AQLWeaponNailGun::OnFire()
 
     bIsFireHeld = true;
 
-    GetWorldTimerManager().SetTimer(HoldFireTimerHandle,
-        this,
-        &AQLWeaponNailGun::SpawnNailProjectile,
-        RateOfFire, // time interval in second
-        true, // loop
-        0.0f); // delay in second
+    // from now on, the weapon manager calls OnScheduledShot() every RateOfFire
 }
 
 //------------------------------------------------------------
@@ -78,8 +77,6 @@ void AQLWeaponNailGun::OnFireRelease()
     }
 
     bIsFireHeld = false;
-
-    GetWorldTimerManager().ClearTimer(HoldFireTimerHandle);
 }
 
 //------------------------------------------------------------
@@ -102,11 +99,30 @@ void AQLWeaponNailGun::StopFire()
 
 //------------------------------------------------------------
 //------------------------------------------------------------
-void AQLWeaponNailGun::SpawnNailProjectile()
+void AQLWeaponNailGun::OnScheduledShot(const FQLScheduledShot& Shot)
+{
+    SpawnNailProjectile(Shot);
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponNailGun::SpawnNailProjectile(const FQLScheduledShot& Shot)
 {
-    PlaySoundFireAndForget(FName(TEXT("Fire")));
+    PlaySoundFireAndForget(FName(TEXT("Fire")), EQLSoundCategory::WeaponFire);
 
     // ray tracing
+    RequestHitscanTrace(HitRange, FQLTraceDelegate::CreateUObject(this, &AQLWeaponNailGun::LaunchNailProjectile, Shot));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponNailGun::LaunchNailProjectile(const FHitResult& HitResult, FQLScheduledShot Shot)
+{
+    if (!WeaponManager.IsValid())
+    {
+        return;
+    }
+
     AQLCharacter* User = GetWeaponManager()->GetUser();
 
     if (User == nullptr)
@@ -114,8 +130,6 @@ void AQLWeaponNailGun::SpawnNailProjectile()
         return;
     }
 
-    FHitResult HitResult = User->RayTraceFromCharacterPOV(HitRange);
-
     // determine source and target
     UCameraComponent* CameraComponent = User->GetFirstPersonCameraComponent();
     if (CameraComponent == nullptr)
@@ -123,7 +137,8 @@ void AQLWeaponNailGun::SpawnNailProjectile()
         return;
     }
 
-    FVector SourceLocation = GetMuzzleLocation() + CameraComponent->GetForwardVector() * 10.0f;
+    // the nail leaves the muzzle where it was at the time of the shot
+    FVector SourceLocation = Shot.MuzzleLocation + CameraComponent->GetForwardVector() * 10.0f;
     FVector TargetLocation;
 
     // if hit occurs
@@ -133,7 +148,7 @@ void AQLWeaponNailGun::SpawnNailProjectile()
     }
     else
     {
-        TargetLocation = GetMuzzleLocation() + CameraComponent->GetForwardVector() * HitRange;
+        TargetLocation = Shot.MuzzleLocation + CameraComponent->GetForwardVector() * HitRange;
     }
 
     FVector ProjectileForwardVector = TargetLocation - SourceLocation;
@@ -152,20 +167,63 @@ void AQLWeaponNailGun::SpawnNailProjectile()
             return;
         }
 
+        AController* Controller = User->GetController();
+        AQLPlayerController* QLPlayerController = Cast<AQLPlayerController>(Controller);
+
+        // hand the nail over to the simulation manager instead of spawning an actor
+        UQLNailSimulationManager* NailSimulationManager = nullptr;
+        if (bSimulateNailsWithoutActor)
+        {
+            NailSimulationManager = AQLGameModeBase::GetWorldService<UQLNailSimulationManager>(this);
+        }
+
+        if (NailSimulationManager)
+        {
+            NailSimulationManager->AddNail(NailProjectileClass,
+                SourceLocation,
+                ProjectileForwardVector * ProjectileSpeed,
+                QLPlayerController,
+                User,
+                DamageMultiplier,
+                Shot.TimeSinceShot);
+            return;
+        }
+
         FTransform MyTransform(SourceRotation, SourceLocation, FVector(1.0f));
-        AQLNailProjectile* Nail = World->SpawnActorDeferred<AQLNailProjectile>(NailProjectileClass, MyTransform);
+        AQLNailProjectile* Nail = UQLActorPoolManager::AcquireActorDeferred<AQLNailProjectile>(this, NailProjectileClass, MyTransform);
+        if (!Nail)
+        {
+            return;
+        }
 
         // pass controller to Nail as damage instigator
-        AController* Controller = User->GetController();
-        AQLPlayerController* QLPlayerController = Cast<AQLPlayerController>(Controller);
         Nail->QLSetPlayerController(QLPlayerController);
         Nail->SetDamageMultiplier(DamageMultiplier);
-        UGameplayStatics::FinishSpawningActor(Nail, MyTransform);
+        UQLActorPoolManager::FinishAcquiringActor(Nail, MyTransform);
 
         // change velocity
         Nail->GetProjectileMovementComponent()->MaxSpeed = ProjectileSpeed;
         Nail->GetProjectileMovementComponent()->InitialSpeed = ProjectileSpeed;
         FVector FinalVelocity = ProjectileForwardVector * ProjectileSpeed;
         Nail->GetProjectileMovementComponent()->Velocity = FinalVelocity;
+
+        // catch up with the time elapsed since the shot was due
+        // sweep so that a nail fired point-blank still hits
+        if (Shot.TimeSinceShot > 0.0f)
+        {
+            Nail->GetProjectileMovementComponent()->MoveUpdatedComponent(FinalVelocity * Shot.TimeSinceShot, SourceRotation.Quaternion(), true);
+        }
+    }
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponNailGun::GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const
+{
+    Super::GetWarmUpAssetList(OutAssetList);
+
+    if (NailProjectileClass)
+    {
+        GetDefault<AQLProjectile>(NailProjectileClass)->GetWarmUpAssetList(OutAssetList);
     }
-}
\ No newline at end of file
+}
@@ -33,12 +33,28 @@ public:
 
     virtual void OnFireHold() override;
 
-    virtual void SpawnNailProjectile();
+    virtual void OnScheduledShot(const FQLScheduledShot& Shot) override;
+
+    virtual void SpawnNailProjectile(const FQLScheduledShot& Shot);
 
     virtual void StopFire() override;
+
+    virtual void GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const override;
 protected:
     virtual void PostInitializeComponents() override;
 
     UPROPERTY(EditDefaultsOnly, Category = "C++Property")
     TSubclassOf<AQLNailProjectile> NailProjectileClass;
+
+    //------------------------------------------------------------
+    // If true, nails are simulated by UQLNailSimulationManager and
+    // drawn as instances, otherwise each nail is an actor
+    //------------------------------------------------------------
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "C++Property")
+    bool bSimulateNailsWithoutActor;
+
+    //------------------------------------------------------------
+    // Trace callback of SpawnNailProjectile(): spawn the nail towards the hit point
+    //------------------------------------------------------------
+    void LaunchNailProjectile(const FHitResult& HitResult, FQLScheduledShot Shot);
 };
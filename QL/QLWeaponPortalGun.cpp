@@ -77,8 +77,13 @@ void AQLWeaponPortalGun::CreatePortalIfConditionsAreMet(EPortalColor PortalColor
         return;
     }
 
-    FHitResult HitResult = User->RayTraceFromCharacterPOV(HitRange);
+    RequestHitscanTrace(HitRange, FQLTraceDelegate::CreateUObject(this, &AQLWeaponPortalGun::OnPortalTraceCompleted, PortalColor));
+}
 
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponPortalGun::OnPortalTraceCompleted(const FHitResult& HitResult, EPortalColor PortalColor)
+{
     // if hit does not occur
     if (!HitResult.bBlockingHit)
     {
@@ -45,6 +45,11 @@ protected:
 
     void CreatePortalIfConditionsAreMet(EPortalColor PortalColor);
 
+    //------------------------------------------------------------
+    // Trace callback of CreatePortalIfConditionsAreMet()
+    //------------------------------------------------------------
+    void OnPortalTraceCompleted(const FHitResult& HitResult, EPortalColor PortalColor);
+
     UPROPERTY()
     TWeakObjectPtr<AQLColoredPortal> BluePortal;
 
@@ -20,6 +20,7 @@
 #include "QLWeaponManager.h"
 #include "QLUmgFirstPerson.h"
 #include "QLPlayerController.h"
+#include "QLActorPoolManager.h"
 #include "GameFramework/CharacterMovementComponent.h"
 
 //------------------------------------------------------------
@@ -36,7 +37,6 @@ AQLWeaponRailGun::AQLWeaponRailGun()
     bZoomedIn = false;
     FOVCached = 90.0f;
     CameraComponentCached = nullptr;
-    bFireEnabled = true;
 
     RailBeamClass = AQLRailBeam::StaticClass();
 
@@ -67,46 +67,54 @@ void AQLWeaponRailGun::PostInitializeComponents()
 void AQLWeaponRailGun::OnFire()
 {
     // if we are still in the fire disabled window, the weapon cannot be used
-    if (!bFireEnabled)
+    if (!IsFireReady())
     {
         return;
     }
 
     // enforce rate of fire
-    bFireEnabled = false;
-    GetWorldTimerManager().SetTimer(DisableFireTimerHandle,
-                                    this,
-                                    &AQLWeaponRailGun::EnableFireCallBack,
-                                    1.0f, // time interval in second. since loop is not used,
-                                          // this parameter can be an arbitrary value except 0.0f.
-                                    false, // loop
-                                    RateOfFire); // delay in second
+    // the cooldown is counted down by the weapon manager
+    StartFireCooldown();
 
     PlayAnimationMontage(FName(TEXT("Fire")));
 
-    PlaySoundFireAndForget(FName(TEXT("Fire")));
+    PlaySoundFireAndForget(FName(TEXT("Fire")), EQLSoundCategory::WeaponFire);
 
     // create the transient beam actor
-    UParticleSystemComponent* BeamComponentTemp = nullptr;
-    AQLRailBeam* RailBeamTemp = nullptr;
+    // the beam target is set once the batched trace returns
+    PendingRailBeam.Reset();
 
     if (RailBeamClass)
     {
-        // AQLRailBeam object is automatically destroyed after the particle effect ends
-        // because AQLRailBeam lifespan is specified in its BeginPlay()
-        RailBeamTemp = GetWorld()->SpawnActor<AQLRailBeam>(RailBeamClass, GetMuzzleLocation(), FRotator::ZeroRotator);
+        // AQLRailBeam object is automatically released to the pool (or destroyed) after the particle effect ends
+        // because AQLRailBeam lifespan is specified in its BeginPlay() and OnAcquiredFromPool()
+        FTransform BeamTransform(FRotator::ZeroRotator, GetMuzzleLocation());
+        AQLRailBeam* RailBeamTemp = UQLActorPoolManager::AcquireActorDeferred<AQLRailBeam>(this, RailBeamClass, BeamTransform);
         if (RailBeamTemp)
         {
+            UQLActorPoolManager::FinishAcquiringActor(RailBeamTemp, BeamTransform);
             RailBeamTemp->SetActorEnableCollision(false);
-            BeamComponentTemp = RailBeamTemp->GetBeamComponent();
+            UParticleSystemComponent* BeamComponentTemp = RailBeamTemp->GetBeamComponent();
             if (BeamComponentTemp)
             {
                 BeamComponentTemp->SetBeamSourcePoint(0, GetMuzzleLocation(), 0);
             }
+            PendingRailBeam = RailBeamTemp;
         }
     }
 
-    // ray tracing
+    RequestHitscanTrace(HitRange, FQLTraceDelegate::CreateUObject(this, &AQLWeaponRailGun::OnRailHit));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponRailGun::OnRailHit(const FHitResult& HitResult)
+{
+    if (!WeaponManager.IsValid())
+    {
+        return;
+    }
+
     AQLCharacter* User = GetWeaponManager()->GetUser();
 
     if (User == nullptr)
@@ -114,7 +122,12 @@ void AQLWeaponRailGun::OnFire()
         return;
     }
 
-    FHitResult HitResult = User->RayTraceFromCharacterPOV(HitRange);
+    UParticleSystemComponent* BeamComponentTemp = nullptr;
+    if (PendingRailBeam.IsValid())
+    {
+        BeamComponentTemp = PendingRailBeam->GetBeamComponent();
+    }
+    PendingRailBeam.Reset();
 
     // if hit does not occur
     if (!HitResult.bBlockingHit)
@@ -128,7 +141,7 @@ void AQLWeaponRailGun::OnFire()
 
         return;
     }
-    else
+    else if (BeamComponentTemp)
     {
         BeamComponentTemp->SetBeamTargetPoint(0, HitResult.ImpactPoint, 0);
     }
@@ -166,8 +179,8 @@ void AQLWeaponRailGun::OnFire()
     AQLPlayerController* QLPlayerController = User->GetQLPlayerController();
     if (DamageAmount > 0.0f && QLPlayerController)
     {
-        PlaySoundFireAndForget("Hit");
-        QLPlayerController->ShowDamageOnScreen(DamageAmount, HitResult.ImpactPoint);
+        PlaySoundFireAndForget("Hit", EQLSoundCategory::HitConfirm);
+        QLPlayerController->ShowDamageOnScreen(DamageAmount, HitResult.ImpactPoint, HitResult.GetActor());
     }
 }
 
@@ -291,3 +304,15 @@ void AQLWeaponRailGun::SetDamageMultiplier(const float Value)
     }
 
 }
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponRailGun::GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const
+{
+    Super::GetWarmUpAssetList(OutAssetList);
+
+    if (RailBeamClass)
+    {
+        GetDefault<AQLRailBeam>(RailBeamClass)->GetWarmUpAssetList(OutAssetList);
+    }
+}
@@ -47,6 +47,8 @@ public:
     virtual void StopFire() override;
 
     virtual void SetDamageMultiplier(const float Value) override;
+
+    virtual void GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const override;
 protected:
     virtual void Tick(float DeltaTime) override;
 
@@ -83,4 +85,12 @@ protected:
 
     UPROPERTY()
     float ZoomDamageAdjusted;
+
+    //------------------------------------------------------------
+    // Trace callback of OnFire(): aim the beam and damage the hit character
+    //------------------------------------------------------------
+    void OnRailHit(const FHitResult& HitResult);
+
+    // beam spawned by OnFire() and waiting for its trace result
+    TWeakObjectPtr<AQLRailBeam> PendingRailBeam;
 };
@@ -19,6 +19,7 @@
 #include "QLRocketProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "QLPlayerController.h"
+#include "QLActorPoolManager.h"
 #include "Kismet/GameplayStatics.h"
 
 //------------------------------------------------------------
@@ -53,26 +54,32 @@ void AQLWeaponRocketLauncher::Tick(float DeltaTime)
 void AQLWeaponRocketLauncher::OnFire()
 {
     // if we are still in the fire disabled window, the weapon cannot be used
-    if (!bFireEnabled)
+    if (!IsFireReady())
     {
         return;
     }
 
     // enforce rate of fire
-    bFireEnabled = false;
-    GetWorldTimerManager().SetTimer(DisableFireTimerHandle,
-                                    this,
-                                    &AQLWeaponRocketLauncher::EnableFireCallBack,
-                                    1.0f, // time interval in second. since loop is not used,
-                                          // this parameter can be an arbitrary value except 0.0f.
-                                    false, // loop
-                                    RateOfFire); // delay in second
+    // the cooldown is counted down by the weapon manager
+    StartFireCooldown();
 
     PlayAnimationMontage(FName(TEXT("Fire")));
 
-    PlaySoundFireAndForget(FName(TEXT("Fire")));
+    PlaySoundFireAndForget(FName(TEXT("Fire")), EQLSoundCategory::WeaponFire);
 
     // ray tracing
+    RequestHitscanTrace(HitRange, FQLTraceDelegate::CreateUObject(this, &AQLWeaponRocketLauncher::LaunchRocket));
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponRocketLauncher::LaunchRocket(const FHitResult& HitResult)
+{
+    if (!WeaponManager.IsValid())
+    {
+        return;
+    }
+
     AQLCharacter* User = GetWeaponManager()->GetUser();
 
     if (User == nullptr)
@@ -80,8 +87,6 @@ void AQLWeaponRocketLauncher::OnFire()
         return;
     }
 
-    FHitResult HitResult = User->RayTraceFromCharacterPOV(HitRange);
-
     // determine source and target
     UCameraComponent* CameraComponent = User->GetFirstPersonCameraComponent();
     if (CameraComponent == nullptr)
@@ -119,14 +124,18 @@ void AQLWeaponRocketLauncher::OnFire()
         }
 
         FTransform MyTransform(SourceRotation, SourceLocation, FVector(1.0f));
-        AQLRocketProjectile* Rocket = World->SpawnActorDeferred<AQLRocketProjectile>(RocketProjectileClass, MyTransform);
+        AQLRocketProjectile* Rocket = UQLActorPoolManager::AcquireActorDeferred<AQLRocketProjectile>(this, RocketProjectileClass, MyTransform);
+        if (!Rocket)
+        {
+            return;
+        }
 
         // pass controller to rocket as damage instigator
         AController* Controller = User->GetController();
         AQLPlayerController* QLPlayerController = Cast<AQLPlayerController>(Controller);
         Rocket->QLSetPlayerController(QLPlayerController);
         Rocket->SetDamageMultiplier(DamageMultiplier);
-        UGameplayStatics::FinishSpawningActor(Rocket, MyTransform);
+        UQLActorPoolManager::FinishAcquiringActor(Rocket, MyTransform);
 
         // change velocity
         Rocket->GetProjectileMovementComponent()->MaxSpeed = ProjectileSpeed;
@@ -134,4 +143,16 @@ void AQLWeaponRocketLauncher::OnFire()
         FVector FinalVelocity = ProjectileForwardVector * ProjectileSpeed;
         Rocket->GetProjectileMovementComponent()->Velocity = FinalVelocity;
     }
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void AQLWeaponRocketLauncher::GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const
+{
+    Super::GetWarmUpAssetList(OutAssetList);
+
+    if (RocketProjectileClass)
+    {
+        GetDefault<AQLProjectile>(RocketProjectileClass)->GetWarmUpAssetList(OutAssetList);
+    }
+}
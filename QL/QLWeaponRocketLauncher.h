@@ -26,6 +26,8 @@ public:
     AQLWeaponRocketLauncher();
 
     virtual void OnFire() override;
+
+    virtual void GetWarmUpAssetList(TArray<UObject*>& OutAssetList) const override;
 protected:
     virtual void Tick(float DeltaTime) override;
 
@@ -33,4 +35,9 @@ protected:
 
     UPROPERTY(EditDefaultsOnly, Category = "C++Property")
     TSubclassOf<AQLRocketProjectile> RocketProjectileClass;
+
+    //------------------------------------------------------------
+    // Trace callback of OnFire(): spawn the rocket towards the hit point
+    //------------------------------------------------------------
+    void LaunchRocket(const FHitResult& HitResult);
 };
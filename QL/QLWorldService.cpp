@@ -0,0 +1,56 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+
+#include "QLWorldService.h"
+#include "Engine/World.h"
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UQLWorldService::UQLWorldService()
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLWorldService::Initialize()
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLWorldService::Deinitialize()
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+void UQLWorldService::Tick(float DeltaTime)
+{
+}
+
+//------------------------------------------------------------
+//------------------------------------------------------------
+UWorld* UQLWorldService::GetWorld() const
+{
+    // the class default object has no world
+    if (HasAnyFlags(RF_ClassDefaultObject))
+    {
+        return nullptr;
+    }
+
+    UObject* MyOuter = GetOuter();
+    if (!MyOuter)
+    {
+        return nullptr;
+    }
+
+    return MyOuter->GetWorld();
+}
@@ -0,0 +1,47 @@
+//------------------------------------------------------------
+// Quarter Life
+//
+// GNU General Public License v3.0
+//
+//  (\-/)
+// (='.'=)
+// (")-(")o
+//------------------------------------------------------------
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "QLWorldService.generated.h"
+
+//------------------------------------------------------------
+// Base class of the per-world services (trace batching, pools, etc.)
+// The engine version QL is built on (4.22) has no UWorldSubsystem,
+// so the services are owned and ticked by AQLGameModeBase.
+// Use AQLGameModeBase::GetWorldService<T>() to access a service.
+//------------------------------------------------------------
+UCLASS(Abstract)
+class QL_API UQLWorldService : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UQLWorldService();
+
+    //------------------------------------------------------------
+    // Called once right after the service is created
+    //------------------------------------------------------------
+    virtual void Initialize();
+
+    //------------------------------------------------------------
+    // Called once when the owning game mode ends play
+    //------------------------------------------------------------
+    virtual void Deinitialize();
+
+    //------------------------------------------------------------
+    // Called every frame by the owning game mode
+    //------------------------------------------------------------
+    virtual void Tick(float DeltaTime);
+
+    virtual UWorld* GetWorld() const override;
+};